@@ -0,0 +1,120 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <QVector>
+#include <QtTest/QtTest>
+
+#include <KDChartAggregationKernels_p.h>
+
+#include <BenchmarkModel.h>
+
+#include <limits>
+
+using namespace KDChart;
+
+class BenchmarkAggregationKernels : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void cleanup()
+    {
+        AggregationKernels::setInstructionSet(AggregationKernels::AVX2);
+    }
+
+    void sum_data()
+    {
+        addKernelRows();
+    }
+
+    // averaging the rows of data points
+    void sum()
+    {
+        QFETCH(int, instructionSet);
+        QFETCH(int, points);
+        AggregationKernels::setInstructionSet(AggregationKernels::InstructionSet(instructionSet));
+        const QVector<qreal> values = column(points, 0);
+        qreal total = 0;
+        QBENCHMARK {
+            total += AggregationKernels::sum(values.constData(), values.size()).sum;
+        }
+        QVERIFY(!qIsNaN(total));
+    }
+
+    void maximumIndex_data()
+    {
+        addKernelRows();
+    }
+
+    // the maximum aggregation, e.g. the highs of stock data
+    void maximumIndex()
+    {
+        QFETCH(int, instructionSet);
+        QFETCH(int, points);
+        AggregationKernels::setInstructionSet(AggregationKernels::InstructionSet(instructionSet));
+        const QVector<qreal> values = column(points, 0);
+        int index = 0;
+        QBENCHMARK {
+            index = AggregationKernels::maximumIndex(values.constData(), values.size());
+        }
+        QVERIFY(index >= 0);
+    }
+
+    void boundaries_data()
+    {
+        addKernelRows();
+    }
+
+    // the data boundaries of a dataset
+    void boundaries()
+    {
+        QFETCH(int, instructionSet);
+        QFETCH(int, points);
+        AggregationKernels::setInstructionSet(AggregationKernels::InstructionSet(instructionSet));
+        const QVector<qreal> keys = column(points, 0);
+        const QVector<qreal> values = column(points, 1);
+        AggregationKernels::Boundaries boundaries;
+        QBENCHMARK {
+            boundaries = AggregationKernels::boundaries(keys.constData(), values.constData(), points);
+        }
+        QVERIFY(!qIsNaN(boundaries.minimumKey));
+    }
+
+private:
+    // each supported instruction set, for the size of one data point and of a whole column
+    static void addKernelRows()
+    {
+        QTest::addColumn<int>("instructionSet");
+        QTest::addColumn<int>("points");
+        const char *const names[] = { "scalar", "sse2", "avx2" };
+        for (int set = AggregationKernels::Scalar; set <= AggregationKernels::supportedInstructionSet(); ++set) {
+            for (int points = 100; points <= 1000000; points *= 100) {
+                const QString size = points < 1000 ? QString::number(points) : pointCountTag(points);
+                QTest::newRow(qPrintable(QString::fromLatin1("%1-%2").arg(QLatin1String(names[set]), size))) << set << points;
+            }
+        }
+    }
+
+    // the values of a BenchmarkModel column, with a gap every 64 rows
+    static QVector<qreal> column(int rows, int column)
+    {
+        BenchmarkModel model(rows, column + 1);
+        QVector<qreal> values(rows);
+        for (int row = 0; row < rows; ++row) {
+            values[row] = row % 64 == 63 ? std::numeric_limits<qreal>::quiet_NaN()
+                                         : model.data(model.index(row, column), Qt::DisplayRole).toReal();
+        }
+        return values;
+    }
+};
+
+QTEST_MAIN(BenchmarkAggregationKernels)
+
+#include "main.moc"
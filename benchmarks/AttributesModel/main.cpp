@@ -0,0 +1,99 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <KDChartAttributesModel>
+#include <KDChartDataValueAttributes>
+#include <KDChartLineDiagram>
+
+#include <BenchmarkModel.h>
+
+using namespace KDChart;
+
+class BenchmarkAttributesModel : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void lookups_data()
+    {
+        QTest::addColumn<int>("points");
+        QTest::addColumn<bool>("cellAttributes");
+        for (int points = 1000; points <= 1000000; points *= 10) {
+            const QString size = pointCountTag(points);
+            QTest::newRow(qPrintable(QLatin1String("defaults-") + size)) << points << false;
+            QTest::newRow(qPrintable(QLatin1String("cells-") + size)) << points << true;
+        }
+    }
+
+    // The attribute lookups that painting does for every data point, with and without
+    // attributes set on individual cells
+    void lookups()
+    {
+        QFETCH(int, points);
+        QFETCH(bool, cellAttributes);
+
+        BenchmarkModel model(points, 4);
+        LineDiagram diagram;
+        diagram.setModel(&model);
+        if (cellAttributes) {
+            DataValueAttributes dva = diagram.dataValueAttributes();
+            dva.setVisible(true);
+            for (int row = 0; row < points; row += 10) {
+                const QModelIndex index = diagram.model()->index(row, row % 4, diagram.rootIndex());
+                diagram.setDataValueAttributes(index, dva);
+                diagram.setPen(index, QPen(Qt::red));
+            }
+        }
+
+        QAbstractItemModel *const m = diagram.model();
+        QBENCHMARK {
+            for (int row = 0; row < points; ++row) {
+                for (int column = 0; column < 4; ++column) {
+                    const QModelIndex index = m->index(row, column, diagram.rootIndex());
+                    diagram.dataValueAttributes(index);
+                    diagram.pen(index);
+                    diagram.brush(index);
+                }
+            }
+        }
+    }
+
+    void headerData_data()
+    {
+        QTest::addColumn<int>("datasets");
+        for (int datasets = 10; datasets <= 10000; datasets *= 10) {
+            QTest::newRow(qPrintable(QString::number(datasets))) << datasets;
+        }
+    }
+
+    // The per dataset lookups, as done by legends and axes
+    void headerData()
+    {
+        QFETCH(int, datasets);
+
+        BenchmarkModel model(10, datasets);
+        LineDiagram diagram;
+        diagram.setModel(&model);
+        AttributesModel *const attributesModel = diagram.attributesModel();
+        QBENCHMARK {
+            for (int dataset = 0; dataset < datasets; ++dataset) {
+                attributesModel->headerData(dataset, Qt::Horizontal, Qt::DisplayRole);
+                attributesModel->headerData(dataset, Qt::Horizontal, DatasetPenRole);
+                attributesModel->headerData(dataset, Qt::Horizontal, DatasetBrushRole);
+            }
+        }
+    }
+};
+
+QTEST_MAIN(BenchmarkAttributesModel)
+
+#include "main.moc"
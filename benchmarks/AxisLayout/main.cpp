@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <QImage>
+#include <QPainter>
+#include <QtTest/QtTest>
+
+#include <KDChartCartesianAxis>
+#include <KDChartCartesianCoordinatePlane>
+#include <KDChartChart>
+#include <KDChartLineDiagram>
+
+#include <BenchmarkModel.h>
+
+using namespace KDChart;
+
+class BenchmarkAxisLayout : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void init()
+    {
+        m_model = nullptr;
+        m_chart = new Chart;
+        m_axis = nullptr;
+    }
+
+    void cleanup()
+    {
+        delete m_chart;
+        delete m_model;
+    }
+
+    void sizeHint_data()
+    {
+        QTest::addColumn<int>("points");
+        QTest::addColumn<bool>("vertical");
+        for (int points = 1000; points <= 1000000; points *= 10) {
+            const QString size = pointCountTag(points);
+            QTest::newRow(qPrintable(QLatin1String("bottom-") + size)) << points << false;
+            QTest::newRow(qPrintable(QLatin1String("left-") + size)) << points << true;
+        }
+    }
+
+    // Measuring the tick labels from scratch, like after the data or the plane changed
+    void sizeHint()
+    {
+        QFETCH(int, points);
+        QFETCH(bool, vertical);
+
+        setUpChart(points, vertical);
+        QBENCHMARK {
+            m_axis->layoutPlanes();
+            m_axis->setCachedSizeDirty();
+            m_axis->sizeHint();
+        }
+    }
+
+    void paint_data()
+    {
+        sizeHint_data();
+    }
+
+    // Painting an axis that has been laid out already
+    void paint()
+    {
+        QFETCH(int, points);
+        QFETCH(bool, vertical);
+
+        setUpChart(points, vertical);
+        QImage image(800, 600, QImage::Format_ARGB32_Premultiplied);
+        QPainter painter(&image);
+        QBENCHMARK {
+            m_axis->paint(&painter);
+        }
+    }
+
+private:
+    void setUpChart(int points, bool vertical)
+    {
+        m_model = new BenchmarkModel(points, 2);
+        auto *diagram = new LineDiagram;
+        diagram->setModel(m_model);
+        m_axis = new CartesianAxis(diagram);
+        m_axis->setPosition(vertical ? CartesianAxis::Left : CartesianAxis::Bottom);
+        diagram->addAxis(m_axis);
+        m_chart->coordinatePlane()->replaceDiagram(diagram);
+
+        // lay out the chart once, so that the axis has its geometry
+        m_chart->resize(800, 600);
+        QImage image(800, 600, QImage::Format_ARGB32_Premultiplied);
+        QPainter painter(&image);
+        m_chart->paint(&painter, image.rect());
+    }
+
+    BenchmarkModel *m_model;
+    Chart *m_chart;
+    CartesianAxis *m_axis;
+};
+
+QTEST_MAIN(BenchmarkAxisLayout)
+
+#include "main.moc"
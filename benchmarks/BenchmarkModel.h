@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef BENCHMARKMODEL_H
+#define BENCHMARKMODEL_H
+
+#include <QAbstractTableModel>
+#include <QString>
+
+#include <cmath>
+
+/**
+ * A read-only table model that computes its values on the fly, so that models with
+ * millions of rows take no memory and are equally fast to query for all benchmarks.
+ *
+ * The values are a smooth curve with some deterministic noise. With the
+ * HighLowClose and OpenHighLowClose shapes, every three or four columns form the
+ * values of one stock dataset.
+ */
+class BenchmarkModel : public QAbstractTableModel
+{
+public:
+    enum Shape
+    {
+        Series,
+        HighLowClose,
+        OpenHighLowClose
+    };
+
+    BenchmarkModel(int rows, int columns, Shape shape = Series, QObject *parent = nullptr)
+        : QAbstractTableModel(parent)
+        , m_rows(rows)
+        , m_columns(columns)
+        , m_shape(shape)
+    {
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_rows;
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_columns;
+    }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole)) {
+            return QVariant();
+        }
+        if (m_shape == HighLowClose) {
+            static const qreal offsets[] = {5.0, -5.0, 1.0};
+            return value(index.row(), index.column() / 3) + offsets[index.column() % 3];
+        } else if (m_shape == OpenHighLowClose) {
+            static const qreal offsets[] = {0.0, 5.0, -5.0, 1.0};
+            return value(index.row(), index.column() / 4) + offsets[index.column() % 4];
+        }
+        return value(index.row(), index.column());
+    }
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override
+    {
+        if (orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+            return QString::fromLatin1("Dataset %1").arg(section);
+        }
+        return QVariant();
+    }
+
+    static qreal value(int row, int column)
+    {
+        const quint32 noise = (quint32(row) * 2654435761u) ^ (quint32(column) * 40503u);
+        return 100.0 + 50.0 * std::sin(row * 0.001 + column) + (noise % 1000) * 0.01;
+    }
+
+private:
+    const int m_rows;
+    const int m_columns;
+    const Shape m_shape;
+};
+
+// A short tag for a data size, like 10k or 1M
+inline QString pointCountTag(int points)
+{
+    return points >= 1000000 ? QString::fromLatin1("%1M").arg(points / 1000000)
+                             : QString::fromLatin1("%1k").arg(points / 1000);
+}
+
+#endif
@@ -0,0 +1,256 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <QImage>
+#include <QPainter>
+#include <QtTest/QtTest>
+
+#include <KDChartBarDiagram>
+#include <KDChartCartesianAxis>
+#include <KDChartCartesianCoordinatePlane>
+#include <KDChartChart>
+#include <KDChartLineAttributes>
+#include <KDChartLineDiagram>
+#include <KDChartPieDiagram>
+#include <KDChartPlotter>
+#include <KDChartPolarCoordinatePlane>
+#include <KDChartPolarDiagram>
+#include <KDChartRadarCoordinatePlane>
+#include <KDChartRadarDiagram>
+#include <KDChartRingDiagram>
+#include <KDChartStockDiagram>
+#include <KDChartTernaryCoordinatePlane>
+#include <KDChartTernaryLineDiagram>
+#include <KDChartTernaryPointDiagram>
+
+#include <BenchmarkModel.h>
+
+using namespace KDChart;
+
+namespace {
+enum DiagramKind
+{
+    LineNormal,
+    LineStacked,
+    LinePercent,
+    LineNormalArea,
+    LineStackedArea,
+    LinePercentArea,
+    BarNormal,
+    BarStacked,
+    BarPercent,
+    PlotterNormal,
+    PlotterPercent,
+    PlotterNormalArea,
+    StockHighLowClose,
+    StockOpenHighLowClose,
+    StockCandlestick,
+    Pie,
+    Ring,
+    Polar,
+    Radar,
+    TernaryPoint,
+    TernaryLine
+};
+
+struct DiagramInfo
+{
+    DiagramKind kind;
+    const char *name;
+    int maxPoints;
+};
+
+// The largest data sizes are left out for diagrams that paint every data point
+const DiagramInfo s_diagrams[] = {
+    {LineNormal, "line-normal", 10000000},
+    {LineStacked, "line-stacked", 10000000},
+    {LinePercent, "line-percent", 10000000},
+    {LineNormalArea, "line-normal-area", 100000},
+    {LineStackedArea, "line-stacked-area", 100000},
+    {LinePercentArea, "line-percent-area", 100000},
+    {BarNormal, "bar-normal", 10000000},
+    {BarStacked, "bar-stacked", 10000000},
+    {BarPercent, "bar-percent", 10000000},
+    {PlotterNormal, "plotter-normal", 10000000},
+    {PlotterPercent, "plotter-percent", 10000000},
+    {PlotterNormalArea, "plotter-normal-area", 100000},
+    {StockHighLowClose, "stock-hlc", 1000000},
+    {StockOpenHighLowClose, "stock-ohlc", 1000000},
+    {StockCandlestick, "stock-candlestick", 1000000},
+    {Pie, "pie", 10000},
+    {Ring, "ring", 10000},
+    {Polar, "polar", 100000},
+    {Radar, "radar", 100000},
+    {TernaryPoint, "ternary-point", 100000},
+    {TernaryLine, "ternary-line", 100000},
+};
+}
+
+class BenchmarkChartPaint : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void paint_data()
+    {
+        QTest::addColumn<int>("kind");
+        QTest::addColumn<int>("points");
+        for (const DiagramInfo &info : s_diagrams) {
+            for (int points = 1000; points <= info.maxPoints; points *= 10) {
+                const QString tag = QString::fromLatin1(info.name) + QLatin1Char('-') + pointCountTag(points);
+                QTest::newRow(qPrintable(tag)) << int(info.kind) << points;
+            }
+        }
+    }
+
+    void paint()
+    {
+        QFETCH(int, kind);
+        QFETCH(int, points);
+
+        // the chart goes away before the model
+        QScopedPointer<BenchmarkModel> model;
+        Chart chart;
+        model.reset(setUpChart(&chart, DiagramKind(kind), points));
+
+        QImage image(800, 600, QImage::Format_ARGB32_Premultiplied);
+        QPainter painter(&image);
+        QBENCHMARK {
+            chart.paint(&painter, image.rect());
+        }
+    }
+
+private:
+    // Replaces the chart's diagram with one of the given kind, showing a model with the given
+    // number of data points per dataset, and returns the model.
+    static BenchmarkModel *setUpChart(Chart *chart, DiagramKind kind, int points)
+    {
+        switch (kind) {
+        case LineNormal:
+        case LineStacked:
+        case LinePercent:
+        case LineNormalArea:
+        case LineStackedArea:
+        case LinePercentArea: {
+            auto *model = new BenchmarkModel(points, 4);
+            auto *diagram = new LineDiagram;
+            diagram->setType(kind == LineNormal || kind == LineNormalArea ? LineDiagram::Normal
+                                 : kind == LineStacked || kind == LineStackedArea ? LineDiagram::Stacked
+                                                                                  : LineDiagram::Percent);
+            if (kind == LineNormalArea || kind == LineStackedArea || kind == LinePercentArea) {
+                LineAttributes la = diagram->lineAttributes();
+                la.setDisplayArea(true);
+                diagram->setLineAttributes(la);
+            }
+            setUpCartesianDiagram(chart, diagram, model);
+            return model;
+        }
+        case BarNormal:
+        case BarStacked:
+        case BarPercent: {
+            auto *model = new BenchmarkModel(points, 4);
+            auto *diagram = new BarDiagram;
+            diagram->setType(kind == BarNormal ? BarDiagram::Normal
+                                               : kind == BarStacked ? BarDiagram::Stacked
+                                                                    : BarDiagram::Percent);
+            setUpCartesianDiagram(chart, diagram, model);
+            return model;
+        }
+        case PlotterNormal:
+        case PlotterPercent:
+        case PlotterNormalArea: {
+            // two datasets of x and y values
+            auto *model = new BenchmarkModel(points, 4);
+            auto *diagram = new Plotter;
+            diagram->setType(kind == PlotterPercent ? Plotter::Percent : Plotter::Normal);
+            if (kind == PlotterNormalArea) {
+                LineAttributes la = diagram->lineAttributes();
+                la.setDisplayArea(true);
+                diagram->setLineAttributes(la);
+            }
+            setUpCartesianDiagram(chart, diagram, model);
+            return model;
+        }
+        case StockHighLowClose:
+        case StockOpenHighLowClose:
+        case StockCandlestick: {
+            const bool hasOpen = kind != StockHighLowClose;
+            auto *model = new BenchmarkModel(points, hasOpen ? 4 : 3,
+                                             hasOpen ? BenchmarkModel::OpenHighLowClose : BenchmarkModel::HighLowClose);
+            auto *diagram = new StockDiagram;
+            diagram->setType(kind == StockHighLowClose ? StockDiagram::HighLowClose
+                                                       : kind == StockOpenHighLowClose ? StockDiagram::OpenHighLowClose
+                                                                                       : StockDiagram::Candlestick);
+            setUpCartesianDiagram(chart, diagram, model);
+            return model;
+        }
+        case Pie:
+        case Ring: {
+            // one slice per column
+            auto *model = new BenchmarkModel(1, points);
+            auto *plane = new PolarCoordinatePlane(chart);
+            chart->replaceCoordinatePlane(plane);
+            AbstractPieDiagram *diagram = kind == Pie ? static_cast<AbstractPieDiagram *>(new PieDiagram)
+                                                      : new RingDiagram;
+            diagram->setModel(model);
+            plane->replaceDiagram(diagram);
+            return model;
+        }
+        case Polar: {
+            auto *model = new BenchmarkModel(points, 3);
+            auto *plane = new PolarCoordinatePlane(chart);
+            chart->replaceCoordinatePlane(plane);
+            auto *diagram = new PolarDiagram;
+            diagram->setModel(model);
+            plane->replaceDiagram(diagram);
+            return model;
+        }
+        case Radar: {
+            auto *model = new BenchmarkModel(points, 3);
+            auto *plane = new RadarCoordinatePlane(chart);
+            chart->replaceCoordinatePlane(plane);
+            auto *diagram = new RadarDiagram;
+            diagram->setModel(model);
+            plane->replaceDiagram(diagram);
+            return model;
+        }
+        case TernaryPoint:
+        case TernaryLine: {
+            auto *model = new BenchmarkModel(points, 3);
+            auto *plane = new TernaryCoordinatePlane(chart);
+            chart->replaceCoordinatePlane(plane);
+            AbstractTernaryDiagram *diagram = kind == TernaryPoint
+                ? static_cast<AbstractTernaryDiagram *>(new TernaryPointDiagram(nullptr, plane))
+                : new TernaryLineDiagram(nullptr, plane);
+            diagram->setModel(model);
+            plane->replaceDiagram(diagram);
+            return model;
+        }
+        }
+        Q_ASSERT(false);
+        return nullptr;
+    }
+
+    static void setUpCartesianDiagram(Chart *chart, AbstractCartesianDiagram *diagram, BenchmarkModel *model)
+    {
+        diagram->setModel(model);
+        auto *bottomAxis = new CartesianAxis(diagram);
+        bottomAxis->setPosition(CartesianAxis::Bottom);
+        diagram->addAxis(bottomAxis);
+        auto *leftAxis = new CartesianAxis(diagram);
+        leftAxis->setPosition(CartesianAxis::Left);
+        diagram->addAxis(leftAxis);
+        chart->coordinatePlane()->replaceDiagram(diagram);
+    }
+};
+
+QTEST_MAIN(BenchmarkChartPaint)
+
+#include "main.moc"
@@ -0,0 +1,87 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <KDChartCartesianDiagramDataCompressor_p.h>
+
+#include <BenchmarkModel.h>
+
+using namespace KDChart;
+
+typedef CartesianDiagramDataCompressor::CachePosition CachePosition;
+
+class BenchmarkDataCompressor : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void rebuild_data()
+    {
+        QTest::addColumn<int>("mode");
+        QTest::addColumn<int>("points");
+        for (int points = 1000; points <= 10000000; points *= 10) {
+            const QString size = pointCountTag(points);
+            QTest::newRow(qPrintable(QLatin1String("precise-") + size))
+                << int(CartesianDiagramDataCompressor::Precise) << points;
+            QTest::newRow(qPrintable(QLatin1String("samplingseven-") + size))
+                << int(CartesianDiagramDataCompressor::SamplingSeven) << points;
+        }
+    }
+
+    // Rebuilds the cache, like after a resize, and fetches all of it, like painting does
+    void rebuild()
+    {
+        QFETCH(int, mode);
+        QFETCH(int, points);
+
+        BenchmarkModel model(points, 4);
+        CartesianDiagramDataCompressor compressor;
+        compressor.setApproximationMode(CartesianDiagramDataCompressor::ApproximationMode(mode));
+        compressor.setModel(&model);
+
+        int width = 800;
+        QBENCHMARK {
+            // alternate between two widths to invalidate the cache in every iteration
+            width = width == 800 ? 801 : 800;
+            compressor.setResolution(width, 600);
+            for (int column = 0; column < compressor.modelDataColumns(); ++column) {
+                for (int row = 0; row < compressor.modelDataRows(); ++row) {
+                    compressor.data(CachePosition(row, column));
+                }
+            }
+        }
+    }
+
+    void dataBoundaries_data()
+    {
+        QTest::addColumn<int>("points");
+        for (int points = 1000; points <= 10000000; points *= 10) {
+            QTest::newRow(qPrintable(pointCountTag(points))) << points;
+        }
+    }
+
+    void dataBoundaries()
+    {
+        QFETCH(int, points);
+
+        BenchmarkModel model(points, 4);
+        CartesianDiagramDataCompressor compressor;
+        compressor.setModel(&model);
+        compressor.setResolution(800, 600);
+        QBENCHMARK {
+            compressor.dataBoundaries();
+        }
+    }
+};
+
+QTEST_MAIN(BenchmarkDataCompressor)
+
+#include "main.moc"
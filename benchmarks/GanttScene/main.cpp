@@ -0,0 +1,61 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <QDateTime>
+#include <QStandardItemModel>
+#include <QtTest/QtTest>
+
+#include <KDGanttDateTimeGrid>
+#include <KDGanttGlobal>
+#include <KDGanttGraphicsView>
+#include <KDGanttView>
+
+class BenchmarkGanttScene : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void updateScene_data()
+    {
+        QTest::addColumn<int>("tasks");
+        for (int tasks = 1000; tasks <= 100000; tasks *= 10) {
+            QTest::newRow(qPrintable(QString::fromLatin1("%1k").arg(tasks / 1000))) << tasks;
+        }
+    }
+
+    // Rebuilding all items of the scene, like after a reset of the model
+    void updateScene()
+    {
+        QFETCH(int, tasks);
+
+        QStandardItemModel model(tasks, 4);
+        const QDateTime start(QDate(2020, 1, 1), QTime(0, 0));
+        for (int row = 0; row < tasks; ++row) {
+            model.setData(model.index(row, 0), QString::fromLatin1("Task %1").arg(row));
+            model.setData(model.index(row, 1), KDGantt::TypeTask);
+            model.setData(model.index(row, 2), start.addSecs(row * 3600), KDGantt::StartTimeRole);
+            model.setData(model.index(row, 3), start.addSecs(row * 3600 + 86400), KDGantt::EndTimeRole);
+        }
+
+        KDGantt::View view;
+        KDGantt::DateTimeGrid grid;
+        view.setGrid(&grid);
+        view.setModel(&model);
+        view.resize(800, 600);
+
+        QBENCHMARK {
+            view.graphicsView()->updateScene();
+        }
+    }
+};
+
+QTEST_MAIN(BenchmarkGanttScene)
+
+#include "main.moc"
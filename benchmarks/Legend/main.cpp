@@ -0,0 +1,84 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <QImage>
+#include <QPainter>
+#include <QtTest/QtTest>
+
+#include <KDChartLegend>
+#include <KDChartLineDiagram>
+
+#include <BenchmarkModel.h>
+
+using namespace KDChart;
+
+class BenchmarkLegend : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void buildLegend_data()
+    {
+        QTest::addColumn<int>("datasets");
+        QTest::addColumn<bool>("virtualized");
+        for (int datasets = 10; datasets <= 10000; datasets *= 10) {
+            const QString count = QString::number(datasets);
+            QTest::newRow(qPrintable(QLatin1String("normal-") + count)) << datasets << false;
+            QTest::newRow(qPrintable(QLatin1String("virtualized-") + count)) << datasets << true;
+        }
+    }
+
+    // Legend::buildLegend() via forceRebuild(), and the size hint that results from it
+    void buildLegend()
+    {
+        QFETCH(int, datasets);
+        QFETCH(bool, virtualized);
+
+        BenchmarkModel model(10, datasets);
+        LineDiagram diagram;
+        diagram.setModel(&model);
+        Legend legend(&diagram);
+        legend.setVirtualized(virtualized);
+        QBENCHMARK {
+            legend.forceRebuild();
+            legend.sizeHint();
+        }
+    }
+
+    void paint_data()
+    {
+        buildLegend_data();
+    }
+
+    void paint()
+    {
+        QFETCH(int, datasets);
+        QFETCH(bool, virtualized);
+
+        BenchmarkModel model(10, datasets);
+        LineDiagram diagram;
+        diagram.setModel(&model);
+        Legend legend(&diagram);
+        legend.setVirtualized(virtualized);
+        legend.resize(legend.sizeHint());
+
+        // a legend with many datasets is usually shown in a scroll area, so only paint a part of it
+        QImage image(400, 600, QImage::Format_ARGB32_Premultiplied);
+        QPainter painter(&image);
+        painter.setClipRect(image.rect());
+        QBENCHMARK {
+            legend.paint(&painter);
+        }
+    }
+};
+
+QTEST_MAIN(BenchmarkLegend)
+
+#include "main.moc"
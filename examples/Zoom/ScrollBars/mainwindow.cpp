@@ -50,6 +50,8 @@ MainWindow::MainWindow(QWidget *parent)
     m_lines->addAxis(xAxis);
     m_lines->addAxis(yAxis);
     m_chart->coordinatePlane()->replaceDiagram(m_lines);
+    // while zooming and scrolling, move the lines as painted last and paint them again afterwards
+    static_cast<CartesianCoordinatePlane *>(m_chart->coordinatePlane())->setDeferredZoomRendering(true);
 
     connect(m_chart, &Chart::propertiesChanged, this, &MainWindow::applyNewZoomParameters);
 
@@ -0,0 +1,126 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartAggregationKernels_p.h>
+#include <QVector>
+#include <QtTest/QtTest>
+
+#include <limits>
+
+using namespace KDChart;
+
+class TestAggregationKernels : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void cleanup()
+    {
+        AggregationKernels::setInstructionSet(AggregationKernels::AVX2);
+    }
+
+    void testInstructionSets()
+    {
+        const AggregationKernels::InstructionSet supported = AggregationKernels::supportedInstructionSet();
+        QCOMPARE(AggregationKernels::instructionSet(), supported);
+        QCOMPARE(AggregationKernels::setInstructionSet(AggregationKernels::Scalar), AggregationKernels::Scalar);
+        QCOMPARE(AggregationKernels::instructionSet(), AggregationKernels::Scalar);
+        QCOMPARE(AggregationKernels::setInstructionSet(AggregationKernels::AVX2), supported);
+    }
+
+    void testKernels_data()
+    {
+        QTest::addColumn<int>("instructionSet");
+        const char *const names[] = { "scalar", "sse2", "avx2" };
+        for (int set = AggregationKernels::Scalar; set <= AggregationKernels::supportedInstructionSet(); ++set) {
+            QTest::newRow(names[set]) << set;
+        }
+    }
+
+    // the vectorized kernels give the same results as plain loops over the values, for all
+    // lengths and alignments of the arrays
+    void testKernels()
+    {
+        QFETCH(int, instructionSet);
+        AggregationKernels::setInstructionSet(AggregationKernels::InstructionSet(instructionSet));
+
+        const qreal NaN = std::numeric_limits<qreal>::quiet_NaN();
+        const qreal infinity = std::numeric_limits<qreal>::infinity();
+        QVector<qreal> keys(64);
+        QVector<qreal> values(64);
+        // whole numbers are added up exactly in any order
+        for (int i = 0; i < values.size(); ++i) {
+            keys[i] = (i * 13) % 17 - 8;
+            values[i] = (i * 7) % 11 == 3 ? NaN : (i * 29) % 23 - 11;
+        }
+        keys[40] = NaN;
+        values[50] = -infinity;
+
+        for (int offset = 0; offset < 4; ++offset) {
+            for (int count = 0; offset + count <= values.size(); ++count) {
+                const qreal *k = keys.constData() + offset;
+                const qreal *v = values.constData() + offset;
+
+                qreal sum = 0;
+                int valid = 0;
+                int first = -1;
+                int last = -1;
+                int maximum = -1;
+                int minimum = -1;
+                AggregationKernels::Boundaries boundaries = { NaN, NaN, NaN, NaN };
+                for (int i = 0; i < count; ++i) {
+                    if (!qIsNaN(k[i]) && !qIsNaN(v[i])) {
+                        if (qIsNaN(boundaries.minimumKey)) {
+                            boundaries = { k[i], k[i], v[i], v[i] };
+                        }
+                        boundaries.minimumKey = qMin(boundaries.minimumKey, k[i]);
+                        boundaries.maximumKey = qMax(boundaries.maximumKey, k[i]);
+                        boundaries.minimumValue = qMin(boundaries.minimumValue, v[i]);
+                        boundaries.maximumValue = qMax(boundaries.maximumValue, v[i]);
+                    }
+                    if (qIsNaN(v[i])) {
+                        continue;
+                    }
+                    sum += v[i];
+                    ++valid;
+                    first = first < 0 ? i : first;
+                    last = i;
+                    maximum = maximum < 0 || v[i] > v[maximum] ? i : maximum;
+                    minimum = minimum < 0 || v[i] < v[minimum] ? i : minimum;
+                }
+
+                const AggregationKernels::Sum result = AggregationKernels::sum(v, count);
+                QCOMPARE(result.count, valid);
+                if (valid > 0) {
+                    QCOMPARE(result.sum, sum);
+                }
+                QCOMPARE(AggregationKernels::firstIndex(v, count), first);
+                QCOMPARE(AggregationKernels::lastIndex(v, count), last);
+                QCOMPARE(AggregationKernels::maximumIndex(v, count), maximum);
+                QCOMPARE(AggregationKernels::minimumIndex(v, count), minimum);
+
+                const AggregationKernels::Boundaries found = AggregationKernels::boundaries(k, v, count);
+                if (qIsNaN(boundaries.minimumKey)) {
+                    QVERIFY(qIsNaN(found.minimumKey));
+                    QVERIFY(qIsNaN(found.maximumValue));
+                } else {
+                    QCOMPARE(found.minimumKey, boundaries.minimumKey);
+                    QCOMPARE(found.maximumKey, boundaries.maximumKey);
+                    QCOMPARE(found.minimumValue, boundaries.minimumValue);
+                    QCOMPARE(found.maximumValue, boundaries.maximumValue);
+                }
+            }
+        }
+    }
+};
+
+QTEST_MAIN(TestAggregationKernels)
+
+#include "main.moc"
@@ -13,7 +13,9 @@
 #include <KDChartCartesianCoordinatePlane>
 #include <KDChartDataValueAttributes>
 #include <KDChartGlobal>
+#include <KDChartLineAttributes>
 #include <KDChartLineDiagram>
+#include <QStandardItemModel>
 #include <QtTest/QtTest>
 #include <TableModel.h>
 
@@ -137,6 +139,63 @@ private slots:
         QCOMPARE(b.isVisible(), false); // No sharing
     }
 
+    void testKDChartAttributesModelBatchedUpdates()
+    {
+        QStandardItemModel model(10, 100);
+        LineDiagram lines;
+        lines.setModel(&model);
+        AttributesModel *attrsmodel = lines.attributesModel();
+        QSignalSpy attributesSpy(attrsmodel, &AttributesModel::attributesChanged);
+        QSignalSpy rolesSpy(attrsmodel, &AttributesModel::attributeRolesChanged);
+        QSignalSpy headerSpy(attrsmodel, &AttributesModel::headerDataChanged);
+        QSignalSpy dataSpy(attrsmodel, &AttributesModel::dataChanged);
+        QSignalSpy modelDataSpy(&lines, &AbstractDiagram::modelDataChanged);
+
+        // pens do not change data
+        lines.setPen(3, QPen(Qt::red));
+        QCOMPARE(attributesSpy.count(), 1);
+        QCOMPARE(headerSpy.count(), 1);
+        QCOMPARE(dataSpy.count(), 0);
+        QCOMPARE(modelDataSpy.count(), 0);
+        QCOMPARE(rolesSpy.takeFirst().at(2).value<QVector<int>>(), QVector<int>() << DatasetPenRole);
+        attributesSpy.clear();
+        headerSpy.clear();
+
+        // the changes of a batch are announced once, at the end of the outermost batch
+        attrsmodel->beginAttributesUpdate();
+        attrsmodel->beginAttributesUpdate();
+        for (int dataset = 10; dataset < 60; ++dataset) {
+            lines.setPen(dataset, QPen(Qt::blue));
+            lines.setBrush(dataset, QBrush(Qt::blue));
+        }
+        attrsmodel->endAttributesUpdate();
+        QVERIFY(attrsmodel->isUpdatingAttributes());
+        QCOMPARE(attributesSpy.count(), 0);
+        LineAttributes la = lines.lineAttributes();
+        la.setDisplayArea(true);
+        lines.setLineAttributes(20, la);
+        attrsmodel->endAttributesUpdate();
+        QVERIFY(!attrsmodel->isUpdatingAttributes());
+        QCOMPARE(lines.pen(30), QPen(Qt::blue));
+
+        QCOMPARE(attributesSpy.count(), 1);
+        QCOMPARE(attributesSpy.first().at(0).toModelIndex(), attrsmodel->index(0, 10, QModelIndex()));
+        QCOMPARE(attributesSpy.first().at(1).toModelIndex(), attrsmodel->index(9, 59, QModelIndex()));
+        QCOMPARE(rolesSpy.count(), 1);
+        const QVector<int> roles = rolesSpy.first().at(2).value<QVector<int>>();
+        QCOMPARE(roles.count(), 3);
+        QVERIFY(roles.contains(DatasetBrushRole));
+        QVERIFY(roles.contains(LineAttributesRole));
+        QCOMPARE(headerSpy.count(), 1);
+        QCOMPARE(headerSpy.first().at(1).toInt(), 10);
+        QCOMPARE(headerSpy.first().at(2).toInt(), 59);
+        // only the line attributes change the data
+        QCOMPARE(dataSpy.count(), 1);
+        QCOMPARE(dataSpy.first().at(0).toModelIndex(), attrsmodel->index(0, 20, QModelIndex()));
+        QCOMPARE(dataSpy.first().at(1).toModelIndex(), attrsmodel->index(9, 20, QModelIndex()));
+        QCOMPARE(modelDataSpy.count(), 1);
+    }
+
     void cleanupTestCase()
     {
         delete m_plane;
@@ -14,7 +14,9 @@
 #include <QtDebug>
 #include <QtTest/QtTest>
 
+#include <KDChartAttributesModel>
 #include <KDChartCartesianDiagramDataCompressor_p.h>
+#include <KDChartNumericDataModel_p.h>
 
 typedef KDChart::CartesianDiagramDataCompressor::CachePosition CachePosition;
 
@@ -179,6 +181,283 @@ private slots:
                  "datasetDimension == 1 should restore the old column count");
     }
 
+    void aggregationPatternTest()
+    {
+        typedef KDChart::CartesianDiagramDataCompressor Compressor;
+        // open, high, low and close of 100 rows, to be merged into 10 candles
+        QStandardItemModel stockModel(100, 4);
+        for (int row = 0; row < stockModel.rowCount(); ++row) {
+            stockModel.setData(stockModel.index(row, 0), row);
+            stockModel.setData(stockModel.index(row, 1), row + (row % 10 == 3 ? 50 : 10));
+            stockModel.setData(stockModel.index(row, 2), row - (row % 10 == 7 ? 50 : 10));
+            stockModel.setData(stockModel.index(row, 3), row + 1);
+        }
+
+        Compressor stockCompressor;
+        stockCompressor.setModel(&stockModel);
+        stockCompressor.setDatasetDimension(4);
+        stockCompressor.setResolution(10, 100);
+        QVERIFY2(stockCompressor.modelDataRows() == 100,
+                 "without an aggregation pattern, datasets with more than one dimension are not compressed");
+
+        stockCompressor.setAggregationPattern(QVector<Compressor::AggregationMode>()
+                                              << Compressor::FirstAggregation << Compressor::MaximumAggregation
+                                              << Compressor::MinimumAggregation << Compressor::LastAggregation);
+        stockCompressor.setResolution(10, 100);
+        QCOMPARE(stockCompressor.modelDataRows(), 10);
+        QCOMPARE(stockCompressor.modelDataColumns(), 4);
+
+        for (int candle = 0; candle < 10; ++candle) {
+            const int firstRow = candle * 10;
+            QCOMPARE(stockCompressor.data(CachePosition(candle, 0)).value, qreal(firstRow));
+            QCOMPARE(stockCompressor.data(CachePosition(candle, 1)).value, qreal(firstRow + 3 + 50));
+            QCOMPARE(stockCompressor.data(CachePosition(candle, 1)).index.row(), firstRow + 3);
+            QCOMPARE(stockCompressor.data(CachePosition(candle, 2)).value, qreal(firstRow + 7 - 50));
+            QCOMPARE(stockCompressor.data(CachePosition(candle, 2)).index.row(), firstRow + 7);
+            QCOMPARE(stockCompressor.data(CachePosition(candle, 3)).value, qreal(firstRow + 10));
+            // all values of a candle are at the same position
+            QCOMPARE(stockCompressor.data(CachePosition(candle, 0)).key, firstRow + 4.5);
+            QCOMPARE(stockCompressor.data(CachePosition(candle, 3)).key, firstRow + 4.5);
+        }
+
+        // changed values only invalidate their own column
+        stockModel.setData(stockModel.index(55, 1), 1000);
+        QCOMPARE(stockCompressor.data(CachePosition(5, 1)).value, qreal(1000));
+        QCOMPARE(stockCompressor.data(CachePosition(5, 2)).value, qreal(57 - 50));
+    }
+
+    void dataPointIndexTest()
+    {
+        // x and y of two datasets, fewer rows than pixels
+        QStandardItemModel xyModel(20, 4);
+        for (int row = 0; row < xyModel.rowCount(); ++row) {
+            for (int column = 0; column < xyModel.columnCount(); ++column) {
+                xyModel.setData(xyModel.index(row, column), row * 10 + column);
+            }
+        }
+        KDChart::CartesianDiagramDataCompressor xyCompressor;
+        xyCompressor.setModel(&xyModel);
+        xyCompressor.setDatasetDimension(2);
+        xyCompressor.setResolution(100, 100);
+        QCOMPARE(xyCompressor.modelDataRows(), 20);
+
+        // the index of a data point is the one of its key
+        const KDChart::CartesianDiagramDataCompressor::DataPoint point = xyCompressor.data(CachePosition(7, 1));
+        QCOMPARE(point.index, xyModel.index(7, 2));
+        QCOMPARE(point.key, qreal(72));
+        QCOMPARE(point.value, qreal(73));
+        QCOMPARE(xyCompressor.key(CachePosition(7, 1)), point.key);
+        QCOMPARE(xyCompressor.value(CachePosition(7, 1)), point.value);
+        QCOMPARE(xyCompressor.index(CachePosition(7, 1)), point.index);
+        QVERIFY(!xyCompressor.isHidden(CachePosition(7, 1)));
+
+        // outside of the data, there is no data point
+        QVERIFY(!xyCompressor.data(CachePosition(20, 0)).index.isValid());
+        QVERIFY(qIsNaN(xyCompressor.value(CachePosition(20, 0))));
+
+        // inserted rows move the cached data points along
+        xyModel.insertRow(0);
+        QCOMPARE(xyCompressor.data(CachePosition(8, 1)).index, xyModel.index(8, 2));
+        QCOMPARE(xyCompressor.value(CachePosition(8, 1)), qreal(73));
+    }
+
+    void appendTest()
+    {
+        typedef KDChart::CartesianDiagramDataCompressor Compressor;
+        QStandardItemModel feedModel(100, 2);
+        for (int row = 0; row < feedModel.rowCount(); ++row) {
+            feedModel.setData(feedModel.index(row, 0), row * 37 % 101);
+            feedModel.setData(feedModel.index(row, 1), row % 7);
+        }
+        const QVector<Compressor::AggregationMode> pattern = QVector<Compressor::AggregationMode>()
+            << Compressor::MaximumAggregation << Compressor::AverageAggregation;
+
+        Compressor feedCompressor;
+        feedCompressor.setModel(&feedModel);
+        feedCompressor.setAggregationPattern(pattern);
+        feedCompressor.setResolution(10, 100);
+        QCOMPARE(feedCompressor.modelDataRows(), 10);
+
+        // appended rows are folded into the data points, which are merged pairwise
+        // once there are too many of them
+        auto item = [](int value) {
+            auto *item = new QStandardItem;
+            item->setData(value, Qt::DisplayRole);
+            return item;
+        };
+        for (int row = 100; row < 400; ++row) {
+            feedModel.appendRow(QList<QStandardItem *>() << item(row * 37 % 101) << item(row % 7));
+            QVERIFY(feedCompressor.modelDataRows() <= 10);
+            // some data points are only retrieved from the model once they are merged
+            if (row % 3 != 0) {
+                for (int point = 0; point < feedCompressor.modelDataRows(); ++point) {
+                    feedCompressor.data(CachePosition(point, 0));
+                    feedCompressor.data(CachePosition(point, 1));
+                }
+            }
+            if (row == 249) {
+                // 40 rows per data point, the last one covers ten rows
+                QCOMPARE(feedCompressor.modelDataRows(), 7);
+                QCOMPARE(feedCompressor.data(CachePosition(6, 1)).key, 244.5);
+                QCOMPARE(feedCompressor.data(CachePosition(6, 1)).value, qreal(30) / 10);
+            }
+        }
+
+        Compressor compressor;
+        compressor.setModel(&feedModel);
+        compressor.setAggregationPattern(pattern);
+        compressor.setResolution(10, 100);
+        QCOMPARE(feedCompressor.modelDataRows(), compressor.modelDataRows());
+        for (int column = 0; column < 2; ++column) {
+            for (int point = 0; point < compressor.modelDataRows(); ++point) {
+                const CachePosition position(point, column);
+                QCOMPARE(feedCompressor.data(position).key, compressor.data(position).key);
+                QCOMPARE(feedCompressor.data(position).value, compressor.data(position).value);
+                QCOMPARE(feedCompressor.data(position).index, compressor.data(position).index);
+            }
+        }
+
+        // other row changes spread the rows evenly again
+        feedModel.removeRow(0);
+        QCOMPARE(feedCompressor.modelDataRows(), 10);
+        QCOMPARE(feedCompressor.data(CachePosition(0, 1)).key, qreal(19));
+    }
+
+    void sharedModelCacheTest()
+    {
+        QStandardItemModel sourceModel(20, 2);
+        for (int row = 0; row < sourceModel.rowCount(); ++row) {
+            sourceModel.setData(sourceModel.index(row, 0), row);
+            sourceModel.setData(sourceModel.index(row, 1), 2 * row);
+        }
+        // two diagrams on the same model, each with its own attributes model
+        KDChart::AttributesModel lineAttributes(&sourceModel);
+        KDChart::AttributesModel barAttributes(&sourceModel);
+
+        // the attributes models hold on to the cache, too
+        KDChart::SharedModelDataCache *cache = KDChart::SharedModelDataCache::acquire(&sourceModel);
+        QCOMPARE(cache->refCount(), 3);
+        {
+            KDChart::CartesianDiagramDataCompressor lineCompressor;
+            KDChart::CartesianDiagramDataCompressor barCompressor;
+            lineCompressor.setModel(&lineAttributes);
+            barCompressor.setModel(&barAttributes);
+            QCOMPARE(cache->refCount(), 5);
+
+            lineCompressor.setResolution(100, 100);
+            barCompressor.setResolution(100, 100);
+            QCOMPARE(lineCompressor.data(CachePosition(7, 1)).value, qreal(14));
+            QCOMPARE(barCompressor.data(CachePosition(7, 1)).value, qreal(14));
+
+            // changes of the source model reach both diagrams, and the cache is up to date
+            // when a diagram is told about them
+            qreal valueSeenByDiagram = 0;
+            connect(&barAttributes, &QAbstractItemModel::dataChanged, &barCompressor, [&]() {
+                valueSeenByDiagram = barCompressor.data(CachePosition(7, 1)).value;
+            });
+            sourceModel.setData(sourceModel.index(7, 1), 100);
+            QCOMPARE(valueSeenByDiagram, qreal(100));
+            QCOMPARE(lineCompressor.data(CachePosition(7, 1)).value, qreal(100));
+            QCOMPARE(barCompressor.data(CachePosition(7, 1)).value, qreal(100));
+
+            connect(&barAttributes, &QAbstractItemModel::rowsInserted, &barCompressor, [&]() {
+                valueSeenByDiagram = barCompressor.data(CachePosition(8, 1)).value;
+            });
+            sourceModel.insertRow(0);
+            QCOMPARE(valueSeenByDiagram, qreal(100));
+
+            // the compressed data stays per diagram
+            lineCompressor.setResolution(10, 100);
+            QVERIFY(lineCompressor.modelDataRows() < barCompressor.modelDataRows());
+
+            barCompressor.setModel(nullptr);
+            QCOMPARE(cache->refCount(), 4);
+        }
+        QCOMPARE(cache->refCount(), 3);
+        cache->release();
+    }
+
+    void asynchronousPreparationTest()
+    {
+        const int rowCount = 200000;
+        KDChart::NumericDataModel numericModel;
+        numericModel.insertColumns(0, 2);
+        numericModel.insertRows(0, rowCount);
+        QVector<qreal> rising(rowCount);
+        QVector<qreal> spiky(rowCount);
+        for (int row = 0; row < rowCount; ++row) {
+            rising[row] = row;
+            spiky[row] = row % 1000 == 999 ? 1000 : 0;
+        }
+        numericModel.setColumn(0, rising);
+        numericModel.setColumn(1, spiky);
+
+        KDChart::CartesianDiagramDataCompressor synchronous;
+        synchronous.setModel(&numericModel);
+        synchronous.setResolution(100, 100);
+        QVERIFY(!synchronous.isPreparing());
+
+        KDChart::CartesianDiagramDataCompressor asynchronous;
+        asynchronous.setAsynchronousPreparation(true);
+        QSignalSpy finishedSpy(&asynchronous, SIGNAL(preparationFinished()));
+        asynchronous.setModel(&numericModel);
+        asynchronous.setResolution(100, 100);
+        QVERIFY(asynchronous.isPreparing());
+        QCOMPARE(asynchronous.modelDataRows(), 100);
+        // the middle row of each data point is shown until the data is prepared
+        QCOMPARE(asynchronous.data(CachePosition(0, 1)).value, qreal(1000));
+
+        // a resolution change starts over, and only the last preparation finishes
+        asynchronous.setResolution(200, 100);
+        QVERIFY(asynchronous.isPreparing());
+        asynchronous.setResolution(100, 100);
+        QTRY_VERIFY(!asynchronous.isPreparing());
+        QCOMPARE(finishedSpy.count(), 1);
+
+        for (int column = 0; column < 2; ++column) {
+            for (int row = 0; row < 100; ++row) {
+                const CachePosition position(row, column);
+                QCOMPARE(asynchronous.data(position).key, synchronous.data(position).key);
+                QCOMPARE(asynchronous.data(position).value, synchronous.data(position).value);
+                QCOMPARE(asynchronous.data(position).index, synchronous.data(position).index);
+            }
+        }
+        QCOMPARE(asynchronous.data(CachePosition(0, 1)).value, qreal(1));
+
+        // changed values only invalidate their own data points
+        numericModel.setValue(0, 1, 2000);
+        QVERIFY(!asynchronous.isPreparing());
+        QCOMPARE(asynchronous.data(CachePosition(0, 1)).value, qreal(2000 + 1000 + 1000) / 2000);
+        QCOMPARE(asynchronous.data(CachePosition(1, 1)).value, qreal(1));
+
+        // values changed while preparing are not overwritten by the worker's older copy
+        asynchronous.setResolution(200, 100);
+        asynchronous.setResolution(100, 100);
+        QVERIFY(asynchronous.isPreparing());
+        numericModel.setValue(2000, 1, 3000);
+        QVERIFY(asynchronous.isPreparing());
+        QTRY_VERIFY(!asynchronous.isPreparing());
+        QCOMPARE(asynchronous.data(CachePosition(1, 1)).value, qreal(3000 + 1000 + 1000) / 2000);
+        QCOMPARE(asynchronous.data(CachePosition(0, 1)).value, qreal(2000 + 1000 + 1000) / 2000);
+
+        // datasets hidden as a whole are hidden in the prepared data points, too
+        KDChart::AttributesModel attributesModel(&numericModel);
+        attributesModel.setHeaderData(0, Qt::Horizontal, true, KDChart::DataHiddenRole);
+        asynchronous.setModel(&attributesModel);
+        QVERIFY(asynchronous.isPreparing());
+        QTRY_VERIFY(!asynchronous.isPreparing());
+        QVERIFY(asynchronous.isHidden(CachePosition(50, 0)));
+        QVERIFY(!asynchronous.isHidden(CachePosition(50, 1)));
+        QCOMPARE(asynchronous.data(CachePosition(50, 0)).value, synchronous.data(CachePosition(50, 0)).value);
+
+        // small models are compressed right away
+        KDChart::NumericDataModel smallModel;
+        smallModel.insertColumns(0, 1);
+        smallModel.insertRows(0, 1000);
+        asynchronous.setModel(&smallModel);
+        QVERIFY(!asynchronous.isPreparing());
+    }
+
     void cleanupTestCase()
     {
     }
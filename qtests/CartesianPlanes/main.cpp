@@ -9,9 +9,11 @@
 ****************************************************************************/
 
 #include <KDChartBarDiagram>
+#include <KDChartCartesianAxis>
 #include <KDChartCartesianCoordinatePlane>
 #include <KDChartChart>
 #include <KDChartGridAttributes>
+#include <KDChartPaintProfile>
 #include <KDChartPlotter>
 #include <QPair>
 #include <QPointF>
@@ -79,9 +81,13 @@ private slots:
     void testGlobalGridAttributesSettings();
     void testGridAttributesSettings();
     void testAxesCalcModesSettings();
+    void testAxisSizeFollowsData();
+    void testAxisSizeFollowsDataAxisFirst();
+    void testDeferredZoomRendering();
 
 private:
     void doTestRangeSettings(AbstractCartesianDiagram *diagram, const QPointF &min, const QPointF &max);
+    bool paintedDiagrams() const;
 
     Chart *m_chart;
     BarDiagram *m_bars;
@@ -278,6 +284,95 @@ void TestCartesianPlanes::testAxesCalcModesSettings()
     QCOMPARE(m_plane->axesCalcModeY(), AbstractCoordinatePlane::Linear);
 }
 
+void TestCartesianPlanes::testAxisSizeFollowsData()
+{
+    auto *axis = new CartesianAxis(m_bars);
+    axis->setPosition(CartesianAxis::Left);
+    m_bars->addAxis(axis);
+    m_chart->coordinatePlane()->replaceDiagram(m_bars);
+    m_model->setYValues(QList<qreal>() << 1 << 2 << 3);
+    m_chart->resize(400, 300);
+    m_chart->grab();
+    const int width = axis->geometry().width();
+    QVERIFY(width > 0);
+
+    // the same tick labels keep the layout
+    m_model->setYValues(QList<qreal>() << 3 << 1 << 2);
+    m_chart->grab();
+    QCOMPARE(axis->geometry().width(), width);
+
+    // longer tick labels make the axis wider
+    m_model->setYValues(QList<qreal>() << 1000000 << 2000000 << 3000000);
+    m_chart->grab();
+    QVERIFY(axis->geometry().width() > width);
+}
+
+void TestCartesianPlanes::testAxisSizeFollowsDataAxisFirst()
+{
+    // the axis observes the diagram before the plane does, so the plane
+    // only relayouts after the axis saw the new data
+    auto *bars = new BarDiagram(m_chart);
+    auto *axis = new CartesianAxis(bars);
+    axis->setPosition(CartesianAxis::Left);
+    bars->addAxis(axis);
+    bars->setModel(m_model);
+    m_chart->coordinatePlane()->replaceDiagram(bars);
+    m_model->setYValues(QList<qreal>() << 1 << 2 << 3);
+    m_chart->resize(400, 300);
+    m_chart->grab();
+    const int width = axis->geometry().width();
+    QVERIFY(width > 0);
+
+    m_model->setYValues(QList<qreal>() << 1000000 << 2000000 << 3000000);
+    m_chart->grab();
+    QVERIFY(axis->geometry().width() > width);
+}
+
+void TestCartesianPlanes::testDeferredZoomRendering()
+{
+    auto *plane = static_cast<CartesianCoordinatePlane *>(m_chart->coordinatePlane());
+    plane->replaceDiagram(m_bars);
+    m_model->setYValues(QList<qreal>() << 1 << 2 << 3);
+    QVERIFY(!plane->isDeferredZoomRenderingEnabled());
+    plane->setDeferredZoomRendering(true);
+    QVERIFY(plane->isDeferredZoomRenderingEnabled());
+    plane->setZoomSettleTime(50);
+    QCOMPARE(plane->zoomSettleTime(), 50);
+    m_chart->setPaintProfilingEnabled(true);
+    m_chart->resize(400, 300);
+    const QImage painted = m_chart->grab().toImage();
+    QVERIFY(paintedDiagrams());
+
+    // while zooming, the diagrams as painted last are scaled to the new zoom
+    plane->setZoomFactorX(2);
+    plane->setZoomFactorY(2);
+    const QImage zoomed = m_chart->grab().toImage();
+    QVERIFY(!paintedDiagrams());
+    QVERIFY(zoomed != painted);
+
+    // once the zoom settles, they are painted again
+    QTest::qWait(100);
+    m_chart->grab();
+    QVERIFY(paintedDiagrams());
+
+    plane->setDeferredZoomRendering(false);
+    plane->setZoomFactorX(1);
+    plane->setZoomFactorY(1);
+    m_chart->grab();
+    QVERIFY(paintedDiagrams());
+}
+
+bool TestCartesianPlanes::paintedDiagrams() const
+{
+    const PaintProfile profile = m_chart->lastPaintProfile();
+    for (const PaintProfile::Event &event : profile.events) {
+        if (event.phase == PaintProfile::DiagramPhase) {
+            return true;
+        }
+    }
+    return false;
+}
+
 QTEST_MAIN(TestCartesianPlanes)
 
 #include "main.moc"
@@ -8,6 +8,9 @@
 **
 ****************************************************************************/
 
+#include <QImage>
+#include <QPainter>
+#include <QPicture>
 #include <QStandardItemModel>
 #include <QtTest/QtTest>
 
@@ -124,11 +127,114 @@ private slots:
         QVERIFY(l->legendStyle() == Legend::LinesOnly);
     }
 
+    void testVirtualizedLegend()
+    {
+        QStandardItemModel model(5, 2000);
+        auto *lines = new LineDiagram();
+        lines->setModel(&model);
+        auto *l = new Legend(lines, m_chart);
+        QVERIFY(!l->isVirtualized());
+        l->setVirtualized(true);
+        QVERIFY(l->isVirtualized());
+
+        const QSize size = l->sizeHint();
+        QVERIFY(size.isValid());
+        QVERIFY(size.height() > 2000);
+
+        // changing a single entry does not rebuild the legend
+        l->setText(10, QString::fromLatin1("A much, much longer label than all the others"));
+        QCOMPARE(l->text(10), QString::fromLatin1("A much, much longer label than all the others"));
+        QVERIFY(l->sizeHint().width() > size.width());
+        QCOMPARE(l->sizeHint().height(), size.height());
+        l->setBrush(10, Qt::red);
+        QCOMPARE(l->brush(10), QBrush(Qt::red));
+
+        QImage image(l->sizeHint(), QImage::Format_ARGB32);
+        QPainter painter(&image);
+        painter.setClipRect(0, 0, image.width(), 100);
+        l->paint(&painter);
+
+        Legend *clone = l->clone();
+        QVERIFY(clone->isVirtualized());
+        delete clone;
+        delete l;
+        delete lines;
+    }
+
+    void testSymbolImages_data()
+    {
+        QTest::addColumn<bool>("virtualized");
+        QTest::newRow("items") << false;
+        QTest::newRow("virtualized") << true;
+    }
+
+    // symbols painted from their images look like symbols painted directly
+    void testSymbolImages()
+    {
+        QFETCH(bool, virtualized);
+        QStandardItemModel model(5, 4);
+        LineDiagram lines;
+        lines.setModel(&model);
+        Legend l(&lines, nullptr);
+        l.setVirtualized(virtualized);
+        l.setLegendStyle(Legend::MarkersAndLines);
+
+        // symbols are not cached in pictures, replaying one paints them directly
+        QPicture picture;
+        QPainter picturePainter(&picture);
+        l.paint(&picturePainter);
+        picturePainter.end();
+        QImage direct(l.sizeHint(), QImage::Format_ARGB32_Premultiplied);
+        direct.fill(Qt::white);
+        QPainter painter(&direct);
+        painter.drawPicture(0, 0, picture);
+        painter.end();
+
+        const QImage first = paintLegend(&l);
+        QVERIFY(isSimilar(first, direct));
+        QCOMPARE(paintLegend(&l), first);
+
+        // a new brush paints the symbol again
+        const QBrush brush = l.brush(1);
+        l.setBrush(1, Qt::red);
+        QVERIFY(paintLegend(&l) != first);
+        l.setBrush(1, brush);
+        QCOMPARE(paintLegend(&l), first);
+    }
+
     void cleanupTestCase()
     {
     }
 
 private:
+    static QImage paintLegend(Legend *legend)
+    {
+        QImage image(legend->sizeHint(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        legend->paint(&painter);
+        return image;
+    }
+
+    // antialiased edges blended through an image may be rounded differently
+    static bool isSimilar(const QImage &image, const QImage &other)
+    {
+        if (image.size() != other.size()) {
+            return false;
+        }
+        for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < image.width(); ++x) {
+                const QRgb a = image.pixel(x, y);
+                const QRgb b = other.pixel(x, y);
+                if (qAbs(qRed(a) - qRed(b)) > 2 || qAbs(qGreen(a) - qGreen(b)) > 2
+                    || qAbs(qBlue(a) - qBlue(b)) > 2) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
     Chart *m_chart;
     BarDiagram *m_bars;
     LineDiagram *m_lines;
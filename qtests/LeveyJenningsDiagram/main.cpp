@@ -0,0 +1,157 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartLeveyJenningsDiagram>
+#include <QStandardItemModel>
+#include <QtTest/QtTest>
+
+#include <cmath>
+
+using namespace KDChart;
+
+class TestLeveyJenningsDiagram : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void init()
+    {
+        m_model = new QStandardItemModel(0, 4, this);
+        m_diagram = new LeveyJenningsDiagram;
+        m_diagram->setModel(m_model);
+    }
+
+    void cleanup()
+    {
+        delete m_diagram;
+        delete m_model;
+    }
+
+    void testEmptyModel()
+    {
+        QVERIFY(std::isnan(m_diagram->calculatedMeanValue()));
+        QVERIFY(std::isnan(m_diagram->calculatedStandardDeviation()));
+        appendValue(5.0);
+        QCOMPARE(m_diagram->calculatedMeanValue(), 5.0f);
+        QVERIFY(std::isnan(m_diagram->calculatedStandardDeviation()));
+    }
+
+    void testLargeOffset()
+    {
+        // the sum of squares of these values is too large for the variance to survive
+        // the naive formula
+        const qreal offset = 1e9;
+        for (qreal value : {4.0, 7.0, 13.0, 16.0})
+            appendValue(offset + value);
+        QCOMPARE(m_diagram->calculatedMeanValue(), float(offset + 10.0));
+        QVERIFY(nearlyEqual(m_diagram->calculatedStandardDeviation(), std::sqrt(30.0)));
+    }
+
+    void testInsertRemoveAndChange()
+    {
+        for (int i = 0; i < 20; ++i)
+            appendValue(i * i % 7);
+        verifyStatistics();
+
+        m_model->insertRow(5);
+        verifyStatistics();
+        m_model->setData(m_model->index(5, 1), 100.0);
+        verifyStatistics();
+        m_model->setData(m_model->index(10, 1), -3.5);
+        verifyStatistics();
+        m_model->setData(m_model->index(11, 1), QVariant());
+        verifyStatistics();
+        m_model->removeRows(0, 3);
+        verifyStatistics();
+        m_model->removeRows(m_model->rowCount() - 4, 4);
+        verifyStatistics();
+        while (m_model->rowCount() > 1) {
+            m_model->removeRow(m_model->rowCount() / 2);
+            verifyStatistics();
+        }
+    }
+
+    void testWindow()
+    {
+        m_diagram->setStatisticsWindow(5);
+        QCOMPARE(m_diagram->statisticsWindow(), 5);
+        for (int i = 0; i < 30; ++i) {
+            appendValue(i % 4 + i * 0.5);
+            verifyStatistics();
+        }
+        m_model->insertRow(27);
+        verifyStatistics();
+        m_model->setData(m_model->index(27, 1), 42.0);
+        verifyStatistics();
+        m_model->insertRow(10);
+        verifyStatistics();
+        m_model->removeRows(26, 2);
+        verifyStatistics();
+        m_model->removeRows(0, 20);
+        verifyStatistics();
+        m_model->setData(m_model->index(2, 1), 8.0);
+        verifyStatistics();
+
+        m_diagram->setStatisticsWindow(0);
+        verifyStatistics();
+    }
+
+private:
+    void appendValue(qreal value)
+    {
+        const int row = m_model->rowCount();
+        m_model->insertRow(row);
+        m_model->setData(m_model->index(row, 1), value);
+    }
+
+    // the diagram returns float
+    static bool nearlyEqual(float actual, qreal expected)
+    {
+        return qAbs(actual - expected) <= 1e-5 * qMax(qreal(1.0), qAbs(expected));
+    }
+
+    // compares with the two pass calculation over the model
+    void verifyStatistics()
+    {
+        const int window = m_diagram->statisticsWindow();
+        const int rowCount = m_model->rowCount();
+        QVector<qreal> values;
+        for (int row = window > 0 ? qMax(0, rowCount - window) : 0; row < rowCount; ++row) {
+            const QVariant value = m_model->data(m_model->index(row, 1));
+            if (value.isValid())
+                values << value.toReal();
+        }
+        qreal mean = 0.0;
+        for (qreal value : qAsConst(values))
+            mean += value;
+        mean /= values.size();
+        qreal squares = 0.0;
+        for (qreal value : qAsConst(values))
+            squares += (value - mean) * (value - mean);
+
+        if (values.isEmpty()) {
+            QVERIFY(std::isnan(m_diagram->calculatedMeanValue()));
+        } else {
+            QVERIFY(nearlyEqual(m_diagram->calculatedMeanValue(), mean));
+        }
+        if (values.size() < 2) {
+            QVERIFY(std::isnan(m_diagram->calculatedStandardDeviation()));
+        } else {
+            QVERIFY(nearlyEqual(m_diagram->calculatedStandardDeviation(), std::sqrt(squares / (values.size() - 1))));
+        }
+    }
+
+    QStandardItemModel *m_model;
+    LeveyJenningsDiagram *m_diagram;
+};
+
+QTEST_MAIN(TestLeveyJenningsDiagram)
+
+#include "main.moc"
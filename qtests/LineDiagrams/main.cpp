@@ -12,7 +12,11 @@
 #include <KDChartChart>
 #include <KDChartGlobal>
 #include <KDChartLineDiagram>
+#include <KDChartPaintProfile>
 #include <KDChartThreeDLineAttributes>
+#include <QImage>
+#include <QPainter>
+#include <QStandardItemModel>
 #include <QtTest/QtTest>
 
 #include <TableModel.h>
@@ -155,11 +159,53 @@ private slots:
         QVERIFY(m_lines->threeDLineAttributes().lineYRotation() == 25);
     }
 
+    void testAreasFilledPerRun()
+    {
+        QStandardItemModel model(20, 3);
+        Chart chart;
+        for (int row = 0; row < model.rowCount(); ++row) {
+            for (int column = 0; column < model.columnCount(); ++column) {
+                model.setData(model.index(row, column), row * (column + 1) + 1);
+            }
+        }
+        auto *lines = new LineDiagram();
+        lines->setModel(&model);
+        chart.coordinatePlane()->replaceDiagram(lines);
+        chart.setPaintProfilingEnabled(true);
+
+        const LineDiagram::LineType types[] = {LineDiagram::Normal, LineDiagram::Stacked, LineDiagram::Percent};
+        for (LineDiagram::LineType type : types) {
+            lines->setType(type);
+            LineAttributes la(lines->lineAttributes());
+            la.setDisplayArea(false);
+            lines->setLineAttributes(la);
+            const quint64 withoutAreas = paintedPolylines(&chart);
+            la.setDisplayArea(true);
+            lines->setLineAttributes(la);
+            // one polygon per dataset
+            QCOMPARE(paintedPolylines(&chart), withoutAreas + model.columnCount());
+        }
+
+        // a different brush for the segment after one data point splits its dataset's area
+        lines->setType(LineDiagram::Normal);
+        const quint64 merged = paintedPolylines(&chart);
+        lines->setBrush(model.index(10, 1), QBrush(Qt::red));
+        QCOMPARE(paintedPolylines(&chart), merged + 2);
+    }
+
     void cleanupTestCase()
     {
     }
 
 private:
+    static quint64 paintedPolylines(Chart *chart)
+    {
+        QImage image(400, 300, QImage::Format_ARGB32_Premultiplied);
+        QPainter painter(&image);
+        chart->paint(&painter, image.rect());
+        return chart->lastPaintProfile().counters[PaintProfile::PolylineCounter];
+    }
+
     Chart *m_chart;
     LineDiagram *m_lines;
     TableModel *m_model;
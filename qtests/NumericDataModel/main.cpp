@@ -0,0 +1,114 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartAbstractDiagram>
+#include <KDChartNumericDataModel_p.h>
+#include <KDChartWidget>
+#include <QtTest/QtTest>
+
+using namespace KDChart;
+
+class TestNumericDataModel : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void testSetColumnSharesData()
+    {
+        NumericDataModel model;
+        model.insertColumns(0, 1);
+        model.insertRows(0, 3);
+        const QVector<qreal> values = {1.0, 2.0, 3.0};
+        QSignalSpy spy(&model, &NumericDataModel::dataChanged);
+        model.setColumn(0, values);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(model.value(2, 0), 3.0);
+        QCOMPARE(model.data(model.index(1, 0)).toReal(), 2.0);
+        // the model refers to the caller's array instead of holding a copy
+        QVERIFY(!values.isDetached());
+    }
+
+    void testShorterColumnOverwritesPrefix()
+    {
+        NumericDataModel model;
+        model.insertColumns(0, 1);
+        model.insertRows(0, 3);
+        model.setColumn(0, QVector<qreal>({1.0, 2.0, 3.0}));
+        model.setColumn(0, QVector<qreal>({10.0}));
+        QCOMPARE(model.value(0, 0), 10.0);
+        QCOMPARE(model.value(1, 0), 2.0);
+        QCOMPARE(model.value(2, 0), 3.0);
+    }
+
+    void testEmptyCells()
+    {
+        NumericDataModel model;
+        model.insertColumns(0, 2);
+        model.insertRows(0, 4);
+        model.setValue(2, 1, 5.0);
+        QVERIFY(!model.data(model.index(0, 0)).isValid());
+        QVERIFY(!model.data(model.index(1, 1)).isValid());
+        QCOMPARE(model.data(model.index(2, 1)).toReal(), 5.0);
+        QVERIFY(!model.data(model.index(3, 1)).isValid());
+
+        // values that are not numbers are rejected and keep the cell
+        QVERIFY(!model.setData(model.index(2, 1), QStringLiteral("five")));
+        QCOMPARE(model.data(model.index(2, 1)).toReal(), 5.0);
+        QVERIFY(model.setData(model.index(2, 1), QStringLiteral("6")));
+        QCOMPARE(model.data(model.index(2, 1)).toReal(), 6.0);
+
+        QVERIFY(model.setData(model.index(2, 1), QVariant()));
+        QVERIFY(!model.data(model.index(2, 1)).isValid());
+
+        // inserting rows in front of the values moves them down
+        model.setValue(0, 1, 7.0);
+        model.insertRows(0, 1);
+        QCOMPARE(model.rowCount(), 5);
+        QVERIFY(!model.data(model.index(0, 1)).isValid());
+        QCOMPARE(model.value(1, 1), 7.0);
+    }
+
+    void testHeaderData()
+    {
+        NumericDataModel model;
+        model.insertColumns(0, 2);
+        QVERIFY(model.setHeaderData(1, Qt::Horizontal, QString::fromLatin1("Title")));
+        QCOMPARE(model.headerData(1, Qt::Horizontal).toString(), QString::fromLatin1("Title"));
+        // columns without a title fall back to the default numbering
+        QCOMPARE(model.headerData(0, Qt::Horizontal).toString(), QString::fromLatin1("1"));
+        QVERIFY(!model.setHeaderData(2, Qt::Horizontal, QString::fromLatin1("Out of range")));
+    }
+
+    void testWidgetDatasets()
+    {
+        Widget widget;
+        widget.setDataset(0, QVector<qreal>({1.0, 2.0, 3.0}), QString::fromLatin1("First"));
+        widget.setDataset(1, QVector<qreal>({4.0, 5.0}));
+        widget.setDataCell(4, 0, 6.0);
+
+        const QAbstractItemModel *model = widget.diagram()->model();
+        QCOMPARE(model->rowCount(), 5);
+        QCOMPARE(model->columnCount(), 2);
+        QCOMPARE(model->headerData(0, Qt::Horizontal).toString(), QString::fromLatin1("First"));
+        QCOMPARE(model->data(model->index(2, 0)).toReal(), 3.0);
+        QVERIFY(!model->data(model->index(3, 0)).isValid());
+        QCOMPARE(model->data(model->index(4, 0)).toReal(), 6.0);
+        QCOMPARE(model->data(model->index(1, 1)).toReal(), 5.0);
+        QVERIFY(!model->data(model->index(2, 1)).isValid());
+
+        widget.resetData();
+        QCOMPARE(model->rowCount(), 0);
+        QCOMPARE(model->columnCount(), 0);
+    }
+};
+
+QTEST_MAIN(TestNumericDataModel)
+
+#include "main.moc"
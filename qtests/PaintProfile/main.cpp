@@ -0,0 +1,160 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartCartesianAxis>
+#include <KDChartCartesianCoordinatePlane>
+#include <KDChartChart>
+#include <KDChartDataValueAttributes>
+#include <KDChartLegend>
+#include <KDChartLineDiagram>
+#include <KDChartMarkerAttributes>
+#include <KDChartPaintProfile>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QStandardItemModel>
+#include <QtTest/QtTest>
+
+using namespace KDChart;
+
+class TestPaintProfile : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void initTestCase()
+    {
+        m_chart = new Chart(nullptr);
+        m_model = new QStandardItemModel(20, 3, this);
+        for (int row = 0; row < m_model->rowCount(); ++row) {
+            for (int column = 0; column < m_model->columnCount(); ++column) {
+                m_model->setData(m_model->index(row, column), row * (column + 1));
+            }
+        }
+        m_lines = new LineDiagram();
+        m_lines->setModel(m_model);
+        DataValueAttributes dva(m_lines->dataValueAttributes());
+        dva.setVisible(true);
+        MarkerAttributes ma(dva.markerAttributes());
+        ma.setVisible(true);
+        dva.setMarkerAttributes(ma);
+        m_lines->setDataValueAttributes(dva);
+        auto *axis = new CartesianAxis(m_lines);
+        axis->setPosition(CartesianAxis::Bottom);
+        m_lines->addAxis(axis);
+        m_chart->coordinatePlane()->replaceDiagram(m_lines);
+        m_chart->addLegend(new Legend(m_lines, m_chart));
+    }
+
+    void cleanupTestCase()
+    {
+        delete m_chart;
+    }
+
+    void testDisabledByDefault()
+    {
+        QVERIFY(!m_chart->isPaintProfilingEnabled());
+        paintChart();
+        QVERIFY(!m_chart->lastPaintProfile().isValid());
+    }
+
+    void testPhasesAndCounters()
+    {
+        m_chart->setPaintProfilingEnabled(true);
+        paintChart();
+        const PaintProfile profile = m_chart->lastPaintProfile();
+        QVERIFY(profile.isValid());
+
+        QSet<int> phases;
+        int diagramDepth = -1;
+        for (const PaintProfile::Event &event : profile.events) {
+            phases.insert(event.phase);
+            QVERIFY(event.start >= 0);
+            QVERIFY(event.duration >= 0);
+            QVERIFY(event.start + event.duration <= profile.totalTime);
+            if (event.phase == PaintProfile::DiagramPhase) {
+                diagramDepth = event.depth;
+            } else if (event.phase == PaintProfile::DataValueTextsPhase) {
+                // the data value texts are painted from within the diagram
+                QVERIFY(event.depth > diagramDepth);
+            }
+        }
+        QVERIFY(phases.contains(PaintProfile::LayoutPhase));
+        QVERIFY(phases.contains(PaintProfile::GridPhase));
+        QVERIFY(phases.contains(PaintProfile::AxisPhase));
+        QVERIFY(phases.contains(PaintProfile::DiagramPhase));
+        QVERIFY(phases.contains(PaintProfile::DataValueTextsPhase));
+        QVERIFY(phases.contains(PaintProfile::LegendPhase));
+
+        // the phase times are exclusive, so they can not add up to more than the whole paint
+        qint64 phaseTimes = 0;
+        for (int phase = 0; phase < PaintProfile::PhaseCount; ++phase) {
+            QVERIFY(profile.phaseTimes[phase] >= 0);
+            phaseTimes += profile.phaseTimes[phase];
+        }
+        QVERIFY(phaseTimes <= profile.totalTime);
+
+        QVERIFY(profile.counters[PaintProfile::PolylineCounter] > 0);
+        QVERIFY(profile.counters[PaintProfile::MarkerCounter] > 0);
+        QVERIFY(profile.counters[PaintProfile::LabelCounter] > 0);
+        QVERIFY(profile.counters[PaintProfile::ModelFetchCounter] > 0);
+        QVERIFY(profile.counters[PaintProfile::CacheHitCounter] + profile.counters[PaintProfile::CacheMissCounter] > 0);
+        QVERIFY(profile.cacheHitRate() >= 0.0 && profile.cacheHitRate() <= 1.0);
+    }
+
+    void testChromeTrace()
+    {
+        const PaintProfile profile = m_chart->lastPaintProfile();
+        QJsonParseError error;
+        const QJsonDocument trace = QJsonDocument::fromJson(profile.toChromeTrace(), &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        const QJsonArray traceEvents = trace.object().value(QLatin1String("traceEvents")).toArray();
+        // one event for the whole paint, and one for each phase
+        QCOMPARE(traceEvents.size(), profile.events.size() + 1);
+        for (const QJsonValue &value : traceEvents) {
+            const QJsonObject event = value.toObject();
+            QCOMPARE(event.value(QLatin1String("ph")).toString(), QString::fromLatin1("X"));
+            QVERIFY(event.contains(QLatin1String("ts")));
+            QVERIFY(event.contains(QLatin1String("dur")));
+        }
+        const QJsonObject args = traceEvents.first().toObject().value(QLatin1String("args")).toObject();
+        QCOMPARE(quint64(args.value(PaintProfile::counterName(PaintProfile::MarkerCounter)).toDouble()),
+                 profile.counters[PaintProfile::MarkerCounter]);
+    }
+
+    void testDisablingKeepsLastProfile()
+    {
+        const PaintProfile before = m_chart->lastPaintProfile();
+        m_chart->setPaintProfilingEnabled(false);
+        paintChart();
+        const PaintProfile after = m_chart->lastPaintProfile();
+        QVERIFY(after.isValid());
+        QCOMPARE(after.totalTime, before.totalTime);
+        QCOMPARE(after.events.size(), before.events.size());
+    }
+
+private:
+    void paintChart()
+    {
+        QImage image(400, 300, QImage::Format_ARGB32_Premultiplied);
+        QPainter painter(&image);
+        m_chart->paint(&painter, image.rect());
+    }
+
+    Chart *m_chart;
+    QStandardItemModel *m_model;
+    LineDiagram *m_lines;
+};
+
+QTEST_MAIN(TestPaintProfile)
+
+#include "main.moc"
@@ -0,0 +1,190 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <QPainterPath>
+#include <QRandomGenerator>
+#include <QtTest/QtTest>
+
+#include <KDChartPieLabelLayout_p.h>
+
+#include <math.h>
+
+using namespace KDChart;
+
+struct PieLabels
+{
+    QVector<QPainterPath> labelAreas;
+    QVector<qreal> angles;
+};
+
+// Labels of the given size centered on the rim of a pie with the given radius
+static PieLabels makeLabels(int slices, bool randomSizes, qreal radius = 100.0, const QSizeF &labelSize = QSizeF(40, 12))
+{
+    QRandomGenerator random(slices);
+    QVector<qreal> values(slices, 1.0);
+    qreal total = 0.0;
+    for (qreal &value : values) {
+        if (randomSizes) {
+            value = 0.05 + random.generateDouble();
+        }
+        total += value;
+    }
+
+    PieLabels ret;
+    qreal startAngle = 0.0;
+    for (qreal value : qAsConst(values)) {
+        const qreal angleLen = value / total * 360.0;
+        const qreal angle = startAngle + angleLen / 2.0;
+        startAngle += angleLen;
+        const qreal rad = angle * M_PI / 180.0;
+        const QPointF center(radius * cos(rad), -radius * sin(rad));
+        QRectF rect(QPointF(), labelSize);
+        rect.moveCenter(center);
+        QPainterPath path;
+        path.addPolygon(QPolygon(rect.toRect(), true));
+        ret.labelAreas << path;
+        ret.angles << angle;
+    }
+    return ret;
+}
+
+static int wraparound(int i, int size)
+{
+    while (i < 0) {
+        i += size;
+    }
+    while (i >= size) {
+        i -= size;
+    }
+    return i;
+}
+
+// The label placement used by PieDiagram before PieLabelLayout, kept as a baseline
+static void shuffleLabelsIteratively(QVector<QPainterPath> *labelAreas, const QVector<qreal> &angles)
+{
+    const int n = labelAreas->size();
+    qreal direction = 5.0;
+    QVector<qreal> offsets;
+    offsets.fill(0.0, n);
+
+    for (bool lastRoundModified = true; lastRoundModified;) {
+        lastRoundModified = false;
+
+        for (int i = 0; i < n; i++) {
+            const int neighborsToCheck = qMax(10, n - 1);
+            const int minComp = wraparound(i - neighborsToCheck / 2, n);
+            const int maxComp = wraparound(i + (neighborsToCheck + 1) / 2, n);
+
+            QPainterPath &path = (*labelAreas)[i];
+
+            for (int j = minComp; j != maxComp; j = wraparound(j + 1, n)) {
+                if (i == j) {
+                    continue;
+                }
+                const QPainterPath &otherPath = labelAreas->at(j);
+
+                while ((offsets[i] + direction > 0) && otherPath.intersects(path)) {
+                    const qreal angle = angles.at(i) * M_PI / 180.0;
+                    offsets[i] += direction;
+                    path.translate(cos(angle) * direction, -sin(angle) * direction);
+                    lastRoundModified = true;
+                }
+            }
+        }
+        direction *= -1.07;
+    }
+}
+
+class TestPieLabelLayout : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void testNoOverlaps_data()
+    {
+        QTest::addColumn<int>("slices");
+        QTest::addColumn<bool>("randomSizes");
+        for (int slices : {3, 10, 100, 1000}) {
+            QTest::newRow(qPrintable(QString::fromLatin1("%1 equal").arg(slices))) << slices << false;
+            QTest::newRow(qPrintable(QString::fromLatin1("%1 random").arg(slices))) << slices << true;
+        }
+    }
+
+    void testNoOverlaps()
+    {
+        QFETCH(int, slices);
+        QFETCH(bool, randomSizes);
+
+        const PieLabels before = makeLabels(slices, randomSizes);
+        QVector<QPainterPath> labelAreas = before.labelAreas;
+        PieLabelLayout::resolveCollisions(&labelAreas, before.angles);
+
+        for (int i = 0; i < slices; ++i) {
+            const QRectF rect = labelAreas.at(i).boundingRect();
+            for (int j = i + 1; j < slices; ++j) {
+                QVERIFY2(!rect.intersects(labelAreas.at(j).boundingRect()),
+                         qPrintable(QString::fromLatin1("labels %1 and %2 overlap").arg(i).arg(j)));
+            }
+
+            // labels only move outwards, along the bisector of their slice
+            const QPointF moved = rect.center() - before.labelAreas.at(i).boundingRect().center();
+            const qreal angle = before.angles.at(i) * M_PI / 180.0;
+            const QPointF dir(cos(angle), -sin(angle));
+            QVERIFY(moved.x() * dir.x() + moved.y() * dir.y() >= -1e-6);
+            QVERIFY(qAbs(moved.x() * dir.y() - moved.y() * dir.x()) < 1e-6);
+        }
+    }
+
+    void testUnmovedLabels()
+    {
+        // a big pie with few slices has no colliding labels
+        PieLabels labels = makeLabels(4, false, 500.0);
+        const QVector<QPainterPath> before = labels.labelAreas;
+        QVERIFY(!PieLabelLayout::resolveCollisions(&labels.labelAreas, labels.angles));
+        QCOMPARE(labels.labelAreas, before);
+    }
+
+    void benchmarkSweep_data()
+    {
+        QTest::addColumn<int>("slices");
+        for (int slices : {10, 100, 1000}) {
+            QTest::newRow(qPrintable(QString::number(slices))) << slices;
+        }
+    }
+
+    void benchmarkSweep()
+    {
+        QFETCH(int, slices);
+        const PieLabels labels = makeLabels(slices, true);
+        QBENCHMARK {
+            QVector<QPainterPath> labelAreas = labels.labelAreas;
+            PieLabelLayout::resolveCollisions(&labelAreas, labels.angles);
+        }
+    }
+
+    void benchmarkIterative_data()
+    {
+        benchmarkSweep_data();
+    }
+
+    void benchmarkIterative()
+    {
+        QFETCH(int, slices);
+        const PieLabels labels = makeLabels(slices, true);
+        QBENCHMARK {
+            QVector<QPainterPath> labelAreas = labels.labelAreas;
+            shuffleLabelsIteratively(&labelAreas, labels.angles);
+        }
+    }
+};
+
+QTEST_MAIN(TestPieLabelLayout)
+
+#include "main.moc"
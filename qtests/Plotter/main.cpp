@@ -0,0 +1,222 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartCartesianCoordinatePlane>
+#include <KDChartChart>
+#include <KDChartPlotter>
+#include <QAbstractTableModel>
+#include <QImage>
+#include <QPainter>
+#include <QSignalSpy>
+#include <QtTest/QtTest>
+
+#include <cmath>
+
+using namespace KDChart;
+
+// a large dataset with an x and a y column
+class WaveModel : public QAbstractTableModel
+{
+public:
+    explicit WaveModel(QObject *parent)
+        : QAbstractTableModel(parent)
+    {
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : 200000;
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : 2;
+    }
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    {
+        if (!index.isValid() || role != Qt::DisplayRole)
+            return QVariant();
+        const qreal x = index.row() * m_step;
+        return index.column() == 0 ? x : std::sin(x);
+    }
+
+    void setStep(qreal step)
+    {
+        m_step = step;
+        Q_EMIT dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+    }
+
+private:
+    qreal m_step = 0.001;
+};
+
+class TestPlotter : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void init()
+    {
+        m_chart = new Chart(nullptr);
+        m_model = new WaveModel(this);
+        m_plotter = new Plotter();
+        m_plotter->setModel(m_model);
+        m_chart->coordinatePlane()->replaceDiagram(m_plotter);
+    }
+
+    void cleanup()
+    {
+        delete m_chart;
+        delete m_model;
+    }
+
+    void testDisabledByDefault()
+    {
+        QVERIFY(!m_plotter->progressiveRendering());
+        paintChart();
+        QVERIFY(!m_plotter->isRefining());
+    }
+
+    void testRefinement()
+    {
+        QSignalSpy finishedSpy(m_plotter, &Plotter::refinementFinished);
+        m_plotter->setProgressiveRendering(true);
+        m_plotter->setProgressiveFrameBudget(5);
+        QCOMPARE(m_plotter->progressiveFrameBudget(), 5);
+
+        paintChart();
+        QVERIFY(m_plotter->isRefining());
+        QTRY_VERIFY(!m_plotter->isRefining());
+        QCOMPARE(finishedSpy.count(), 1);
+
+        // the complete image is reused as long as nothing changes
+        paintChart();
+        QVERIFY(!m_plotter->isRefining());
+        QCOMPARE(finishedSpy.count(), 1);
+    }
+
+    void testRefinedImage_data()
+    {
+        QTest::addColumn<qreal>("zoom");
+        QTest::newRow("all rows") << 1.0;
+        QTest::newRow("visible rows") << 50.0;
+    }
+
+    void testRefinedImage()
+    {
+        // the refined image is put together from slices of rows, the slices
+        // must join without gaps or overlaps; without antialiasing the pixels match exactly
+        QFETCH(qreal, zoom);
+        m_plotter->setAntiAliasing(false);
+        auto *plane = static_cast<CartesianCoordinatePlane *>(m_chart->coordinatePlane());
+        plane->setZoomFactors(zoom, 1.0);
+        plane->setZoomCenter(QPointF(0.3, 0.5));
+        const QImage direct = paintChart();
+
+        QSignalSpy finishedSpy(m_plotter, &Plotter::refinementFinished);
+        m_plotter->setProgressiveRendering(true);
+        paintChart();
+        QVERIFY(m_plotter->isRefining());
+        QTRY_COMPARE(finishedSpy.count(), 1);
+        QCOMPARE(paintChart(), direct);
+    }
+
+    void testZoomRestartsRefinement()
+    {
+        m_plotter->setProgressiveRendering(true);
+        paintChart();
+        QTRY_VERIFY(!m_plotter->isRefining());
+
+        auto *plane = static_cast<CartesianCoordinatePlane *>(m_chart->coordinatePlane());
+        plane->setZoomFactors(2.0, 2.0);
+        paintChart();
+        QVERIFY(m_plotter->isRefining());
+        QTRY_VERIFY(!m_plotter->isRefining());
+    }
+
+    void testDataChangeCancelsRefinement()
+    {
+        m_plotter->setProgressiveRendering(true);
+        paintChart();
+        QVERIFY(m_plotter->isRefining());
+        m_model->setStep(0.002);
+        QVERIFY(!m_plotter->isRefining());
+
+        paintChart();
+        QVERIFY(m_plotter->isRefining());
+        QTRY_VERIFY(!m_plotter->isRefining());
+    }
+
+    void testDisabling()
+    {
+        m_plotter->setProgressiveRendering(true);
+        paintChart();
+        QVERIFY(m_plotter->isRefining());
+        m_plotter->setProgressiveRendering(false);
+        QVERIFY(!m_plotter->isRefining());
+
+        paintChart();
+        QVERIFY(!m_plotter->isRefining());
+    }
+
+    void testCompressionPaintsAllRows()
+    {
+        m_plotter->setProgressiveRendering(true);
+        m_plotter->setUseDataCompression(Plotter::SLOPE);
+        paintChart();
+        QVERIFY(!m_plotter->isRefining());
+    }
+
+    void testViewportCulling_data()
+    {
+        QTest::addColumn<qreal>("step");
+        QTest::newRow("increasing keys") << 0.001;
+        QTest::newRow("decreasing keys") << -0.001;
+    }
+
+    void testViewportCulling()
+    {
+        QFETCH(qreal, step);
+        m_model->setStep(step);
+        auto *plane = static_cast<CartesianCoordinatePlane *>(m_chart->coordinatePlane());
+        plane->setZoomFactors(50.0, 1.0);
+        plane->setZoomCenter(QPointF(0.3, 0.5));
+
+        // only painting the visible rows must not change the result
+        QCOMPARE(m_plotter->keyOrder(), Plotter::DetectKeyOrder);
+        const QImage detected = paintChart();
+        m_plotter->setKeyOrder(Plotter::UnsortedKeys);
+        const QImage unsorted = paintChart();
+        QCOMPARE(detected, unsorted);
+        if (step > 0) {
+            m_plotter->setKeyOrder(Plotter::SortedKeys);
+            QCOMPARE(paintChart(), unsorted);
+        }
+    }
+
+private:
+    QImage paintChart()
+    {
+        QImage image(400, 300, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        m_chart->paint(&painter, image.rect());
+        return image;
+    }
+
+    Chart *m_chart;
+    WaveModel *m_model;
+    Plotter *m_plotter;
+};
+
+QTEST_MAIN(TestPlotter)
+
+#include "main.moc"
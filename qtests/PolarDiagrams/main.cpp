@@ -12,6 +12,8 @@
 #include <KDChartGlobal>
 #include <KDChartPolarCoordinatePlane>
 #include <KDChartPolarDiagram>
+#include <QImage>
+#include <QPainter>
 #include <QtTest/QtTest>
 
 #include <TableModel.h>
@@ -67,6 +69,23 @@ private slots:
         QVERIFY(m_polar->showLabelsAtPosition(Position::South) == true);
     }
 
+    void testDataBoundariesFollowModel()
+    {
+        const qreal oldMax = m_polar->dataBoundaries().second.y();
+        const QModelIndex index = m_model->index(0, 0);
+        const QVariant oldValue = m_model->data(index);
+
+        // painting fills the data cache of the diagram, changes must still show up
+        QImage image(300, 300, QImage::Format_ARGB32_Premultiplied);
+        QPainter painter(&image);
+        m_chart->paint(&painter, image.rect());
+
+        m_model->setData(index, oldMax + 100.0);
+        QCOMPARE(m_polar->dataBoundaries().second.y(), oldMax + 100.0);
+        m_model->setData(index, oldValue);
+        QCOMPARE(m_polar->dataBoundaries().second.y(), oldMax);
+    }
+
     void cleanupTestCase()
     {
     }
@@ -0,0 +1,131 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include <KDChartLayoutItems.h>
+#include <KDChartTextAttributes>
+#include <KDChartTextMetricsCache_p.h>
+#include <QFontMetrics>
+#include <QFontMetricsF>
+#include <QImage>
+#include <QPainter>
+#include <QtTest/QtTest>
+
+using namespace KDChart;
+
+class TestTextMetricsCache : public QObject
+{
+    Q_OBJECT
+private slots:
+
+    void init()
+    {
+        TextMetricsCache::clear();
+    }
+
+    void testMeasurements()
+    {
+        QFont font;
+        font.setPointSizeF(13.5);
+        const QString text = QStringLiteral("Revenue\nper quarter");
+
+        QCOMPARE(TextMetricsCache::boundingRect(font, text, TextMetricsCache::SingleLine),
+                 QRectF(QFontMetrics(font).boundingRect(text)));
+        QImage device(10, 10, QImage::Format_ARGB32_Premultiplied);
+        const QRectF multipleLines = QFontMetricsF(font, &device).boundingRect(QRectF(0, 0, 100000, 100000), Qt::AlignLeft | Qt::AlignTop, text);
+        QCOMPARE(TextMetricsCache::boundingRect(font, text, TextMetricsCache::MultipleLines, &device), multipleLines);
+        QCOMPARE(TextMetricsCache::count(), 2);
+
+        // measuring again reuses the measurements
+        TextMetricsCache::boundingRect(font, text, TextMetricsCache::SingleLine);
+        TextMetricsCache::boundingRect(font, text, TextMetricsCache::MultipleLines, &device);
+        QCOMPARE(TextMetricsCache::count(), 2);
+
+        // other fonts, texts and resolutions are measured separately
+        QImage printerLike(10, 10, QImage::Format_ARGB32_Premultiplied);
+        printerLike.setDotsPerMeterX(device.dotsPerMeterX() * 4);
+        printerLike.setDotsPerMeterY(device.dotsPerMeterY() * 4);
+        TextMetricsCache::boundingRect(font, text, TextMetricsCache::MultipleLines, &printerLike);
+        TextMetricsCache::boundingRect(font, QStringLiteral("Revenue"), TextMetricsCache::SingleLine);
+        font.setBold(true);
+        TextMetricsCache::boundingRect(font, text, TextMetricsCache::SingleLine);
+        QCOMPARE(TextMetricsCache::count(), 5);
+    }
+
+    void testHorizontalAdvance()
+    {
+        QFont font;
+        const QString label = QStringLiteral("Dataset 42");
+        QImage device(10, 10, QImage::Format_ARGB32_Premultiplied);
+        QCOMPARE(TextMetricsCache::horizontalAdvance(font, label, &device),
+                 QFontMetricsF(font, &device).horizontalAdvance(label));
+        QCOMPARE(TextMetricsCache::horizontalAdvance(font, label, &device),
+                 QFontMetricsF(font, &device).horizontalAdvance(label));
+        QCOMPARE(TextMetricsCache::count(), 1);
+
+        // the bounding rectangle of the same text is a measurement of its own
+        TextMetricsCache::boundingRect(font, label, TextMetricsCache::SingleLine, &device);
+        QCOMPARE(TextMetricsCache::count(), 2);
+    }
+
+    void testAutoShrink_data()
+    {
+        QTest::addColumn<qreal>("minimalFontSize");
+        QTest::newRow("no minimal font size") << 0.0;
+        QTest::newRow("minimal font size") << 12.0;
+    }
+
+    void testAutoShrink()
+    {
+        QFETCH(qreal, minimalFontSize);
+        QFont font;
+        font.setPointSizeF(30);
+        TextAttributes attributes;
+        attributes.setFont(font);
+        attributes.setFontSize(Measure(30, KDChartEnums::MeasureCalculationModeAbsolute));
+        attributes.setMinimalFontSize(Measure(minimalFontSize, KDChartEnums::MeasureCalculationModeAbsolute));
+        attributes.setAutoShrink(true);
+        const QString text = QStringLiteral("A title too long for its place");
+        const QRect geometry(0, 0, 120, 40);
+        TextLayoutItem item(text, attributes, nullptr, KDChartEnums::MeasureOrientationMinimum, Qt::AlignCenter);
+        item.setGeometry(geometry);
+
+        // the font size found by shrinking 0.5pt at a time
+        qreal expectedSize = 30;
+        while (true) {
+            font.setPointSizeF(expectedSize);
+            const QSize size = QFontMetrics(font).boundingRect(text).size();
+            if (size.width() <= geometry.width() && size.height() <= geometry.height())
+                break;
+            if (minimalFontSize > 0 && expectedSize - 0.5 < minimalFontSize)
+                break;
+            expectedSize -= 0.5;
+        }
+        QVERIFY(expectedSize < 30);
+
+        QImage image(geometry.size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        QPainter painter(&image);
+        item.paint(&painter);
+        painter.end();
+
+        QImage expected(geometry.size(), QImage::Format_ARGB32_Premultiplied);
+        expected.fill(Qt::transparent);
+        painter.begin(&expected);
+        painter.setFont(font);
+        painter.setPen(attributes.pen());
+        painter.drawText(geometry, Qt::AlignCenter, text);
+        painter.end();
+        QCOMPARE(image, expected);
+    }
+};
+
+QTEST_MAIN(TestTextMetricsCache)
+
+#include "main.moc"
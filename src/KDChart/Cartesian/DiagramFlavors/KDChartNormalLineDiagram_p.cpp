@@ -63,6 +63,8 @@ void NormalLineDiagram::paintWithLines(PaintContext *ctx)
     LabelPaintCache lpc;
     LineAttributesInfoList lineList;
 
+    PaintingHelpers::AreaBatch areaBatch(m_private, ctx);
+
     const int step = rev ? -1 : 1;
     const int end = rev ? -1 : columnCount;
     for (int column = rev ? columnCount - 1 : 0; column != end; column += step) {
@@ -91,7 +93,7 @@ void NormalLineDiagram::paintWithLines(PaintContext *ctx)
             qreal areaBoundingValue;
             if (laCell.areaBoundingDataset() != -1) {
                 const CartesianDiagramDataCompressor::CachePosition areaBoundingCachePosition(row, laCell.areaBoundingDataset());
-                areaBoundingValue = compressor().data(areaBoundingCachePosition).value;
+                areaBoundingValue = compressor().value(areaBoundingCachePosition);
             } else {
                 // Use min. y value (i.e. zero line in most cases) if no bounding dataset is set
                 areaBoundingValue = minYValue;
@@ -133,10 +135,8 @@ void NormalLineDiagram::paintWithLines(PaintContext *ctx)
                     lineList.append(LineAttributesInfo(sourceIndex, a, b));
 
                     if (laCell.displayArea()) {
-                        QList<QPolygonF> areas;
-                        areas << (QPolygonF() << a << b << d << c);
-                        PaintingHelpers::paintAreas(m_private, ctx, attributesModel()->mapToSource(lastPoint.index),
-                                                    areas, laCell.transparency());
+                        areaBatch.add(attributesModel()->mapToSource(lastPoint.index), laCell.transparency(),
+                                      a, b, d, c);
                     }
                 }
             }
@@ -146,6 +146,7 @@ void NormalLineDiagram::paintWithLines(PaintContext *ctx)
             lastAreaBoundingValue = areaBoundingValue;
             lastPoint = point;
         }
+        areaBatch.flush();
     }
 
     // paint the lines
@@ -197,7 +198,7 @@ void NormalLineDiagram::paintWithSplines(PaintContext *ctx, qreal tension)
             qreal areaBoundingValue;
             if (laCell.areaBoundingDataset() != -1) {
                 const CartesianDiagramDataCompressor::CachePosition areaBoundingCachePosition(row, laCell.areaBoundingDataset());
-                areaBoundingValue = compressor().data(areaBoundingCachePosition).value;
+                areaBoundingValue = compressor().value(areaBoundingCachePosition);
             } else {
                 // Use min. y value (i.e. zero line in most cases) if no bounding dataset is set
                 areaBoundingValue = minYValue;
@@ -37,7 +37,9 @@ const QPair<QPointF, QPointF> NormalPlotter::calculateDataBoundaries() const
 
 void NormalPlotter::paint(PaintContext *ctx)
 {
-    reverseMapper().clear();
+    // progressive rendering paints the rows in slices
+    if (m_private->paintBegin == 0)
+        reverseMapper().clear();
 
     Q_ASSERT(dynamic_cast<CartesianCoordinatePlane *>(ctx->coordinatePlane()));
     const CartesianCoordinatePlane *const plane = static_cast<CartesianCoordinatePlane *>(ctx->coordinatePlane());
@@ -45,6 +47,7 @@ void NormalPlotter::paint(PaintContext *ctx)
     const int rowCount = compressor().modelDataRows();
 
     LabelPaintCache lpc;
+    PaintingHelpers::AreaBatch areaBatch(m_private, ctx);
 
     if (diagram()->useDataCompression() != Plotter::NONE) {
         for (int dataset = 0; dataset < plotterCompressor().datasetCount(); ++dataset) {
@@ -89,30 +92,36 @@ void NormalPlotter::paint(PaintContext *ctx)
 
                         if (laCell.displayArea()) {
                             // data area
-                            QList<QPolygonF> areas;
-                            QPolygonF polygon;
-                            polygon << a << b << d << c;
-                            areas << polygon;
-                            PaintingHelpers::paintAreas(m_private, ctx,
-                                                        attributesModel()->mapToSource(lastPoint.index),
-                                                        areas, laCell.transparency());
+                            areaBatch.add(attributesModel()->mapToSource(lastPoint.index),
+                                          laCell.transparency(), a, b, d, c);
                         }
                     }
                 }
 
                 lastPoint = point;
             }
+            areaBatch.flush();
             PaintingHelpers::paintElements(m_private, ctx, lpc, lineList);
         }
 
     } else {
         if (colCount == 0 || rowCount == 0)
             return;
+        const int paintBegin = m_private->paintBegin;
+        const int paintEnd = m_private->paintEnd < 0 ? rowCount : qMin(m_private->paintEnd, rowCount);
+        const int paintStride = m_private->paintStride;
         for (int column = 0; column < colCount; ++column) {
             LineAttributesInfoList lineList;
             CartesianDiagramDataCompressor::DataPoint lastPoint;
 
-            for (int row = 0; row < rowCount; ++row) {
+            int visibleBegin;
+            int visibleEnd;
+            m_private->visibleRows(column, plane->visibleDataRange(), &visibleBegin, &visibleEnd);
+            const int end = qMin(paintEnd, visibleEnd);
+
+            // a slice starts at the last row of the previous one, to connect to it
+            const int begin = visibleBegin > paintBegin ? visibleBegin : qMax(0, paintBegin - 1);
+            for (int row = begin; row < end; row += paintStride) {
                 const CartesianDiagramDataCompressor::CachePosition position(row, column);
                 const CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
 
@@ -132,6 +141,11 @@ void NormalPlotter::paint(PaintContext *ctx)
                     }
                 }
 
+                if (row < paintBegin) {
+                    lastPoint = point;
+                    continue;
+                }
+
                 // data area painting: a and b are prev / current data points, c and d are on the null line
                 const QPointF b(plane->translate(QPointF(point.key, point.value)));
 
@@ -152,19 +166,15 @@ void NormalPlotter::paint(PaintContext *ctx)
 
                         if (laCell.displayArea()) {
                             // data area
-                            QList<QPolygonF> areas;
-                            QPolygonF polygon;
-                            polygon << a << b << d << c;
-                            areas << polygon;
-                            PaintingHelpers::paintAreas(m_private, ctx,
-                                                        attributesModel()->mapToSource(lastPoint.index),
-                                                        areas, laCell.transparency());
+                            areaBatch.add(attributesModel()->mapToSource(lastPoint.index),
+                                          laCell.transparency(), a, b, d, c);
                         }
                     }
                 }
 
                 lastPoint = point;
             }
+            areaBatch.flush();
             PaintingHelpers::paintElements(m_private, ctx, lpc, lineList);
         }
     }
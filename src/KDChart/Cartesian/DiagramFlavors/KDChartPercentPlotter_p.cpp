@@ -92,6 +92,7 @@ void PercentPlotter::paint(PaintContext *ctx)
         return;
 
     LabelPaintCache lpc;
+    PaintingHelpers::AreaBatch areaBatch(m_private, ctx);
 
     // this map contains the y-values to each x-value
     QMap<qreal, QVector<QPair<Value, QModelIndex>>> diagramValues;
@@ -209,21 +210,16 @@ void PercentPlotter::paint(PaintContext *ctx)
             laCell = diagram()->lineAttributes(sourceIndex);
             // add data point labels:
             const PositionPoints pts = PositionPoints(b, a, d, c);
-            // if necessary, add the area to the area list:
-            QList<QPolygonF> areas;
-            if (laCell.displayArea()) {
-                QPolygonF polygon;
-                polygon << a << b << d << c;
-                areas << polygon;
-            }
             // add the pieces to painting if this is not hidden:
             if (!point.hidden /*&& !ISNAN( lastPoint.key ) && !ISNAN( lastPoint.value ) */) {
                 m_private->addLabel(&lpc, sourceIndex, nullptr, pts, Position::NorthWest,
                                     Position::NorthWest, value);
                 if (!ISNAN(lastPoint.key) && !ISNAN(lastPoint.value)) {
-                    PaintingHelpers::paintAreas(m_private, ctx,
-                                                attributesModel()->mapToSource(lastPoint.index),
-                                                areas, laCell.transparency());
+                    // if necessary, add the area to the area list:
+                    if (laCell.displayArea()) {
+                        areaBatch.add(attributesModel()->mapToSource(lastPoint.index),
+                                      laCell.transparency(), a, b, d, c);
+                    }
                     lineList.append(LineAttributesInfo(sourceIndex, a, b));
                 }
             }
@@ -234,6 +230,7 @@ void PercentPlotter::paint(PaintContext *ctx)
             lastExtraY = extraY;
             lastValue = value;
         }
+        areaBatch.flush();
         PaintingHelpers::paintElements(m_private, ctx, lpc, lineList);
     }
 }
@@ -49,15 +49,15 @@ const QPair<QPointF, QPointF> StackedLineDiagram::calculateDataBoundaries() cons
         qreal negativeStackedValues = 0.0;
         for (int col = datasetDimension() - 1; col < colCount; col += datasetDimension()) {
             const CartesianDiagramDataCompressor::CachePosition position(row, col);
-            const CartesianDiagramDataCompressor::DataPoint point = compressor().data(position);
+            const qreal value = compressor().value(position);
 
-            if (ISNAN(point.value))
+            if (ISNAN(value))
                 continue;
 
-            if (point.value >= 0.0)
-                stackedValues += point.value;
+            if (value >= 0.0)
+                stackedValues += value;
             else
-                negativeStackedValues += point.value;
+                negativeStackedValues += value;
         }
 
         if (bStarting) {
@@ -59,6 +59,13 @@ void AbstractCartesianDiagram::init()
             &d->compressor, &CartesianDiagramDataCompressor::slotDiagramLayoutChanged);
     connect(this, &AbstractCartesianDiagram::attributesModelAboutToChange,
             this, &AbstractCartesianDiagram::connectAttributesModel);
+    connect(&d->compressor, &CartesianDiagramDataCompressor::preparationProgress,
+            this, &AbstractCartesianDiagram::dataPreparationProgress);
+    connect(&d->compressor, &CartesianDiagramDataCompressor::preparationFinished, this, [this]() {
+        setDataBoundariesDirty();
+        Q_EMIT modelDataChanged();
+        Q_EMIT dataPreparationFinished();
+    });
 
     if (d->plane) {
         connect(d->plane, &AbstractCoordinatePlane::viewportCoordinateSystemChanged,
@@ -66,6 +73,21 @@ void AbstractCartesianDiagram::init()
     }
 }
 
+void AbstractCartesianDiagram::setAsynchronousDataPreparation(bool enabled)
+{
+    d->compressor.setAsynchronousPreparation(enabled);
+}
+
+bool AbstractCartesianDiagram::asynchronousDataPreparation() const
+{
+    return d->compressor.asynchronousPreparation();
+}
+
+bool AbstractCartesianDiagram::isPreparingData() const
+{
+    return d->compressor.isPreparing();
+}
+
 void AbstractCartesianDiagram::addAxis(CartesianAxis *axis)
 {
     if (!d->axesList.contains(axis)) {
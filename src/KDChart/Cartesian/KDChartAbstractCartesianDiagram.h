@@ -99,6 +99,30 @@ public:
      */
     virtual QPointF referenceDiagramOffset() const;
 
+    /**
+     * Sets whether the data of large models is compressed on a worker thread instead of
+     * while painting. This is off by default.
+     *
+     * It applies to the models of KDChart::Widget, which keep their values in memory in a
+     * way that can be read from another thread; other models are always read while
+     * painting. While the data is prepared, the diagram shows a sample of it, and
+     * dataPreparationProgress() is emitted. Once dataPreparationFinished() is emitted, the
+     * diagram shows the compressed data.
+     *
+     * \sa isPreparingData()
+     */
+    void setAsynchronousDataPreparation(bool enabled);
+    /**
+     * @return whether the data of large models is compressed on a worker thread
+     * \sa setAsynchronousDataPreparation
+     */
+    bool asynchronousDataPreparation() const;
+    /**
+     * @return true while the data is being compressed on a worker thread
+     * \sa setAsynchronousDataPreparation
+     */
+    bool isPreparingData() const;
+
     /* reimp */
     void setModel(QAbstractItemModel *model) override;
     /* reimp */
@@ -106,6 +130,12 @@ public:
     /* reimp */
     void setAttributesModel(AttributesModel *amodel) override;
 
+Q_SIGNALS:
+    /** Emitted while the data is prepared asynchronously, with @p percent from 0 to 99. */
+    void dataPreparationProgress(int percent);
+    /** Emitted when asynchronously prepared data has been swapped in. */
+    void dataPreparationFinished();
+
 protected Q_SLOTS:
     void connectAttributesModel(AttributesModel *);
 
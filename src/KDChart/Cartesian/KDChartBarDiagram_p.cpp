@@ -12,6 +12,7 @@
 #include "KDChartBarDiagram.h"
 
 #include "KDChartDataValueAttributes.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 
 using namespace KDChart;
@@ -103,6 +104,7 @@ void BarDiagram::BarDiagramType::paintBars(PaintContext *ctx, const QModelIndex
     if (bar.height() != 0) {
         reverseMapper().addRect(index.row(), index.column(), bar);
         ctx->painter()->drawRect(bar);
+        PaintProfiler::count(PaintProfile::RectCounter);
     }
 }
 
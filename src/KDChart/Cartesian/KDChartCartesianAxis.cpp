@@ -27,6 +27,7 @@
 #include "KDChartLayoutItems.h"
 #include "KDChartLineDiagram.h"
 #include "KDChartPaintContext.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartPrintingParameters.h"
 #include "KDChartStockDiagram.h"
@@ -70,6 +71,7 @@ TickIterator::TickIterator(CartesianAxis *a, CartesianCoordinatePlane *plane, ui
     : m_axis(a)
     , m_majorThinningFactor(majorThinningFactor)
     , m_majorLabelCount(0)
+    , m_thinningIndex(-1)
     , m_type(NoTick)
 {
     // deal with the things that are specific to axes (like annotations), before the generic init().
@@ -158,6 +160,7 @@ TickIterator::TickIterator(bool isY, const DataDimension &dimension, bool useAnn
     , m_majorLabelCount(0)
     , m_customTickIndex(-1)
     , m_manualLabelIndex(-1)
+    , m_thinningIndex(-1)
     , m_type(NoTick)
     , m_customTick(std::numeric_limits<qreal>::infinity())
 {
@@ -261,6 +264,7 @@ void TickIterator::computeMajorTickLabel(int decimalPlaces)
         m_type = m_majorThinningFactor > 1 ? MajorTickManualShort : MajorTickManualLong;
     } else {
         // if m_axis is null, we are dealing with grid lines. grid lines never need labels.
+        m_thinningIndex = m_axis ? int(m_majorLabelCount) : -1;
         if (m_axis && (m_majorLabelCount++ % m_majorThinningFactor) == 0) {
             QMap<qreal, QString>::ConstIterator it =
                 m_dataHeaderLabels.lowerBound(slightlyLessThan(m_position));
@@ -289,6 +293,7 @@ void TickIterator::operator++()
         return;
     }
     const qreal inf = std::numeric_limits<qreal>::infinity();
+    m_thinningIndex = -1;
 
     // make sure to find the next tick at a value strictly greater than m_position
 
@@ -408,7 +413,14 @@ bool CartesianAxis::compare(const CartesianAxis *other) const
 
 void CartesianAxis::coordinateSystemChanged()
 {
-    layoutPlanes();
+    // new data needs new tick labels, but the planes are only laid out again if they
+    // change the size of the axis; the chart compares the sizes before painting
+    d->invalidateTickLabels();
+    setCachedSizeDirty();
+    if (d->diagram() && d->diagram()->coordinatePlane()) {
+        d->diagram()->coordinatePlane()->setGridNeedsRecalculate();
+    }
+    update();
 }
 
 void CartesianAxis::setTitleText(const QString &text)
@@ -479,6 +491,7 @@ const
 
 void CartesianAxis::layoutPlanes()
 {
+    d->invalidateTickLabels();
     if (!d->diagram() || !d->diagram()->coordinatePlane()) {
         return;
     }
@@ -638,8 +651,296 @@ bool CartesianAxis::Private::isVertical() const
     return axis()->isAbscissa() == AbstractDiagram::Private::get(diagram())->isTransposed();
 }
 
+// the space between the end of a tick mark and its label
+static qreal tickLabelMargin(const TextLayoutItem &tickLabel, const RulerAttributes &rulerAttr)
+{
+    qreal labelMargin = rulerAttr.labelMargin();
+    if (labelMargin < 0) {
+        labelMargin = QFontMetricsF(tickLabel.realFont()).height() * 0.5;
+    }
+    return labelMargin - tickLabel.marginWidth(); // make up for the margin that's already there
+}
+
+QLineF CartesianAxis::Private::tickLine(CartesianCoordinatePlane *plane, qreal drawPos, TickIterator::TickType type,
+                                        qreal transversePosition, qreal transverseScreenSpaceShift) const
+{
+    XySwitch geoXy(isVertical());
+    const Position axisPosition = axis()->position();
+
+    QPointF onAxis = plane->translate(geoXy(QPointF(drawPos, transversePosition),
+                                            QPointF(transversePosition, drawPos)));
+    geoXy.lvalue(onAxis.ry(), onAxis.rx()) += transverseScreenSpaceShift;
+    const bool isOutwardsPositive = axisPosition == Bottom || axisPosition == Right;
+
+    QPointF tickEnd = onAxis;
+    qreal tickLen = type == TickIterator::CustomTick ? customTickLength : axis()->tickLength(type == TickIterator::MinorTick);
+    geoXy.lvalue(tickEnd.ry(), tickEnd.rx()) += isOutwardsPositive ? tickLen : -tickLen;
+
+    // those adjustments are required to paint the ticks exactly on the axis and of the right length
+    if (axisPosition == Top) {
+        onAxis.ry() += 1;
+        tickEnd.ry() += 1;
+    } else if (axisPosition == Left) {
+        tickEnd.rx() += 1;
+    }
+    return QLineF(onAxis, tickEnd);
+}
+
+QPointF CartesianAxis::Private::tickLabelPosition(const QPointF &tickEnd, const QSize &size, const QPolygon &labelPoly,
+                                                  int rotation, qreal labelMargin) const
+{
+    Q_ASSERT(labelPoly.count() == 4);
+
+    // for alignment, find the label polygon edge "most parallel" and closest to the axis
+
+    int axisAngle = 0;
+    switch (axis()->position()) {
+    case Bottom:
+        axisAngle = 0;
+        break;
+    case Top:
+        axisAngle = 180;
+        break;
+    case Right:
+        axisAngle = 270;
+        break;
+    case Left:
+        axisAngle = 90;
+        break;
+    default:
+        Q_ASSERT(false);
+    }
+    // the left axis is not actually pointing down and the top axis not actually pointing
+    // left, but their corresponding closest edges of a rectangular unrotated label polygon are.
+
+    int relAngle = axisAngle - rotation + 45;
+    if (relAngle < 0) {
+        relAngle += 360;
+    }
+    int polyCorner1 = relAngle / 90;
+    QPoint p1 = labelPoly.at(polyCorner1);
+    QPoint p2 = labelPoly.at(polyCorner1 == 3 ? 0 : (polyCorner1 + 1));
+
+    QPointF labelPos = tickEnd;
+
+    switch (axis()->position()) {
+    case Left:
+        labelPos += QPointF(-size.width() - labelMargin,
+                            -0.45 * size.height() - 0.5 * (p1.y() + p2.y()));
+        break;
+    case Right:
+        labelPos += QPointF(labelMargin,
+                            -0.45 * size.height() - 0.5 * (p1.y() + p2.y()));
+        break;
+    case Top:
+        labelPos += QPointF(-0.45 * size.width() - 0.5 * (p1.x() + p2.x()),
+                            -size.height() - labelMargin);
+        break;
+    case Bottom:
+        labelPos += QPointF(-0.45 * size.width() - 0.5 * (p1.x() + p2.x()),
+                            labelMargin);
+        break;
+    }
+    return labelPos;
+}
+
+void CartesianAxis::Private::measureTickLabels(TickLabelMeasurements *measurements, CartesianCoordinatePlane *plane,
+                                               bool centerTicks, const TextAttributes &ta, int majorThinningFactor) const
+{
+    XySwitch geoXy(isVertical());
+    TextLayoutItem tickLabel(QString(), ta, plane->parent(),
+                             KDChartEnums::MeasureOrientationMinimum, Qt::AlignLeft);
+    const RulerAttributes rulerAttr = mAxis->rulerAttributes();
+
+    measurements->textAttributes = ta;
+    measurements->font = tickLabel.realFont();
+    measurements->isVertical = isVertical();
+    measurements->centerTicks = centerTicks;
+    measurements->majorThinningFactor = majorThinningFactor;
+    measurements->labels.clear();
+    measurements->thinnableLabels.clear();
+    measurements->unlabeledTickLength = 0.0;
+
+    bool showFirstTick = rulerAttr.showFirstTick();
+    for (TickIterator it(axis(), plane, majorThinningFactor, centerTicks); !it.isAtEnd(); ++it) {
+        if (!showFirstTick) {
+            showFirstTick = true;
+            continue;
+        }
+
+        QString text = it.text();
+        if (text.isEmpty()) {
+            const qreal tickLength = it.type() == TickIterator::CustomTick ? customTickLength : axis()->tickLength(it.type() == TickIterator::MinorTick);
+            measurements->unlabeledTickLength = qMax(measurements->unlabeledTickLength, tickLength);
+            continue;
+        }
+
+        if (it.type() == TickIterator::MajorTick) {
+            // add unit prefixes and suffixes, then customize
+            text = customizedLabelText(text, geoXy(Qt::Horizontal, Qt::Vertical), it.position());
+        } else if (it.type() == TickIterator::MajorTickHeaderDataLabel) {
+            // unit prefixes and suffixes have already been added in this case - only customize
+            text = axis()->customizedLabel(text);
+        }
+        tickLabel.setText(text);
+
+        TickLabelMeasurements::Label label;
+        label.position = it.position() + (centerTicks ? 0.5 : 0.);
+        label.type = it.type();
+        label.thinningIndex = it.thinningIndex();
+        label.margin = tickLabelMargin(tickLabel, rulerAttr);
+        label.size = tickLabel.sizeHint();
+        label.boundingPolygon = tickLabel.boundingPolygon();
+
+        // these are collision tested no matter how the labels are rotated
+        if (label.type == TickIterator::MajorTick || label.type == TickIterator::MajorTickHeaderDataLabel) {
+            while (measurements->thinnableLabels.size() <= label.thinningIndex) {
+                measurements->thinnableLabels.append(-1);
+            }
+            measurements->thinnableLabels[label.thinningIndex] = measurements->labels.size();
+        }
+        measurements->labels.append(label);
+    }
+    measurements->isValid = true;
+}
+
+const TickLabelMeasurements &CartesianAxis::Private::tickLabelMeasurements(CartesianCoordinatePlane *plane,
+                                                                           bool centerTicks) const
+{
+    XySwitch xy(isVertical());
+    const DataDimension dimension = xy(plane->gridDimensionsList().first(), plane->gridDimensionsList().last());
+    const GridAttributes gridAttributes = plane->gridAttributes(xy(Qt::Horizontal, Qt::Vertical));
+    const unsigned int autoAdjustRange = xy(plane->autoAdjustHorizontalRangeToData(),
+                                            plane->autoAdjustVerticalRangeToData());
+    const TextAttributes ta = mAxis->textAttributes();
+    // the font depends on the size of the reference area if the font size is relative
+    const TextLayoutItem fontReference(QString(), ta, plane->parent(),
+                                       KDChartEnums::MeasureOrientationMinimum, Qt::AlignLeft);
+
+    TickLabelMeasurements &m = measuredTickLabels;
+    const bool isCached = m.isValid && m.dimension == dimension && m.gridAttributes == gridAttributes
+        && m.autoAdjustRange == autoAdjustRange && m.textAttributes == ta && m.font == fontReference.realFont()
+        && m.isVertical == isVertical() && m.centerTicks == centerTicks;
+    PaintProfiler::countCacheLookup(isCached);
+    if (!isCached) {
+        m.dimension = dimension;
+        m.gridAttributes = gridAttributes;
+        m.autoAdjustRange = autoAdjustRange;
+        measureTickLabels(&m, plane, centerTicks, ta, 1);
+        labelLayout.isValid = false;
+    }
+    return m;
+}
+
+int CartesianAxis::Private::firstTickLabelCollision(const TickLabelMeasurements &measurements, CartesianCoordinatePlane *plane,
+                                                    const TextAttributes &ta, int thinningFactor,
+                                                    qreal transversePosition, qreal transverseScreenSpaceShift) const
+{
+    const bool canRotate = ta.autoRotate() && ta.rotation() != (isVertical() ? 270 : 0);
+    const bool hasShorterLabels = !mAxis->labels().isEmpty() && mAxis->shortLabels().count() == mAxis->labels().count();
+
+    bool isFirstLabel = true;
+    QRect prevRect;
+    QPolygon prevPolygon;
+    // collision check a label against the previous one
+    auto collides = [&](const TickLabelMeasurements::Label &label) {
+        const QLineF tick = tickLine(plane, label.position, label.type, transversePosition, transverseScreenSpaceShift);
+        const QPointF labelPos = tickLabelPosition(tick.p2(), label.size, label.boundingPolygon, ta.rotation(), label.margin);
+        const QPolygon polygon = label.boundingPolygon.translated(labelPos.toPoint());
+        const QRect rect = polygon.boundingRect();
+        // comparing the bounding rects first is much cheaper than comparing regions
+        const bool ret = !isFirstLabel && rect.intersects(prevRect) && QRegion(polygon).intersects(QRegion(prevPolygon));
+        isFirstLabel = false;
+        prevRect = rect;
+        prevPolygon = polygon;
+        return ret;
+    };
+
+    if (!canRotate && mAxis->labels().isEmpty()) {
+        // only labels subject to label thinning are tested, so we can skip right to the ones that are shown
+        for (int i = 0; i < measurements.thinnableLabels.size(); i += thinningFactor) {
+            const int label = measurements.thinnableLabels.at(i);
+            if (label >= 0 && collides(measurements.labels.at(label))) {
+                return label;
+            }
+        }
+        return -1;
+    }
+
+    // like in the old code, we don't shorten or decimate labels if they are already the
+    // manual short type, or if they are the manual long type and on the vertical axis
+    // ### they can still collide though, especially when they're rotated!
+    for (int i = 0; i < measurements.labels.size(); i++) {
+        const TickLabelMeasurements::Label &label = measurements.labels.at(i);
+        if (label.thinningIndex >= 0 && label.thinningIndex % thinningFactor != 0) {
+            continue; // thinned out
+        }
+        const bool canShortenLabels = !isVertical() && label.type == TickIterator::MajorTickManualLong && hasShorterLabels;
+        if (label.type == TickIterator::MajorTick || label.type == TickIterator::MajorTickHeaderDataLabel
+            || canShortenLabels || canRotate) {
+            if (collides(label)) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+const TickLabelLayout &CartesianAxis::Private::tickLabelLayout(CartesianCoordinatePlane *plane, bool centerTicks,
+                                                               const QLineF &axisLine, qreal transversePosition,
+                                                               qreal transverseScreenSpaceShift) const
+{
+    const TickLabelMeasurements &measurements = tickLabelMeasurements(plane, centerTicks);
+    if (labelLayout.isValid && labelLayout.axisLine == axisLine) {
+        return labelLayout;
+    }
+
+    const int spaceSavingRotation = isVertical() ? 270 : 0;
+    const bool hasShorterLabels = !mAxis->labels().isEmpty() && mAxis->shortLabels().count() == mAxis->labels().count();
+
+    TextAttributes ta = measurements.textAttributes;
+    int thinningFactor = 1;
+    TickLabelMeasurements remeasured;
+    const TickLabelMeasurements *current = &measurements;
+    for (;;) {
+        const int collision = firstTickLabelCollision(*current, plane, ta, thinningFactor,
+                                                      transversePosition, transverseScreenSpaceShift);
+        if (collision < 0) {
+            break;
+        }
+        // to make room, we try in order: shorten, rotate, decimate
+        const TickIterator::TickType type = current->labels.at(collision).type;
+        const bool canRotate = ta.autoRotate() && ta.rotation() != spaceSavingRotation;
+        const bool canShortenLabels = !isVertical() && type == TickIterator::MajorTickManualLong && hasShorterLabels;
+        if (canRotate && !canShortenLabels) {
+            ta.setRotation(spaceSavingRotation);
+        } else {
+            thinningFactor++;
+            // decimating calculated labels just hides some of them, so the measurements stay valid
+            if (mAxis->labels().isEmpty() && thinningFactor % current->majorThinningFactor == 0) {
+                continue;
+            }
+        }
+        measureTickLabels(&remeasured, plane, centerTicks, ta, thinningFactor);
+        current = &remeasured;
+    }
+
+    labelLayout.isValid = true;
+    labelLayout.axisLine = axisLine;
+    labelLayout.thinningFactor = thinningFactor;
+    labelLayout.textAttributes = ta;
+    return labelLayout;
+}
+
+void CartesianAxis::Private::invalidateTickLabels()
+{
+    measuredTickLabels.isValid = false;
+    labelLayout.isValid = false;
+}
+
 void CartesianAxis::paintCtx(PaintContext *context)
 {
+    PaintProfiler::Scope scope(PaintProfile::AxisPhase);
     Q_ASSERT_X(d->diagram(), "CartesianAxis::paint",
                "Function call not allowed: The axis is not assigned to any diagram.");
 
@@ -665,6 +966,7 @@ void CartesianAxis::paintCtx(PaintContext *context)
     // the next one describes an additional shift in screen space; it is unfortunately required to
     // make axis sharing work, which uses the areaGeometry() to override the position of the axis.
     qreal transverseScreenSpaceShift = signalingNaN;
+    QLineF axisLine;
     {
         // determine the unadulterated position in screen space
 
@@ -715,6 +1017,7 @@ void CartesianAxis::paintCtx(PaintContext *context)
 
         geoXy.lvalue(transStart.ry(), transStart.rx()) += transverseScreenSpaceShift;
         geoXy.lvalue(transEnd.ry(), transEnd.rx()) += transverseScreenSpaceShift;
+        axisLine = QLineF(transStart, transEnd);
 
         if (rulerAttributes().showRulerLine()) {
             bool clipSaved = context->painter()->hasClipping();
@@ -729,183 +1032,62 @@ void CartesianAxis::paintCtx(PaintContext *context)
     TextAttributes labelTA = textAttributes();
     RulerAttributes rulerAttr = rulerAttributes();
 
-    int labelThinningFactor = 1;
     // TODO: label thinning also when grid line distance < 4 pixels, not only when labels collide
-    auto *tickLabel = new TextLayoutItem(QString(), labelTA, plane->parent(),
-                                         KDChartEnums::MeasureOrientationMinimum, Qt::AlignLeft);
-    auto *prevTickLabel = new TextLayoutItem(QString(), labelTA, plane->parent(),
-                                             KDChartEnums::MeasureOrientationMinimum, Qt::AlignLeft);
-    QPointF prevTickLabelPos;
-    enum
-    {
-        Layout = 0,
-        Painting,
-        Done
-    };
-    for (int step = labelTA.isVisible() ? Layout : Painting; step < Done; step++) {
-        bool skipFirstTick = !rulerAttr.showFirstTick();
-        bool isFirstLabel = true;
-        for (TickIterator it(this, plane, labelThinningFactor, centerTicks); !it.isAtEnd(); ++it) {
-            if (skipFirstTick) {
-                skipFirstTick = false;
-                continue;
-            }
-
-            const qreal drawPos = it.position() + (centerTicks ? 0.5 : 0.);
-            QPointF onAxis = plane->translate(geoXy(QPointF(drawPos, transversePosition),
-                                                    QPointF(transversePosition, drawPos)));
-            geoXy.lvalue(onAxis.ry(), onAxis.rx()) += transverseScreenSpaceShift;
-            const bool isOutwardsPositive = position() == Bottom || position() == Right;
-
-            // paint the tick mark
-
-            QPointF tickEnd = onAxis;
-            qreal tickLen = it.type() == TickIterator::CustomTick ? d->customTickLength : tickLength(it.type() == TickIterator::MinorTick);
-            geoXy.lvalue(tickEnd.ry(), tickEnd.rx()) += isOutwardsPositive ? tickLen : -tickLen;
-
-            // those adjustments are required to paint the ticks exactly on the axis and of the right length
-            if (position() == Top) {
-                onAxis.ry() += 1;
-                tickEnd.ry() += 1;
-            } else if (position() == Left) {
-                tickEnd.rx() += 1;
-            }
-
-            if (step == Painting) {
-                painter->save();
-                if (rulerAttr.hasTickMarkPenAt(it.position())) {
-                    painter->setPen(rulerAttr.tickMarkPen(it.position()));
-                } else {
-                    painter->setPen(it.type() == TickIterator::MinorTick ? rulerAttr.minorTickMarkPen()
-                                                                         : rulerAttr.majorTickMarkPen());
-                }
-                painter->drawLine(onAxis, tickEnd);
-                painter->restore();
-            }
-
-            if (it.text().isEmpty() || !labelTA.isVisible()) {
-                // the following code in the loop is only label painting, so skip it
-                continue;
-            }
-
-            // paint the label
-
-            QString text = it.text();
-            if (it.type() == TickIterator::MajorTick) {
-                // add unit prefixes and suffixes, then customize
-                text = d->customizedLabelText(text, geoXy(Qt::Horizontal, Qt::Vertical), it.position());
-            } else if (it.type() == TickIterator::MajorTickHeaderDataLabel) {
-                // unit prefixes and suffixes have already been added in this case - only customize
-                text = customizedLabel(text);
-            }
-
-            tickLabel->setText(text);
-            QSizeF size = QSizeF(tickLabel->sizeHint());
-            QPolygon labelPoly = tickLabel->boundingPolygon();
-            Q_ASSERT(labelPoly.count() == 4);
-
-            // for alignment, find the label polygon edge "most parallel" and closest to the axis
-
-            int axisAngle = 0;
-            switch (position()) {
-            case Bottom:
-                axisAngle = 0;
-                break;
-            case Top:
-                axisAngle = 180;
-                break;
-            case Right:
-                axisAngle = 270;
-                break;
-            case Left:
-                axisAngle = 90;
-                break;
-            default:
-                Q_ASSERT(false);
-            }
-            // the left axis is not actually pointing down and the top axis not actually pointing
-            // left, but their corresponding closest edges of a rectangular unrotated label polygon are.
+    int labelThinningFactor = 1;
+    if (labelTA.isVisible()) {
+        const TickLabelLayout &labelLayout = d->tickLabelLayout(plane, centerTicks, axisLine, transversePosition,
+                                                                transverseScreenSpaceShift);
+        labelThinningFactor = labelLayout.thinningFactor;
+        labelTA = labelLayout.textAttributes;
+    }
+    TextLayoutItem tickLabel(QString(), labelTA, plane->parent(),
+                             KDChartEnums::MeasureOrientationMinimum, Qt::AlignLeft);
 
-            int relAngle = axisAngle - labelTA.rotation() + 45;
-            if (relAngle < 0) {
-                relAngle += 360;
-            }
-            int polyCorner1 = relAngle / 90;
-            QPoint p1 = labelPoly.at(polyCorner1);
-            QPoint p2 = labelPoly.at(polyCorner1 == 3 ? 0 : (polyCorner1 + 1));
+    bool skipFirstTick = !rulerAttr.showFirstTick();
+    for (TickIterator it(this, plane, labelThinningFactor, centerTicks); !it.isAtEnd(); ++it) {
+        if (skipFirstTick) {
+            skipFirstTick = false;
+            continue;
+        }
 
-            QPointF labelPos = tickEnd;
+        // paint the tick mark
 
-            qreal labelMargin = rulerAttr.labelMargin();
-            if (labelMargin < 0) {
-                labelMargin = QFontMetricsF(tickLabel->realFont()).height() * 0.5;
-            }
-            labelMargin -= tickLabel->marginWidth(); // make up for the margin that's already there
+        const qreal drawPos = it.position() + (centerTicks ? 0.5 : 0.);
+        const QLineF tick = d->tickLine(plane, drawPos, it.type(), transversePosition, transverseScreenSpaceShift);
 
-            switch (position()) {
-            case Left:
-                labelPos += QPointF(-size.width() - labelMargin,
-                                    -0.45 * size.height() - 0.5 * (p1.y() + p2.y()));
-                break;
-            case Right:
-                labelPos += QPointF(labelMargin,
-                                    -0.45 * size.height() - 0.5 * (p1.y() + p2.y()));
-                break;
-            case Top:
-                labelPos += QPointF(-0.45 * size.width() - 0.5 * (p1.x() + p2.x()),
-                                    -size.height() - labelMargin);
-                break;
-            case Bottom:
-                labelPos += QPointF(-0.45 * size.width() - 0.5 * (p1.x() + p2.x()),
-                                    labelMargin);
-                break;
-            }
+        painter->save();
+        if (rulerAttr.hasTickMarkPenAt(it.position())) {
+            painter->setPen(rulerAttr.tickMarkPen(it.position()));
+        } else {
+            painter->setPen(it.type() == TickIterator::MinorTick ? rulerAttr.minorTickMarkPen()
+                                                                 : rulerAttr.majorTickMarkPen());
+        }
+        painter->drawLine(tick);
+        painter->restore();
 
-            tickLabel->setGeometry(QRect(labelPos.toPoint(), size.toSize()));
+        if (it.text().isEmpty() || !labelTA.isVisible()) {
+            // the following code in the loop is only label painting, so skip it
+            continue;
+        }
 
-            if (step == Painting) {
-                tickLabel->paint(painter);
-            }
+        // paint the label
 
-            // collision check the current label against the previous one
-
-            // like in the old code, we don't shorten or decimate labels if they are already the
-            // manual short type, or if they are the manual long type and on the vertical axis
-            // ### they can still collide though, especially when they're rotated!
-            if (step == Layout) {
-                int spaceSavingRotation = geoXy(270, 0);
-                bool canRotate = labelTA.autoRotate() && labelTA.rotation() != spaceSavingRotation;
-                const bool canShortenLabels = !geoXy.isY && it.type() == TickIterator::MajorTickManualLong && it.hasShorterLabels();
-                bool collides = false;
-                if (it.type() == TickIterator::MajorTick || it.type() == TickIterator::MajorTickHeaderDataLabel
-                    || canShortenLabels || canRotate) {
-                    if (isFirstLabel) {
-                        isFirstLabel = false;
-                    } else {
-                        collides = tickLabel->intersects(*prevTickLabel, labelPos, prevTickLabelPos);
-                        qSwap(prevTickLabel, tickLabel);
-                    }
-                    prevTickLabelPos = labelPos;
-                }
-                if (collides) {
-                    // to make room, we try in order: shorten, rotate, decimate
-                    if (canRotate && !canShortenLabels) {
-                        labelTA.setRotation(spaceSavingRotation);
-                        // tickLabel will be reused in the next round
-                        tickLabel->setTextAttributes(labelTA);
-                    } else {
-                        labelThinningFactor++;
-                    }
-                    step--; // relayout
-                    break;
-                }
-            }
+        QString text = it.text();
+        if (it.type() == TickIterator::MajorTick) {
+            // add unit prefixes and suffixes, then customize
+            text = d->customizedLabelText(text, geoXy(Qt::Horizontal, Qt::Vertical), it.position());
+        } else if (it.type() == TickIterator::MajorTickHeaderDataLabel) {
+            // unit prefixes and suffixes have already been added in this case - only customize
+            text = customizedLabel(text);
         }
+
+        tickLabel.setText(text);
+        const QSize size = tickLabel.sizeHint();
+        const QPointF labelPos = d->tickLabelPosition(tick.p2(), size, tickLabel.boundingPolygon(),
+                                                      labelTA.rotation(), tickLabelMargin(tickLabel, rulerAttr));
+        tickLabel.setGeometry(QRect(labelPos.toPoint(), size));
+        tickLabel.paint(painter);
     }
-    delete tickLabel;
-    tickLabel = nullptr;
-    delete prevTickLabel;
-    prevTickLabel = nullptr;
 
     if (!titleText().isEmpty()) {
         d->drawTitleText(painter, plane, geometry());
@@ -984,51 +1166,26 @@ QSize CartesianAxis::Private::calculateMaximumSize() const
         qreal lowestLabelLongitudinalSize = signalingNaN;
         qreal highestLabelLongitudinalSize = signalingNaN;
 
-        TextLayoutItem tickLabel(QString(), mAxis->textAttributes(), refArea,
-                                 KDChartEnums::MeasureOrientationMinimum, Qt::AlignLeft);
-        const RulerAttributes rulerAttr = mAxis->rulerAttributes();
-
-        bool showFirstTick = rulerAttr.showFirstTick();
-        for (TickIterator it(axis(), plane, 1, centerTicks); !it.isAtEnd(); ++it) {
-            const qreal drawPos = it.position() + (centerTicks ? 0.5 : 0.);
-            if (!showFirstTick) {
-                showFirstTick = true;
-                continue;
-            }
-
-            qreal labelSizeTransverse = 0.0;
-            qreal labelMargin = 0.0;
-            QString text = it.text();
-            if (!text.isEmpty()) {
-                QPointF labelPosition = plane->translate(QPointF(geoXy(drawPos, ( qreal )1.0),
-                                                                 geoXy(( qreal )1.0, drawPos)));
-                highestLabelPosition = geoXy(labelPosition.x(), labelPosition.y());
-
-                if (it.type() == TickIterator::MajorTick) {
-                    // add unit prefixes and suffixes, then customize
-                    text = customizedLabelText(text, geoXy(Qt::Horizontal, Qt::Vertical), it.position());
-                } else if (it.type() == TickIterator::MajorTickHeaderDataLabel) {
-                    // unit prefixes and suffixes have already been added in this case - only customize
-                    text = axis()->customizedLabel(text);
-                }
-                tickLabel.setText(text);
-
-                QSize sz = tickLabel.sizeHint();
-                highestLabelLongitudinalSize = geoXy(sz.width(), sz.height());
-                if (ISNAN(lowestLabelLongitudinalSize)) {
-                    lowestLabelLongitudinalSize = highestLabelLongitudinalSize;
-                    lowestLabelPosition = highestLabelPosition;
-                }
+        // the tick labels are measured only once for calculating the size and for painting
+        const TickLabelMeasurements &measurements = tickLabelMeasurements(plane, centerTicks);
+        const qreal majorTickLength = axis()->tickLength(false);
+        size = measurements.unlabeledTickLength;
+        for (const TickLabelMeasurements::Label &label : measurements.labels) {
+            const qreal tickLength = label.type == TickIterator::CustomTick ? customTickLength : majorTickLength;
+            size = qMax(size, tickLength + label.margin + geoXy(label.size.height(), label.size.width()));
+        }
 
-                labelSizeTransverse = geoXy(sz.height(), sz.width());
-                labelMargin = rulerAttr.labelMargin();
-                if (labelMargin < 0) {
-                    labelMargin = QFontMetricsF(tickLabel.realFont()).height() * 0.5;
-                }
-                labelMargin -= tickLabel.marginWidth(); // make up for the margin that's already there
-            }
-            qreal tickLength = it.type() == TickIterator::CustomTick ? customTickLength : axis()->tickLength(it.type() == TickIterator::MinorTick);
-            size = qMax(size, tickLength + labelMargin + labelSizeTransverse);
+        if (!measurements.labels.isEmpty()) {
+            const TickLabelMeasurements::Label &lowestLabel = measurements.labels.first();
+            const TickLabelMeasurements::Label &highestLabel = measurements.labels.last();
+            QPointF labelPosition = plane->translate(QPointF(geoXy(lowestLabel.position, ( qreal )1.0),
+                                                             geoXy(( qreal )1.0, lowestLabel.position)));
+            lowestLabelPosition = geoXy(labelPosition.x(), labelPosition.y());
+            lowestLabelLongitudinalSize = geoXy(lowestLabel.size.width(), lowestLabel.size.height());
+            labelPosition = plane->translate(QPointF(geoXy(highestLabel.position, ( qreal )1.0),
+                                                     geoXy(( qreal )1.0, highestLabel.position)));
+            highestLabelPosition = geoXy(labelPosition.x(), labelPosition.y());
+            highestLabelLongitudinalSize = geoXy(highestLabel.size.width(), highestLabel.size.height());
         }
 
         const DataDimension dimX = plane->gridDimensionsList().first();
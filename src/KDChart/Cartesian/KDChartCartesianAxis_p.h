@@ -25,6 +25,13 @@
 #include "KDChartAbstractAxis_p.h"
 #include "KDChartAbstractCartesianDiagram.h"
 #include "KDChartCartesianAxis.h"
+#include "KDChartGridAttributes.h"
+#include "KDChartLayoutItems.h"
+
+#include <QFont>
+#include <QLineF>
+#include <QPolygon>
+#include <QVector>
 
 #include <KDABLibFakes>
 
@@ -32,77 +39,6 @@
 
 namespace KDChart {
 
-/**
- * \internal
- */
-class CartesianAxis::Private : public AbstractAxis::Private
-{
-    friend class CartesianAxis;
-
-public:
-    Private(AbstractCartesianDiagram *diagram, CartesianAxis *axis)
-        : AbstractAxis::Private(diagram, axis)
-        , useDefaultTextAttributes(true)
-        , cachedHeaderLabels(QStringList())
-        , cachedLabelHeight(0.0)
-        , cachedFontHeight(0)
-        , axisTitleSpace(1.0)
-    {
-    }
-    ~Private() override
-    {
-    }
-
-    static const Private *get(const CartesianAxis *axis)
-    {
-        return axis->d_func();
-    };
-
-    CartesianAxis *axis() const
-    {
-        return static_cast<CartesianAxis *>(mAxis);
-    }
-    void drawTitleText(QPainter *, CartesianCoordinatePlane *plane, const QRect &areaGeoRect) const;
-    const TextAttributes titleTextAttributesWithAdjustedRotation() const;
-    QSize calculateMaximumSize() const;
-    QString customizedLabelText(const QString &text, Qt::Orientation orientation, qreal value) const;
-    bool isVertical() const;
-
-    QMultiMap<qreal, QString> annotations;
-
-private:
-    friend class TickIterator;
-    QString titleText;
-    TextAttributes titleTextAttributes;
-    bool useDefaultTextAttributes;
-    Position position;
-    QRect geometry;
-    int customTickLength;
-    QList<qreal> customTicksPositions;
-    mutable QStringList cachedHeaderLabels;
-    mutable qreal cachedLabelHeight;
-    mutable qreal cachedLabelWidth;
-    mutable int cachedFontHeight;
-    mutable int cachedFontWidth;
-    mutable QSize cachedMaximumSize;
-    qreal axisTitleSpace;
-};
-
-inline CartesianAxis::CartesianAxis(Private *p, AbstractDiagram *diagram)
-    : AbstractAxis(p, diagram)
-{
-    init();
-}
-
-inline CartesianAxis::Private *CartesianAxis::d_func()
-{
-    return static_cast<Private *>(AbstractAxis::d_func());
-}
-inline const CartesianAxis::Private *CartesianAxis::d_func() const
-{
-    return static_cast<const Private *>(AbstractAxis::d_func());
-}
-
 class XySwitch
 {
 public:
@@ -164,6 +100,12 @@ public:
     {
         return m_axis && !m_axis->labels().isEmpty() && m_axis->shortLabels().count() == m_axis->labels().count();
     }
+    // The index of the current tick's label among the labels that label thinning applies to,
+    // or -1 if label thinning does not apply to it. It does not depend on the thinning factor.
+    int thinningIndex() const
+    {
+        return m_thinningIndex;
+    }
     bool isAtEnd() const
     {
         return m_position == std::numeric_limits<qreal>::infinity();
@@ -194,6 +136,7 @@ private:
     // these generally change in operator++(), i.e. from one label to the next
     int m_customTickIndex;
     int m_manualLabelIndex;
+    int m_thinningIndex;
     TickType m_type;
     qreal m_position;
     qreal m_customTick;
@@ -201,6 +144,151 @@ private:
     qreal m_minorTick;
     QString m_text;
 };
+
+/**
+ * \internal
+ *
+ * The tick labels of an axis, measured in a single pass over its ticks.
+ *
+ * Label collision avoidance and the size hint of the axis work on these
+ * measurements instead of laying out all ticks again. They are kept until the
+ * range, the label font or the configuration of the axis change.
+ */
+class TickLabelMeasurements
+{
+public:
+    class Label
+    {
+    public:
+        qreal position; // in data space, including the offset of centered ticks
+        TickIterator::TickType type;
+        int thinningIndex; // see TickIterator::thinningIndex()
+        qreal margin;
+        QSize size;
+        QPolygon boundingPolygon;
+    };
+
+    bool isValid = false;
+    // what the measurements depend on
+    DataDimension dimension;
+    GridAttributes gridAttributes;
+    unsigned int autoAdjustRange = 0;
+    TextAttributes textAttributes;
+    QFont font;
+    bool isVertical = false;
+    bool centerTicks = false;
+    int majorThinningFactor = 1;
+
+    QVector<Label> labels;
+    // indices into labels by TickIterator::thinningIndex(), -1 where no such label is collision tested
+    QVector<int> thinnableLabels;
+    // the longest tick mark of the ticks without a label
+    qreal unlabeledTickLength = 0.0;
+};
+
+/**
+ * \internal
+ *
+ * The label thinning factor and label text attributes found by label collision
+ * avoidance, for one position of the axis on screen.
+ */
+class TickLabelLayout
+{
+public:
+    bool isValid = false;
+    QLineF axisLine;
+
+    int thinningFactor = 1;
+    TextAttributes textAttributes;
+};
+
+/**
+ * \internal
+ */
+class CartesianAxis::Private : public AbstractAxis::Private
+{
+    friend class CartesianAxis;
+
+public:
+    Private(AbstractCartesianDiagram *diagram, CartesianAxis *axis)
+        : AbstractAxis::Private(diagram, axis)
+        , useDefaultTextAttributes(true)
+        , cachedHeaderLabels(QStringList())
+        , cachedLabelHeight(0.0)
+        , cachedFontHeight(0)
+        , axisTitleSpace(1.0)
+    {
+    }
+    ~Private() override
+    {
+    }
+
+    static const Private *get(const CartesianAxis *axis)
+    {
+        return axis->d_func();
+    };
+
+    CartesianAxis *axis() const
+    {
+        return static_cast<CartesianAxis *>(mAxis);
+    }
+    void drawTitleText(QPainter *, CartesianCoordinatePlane *plane, const QRect &areaGeoRect) const;
+    const TextAttributes titleTextAttributesWithAdjustedRotation() const;
+    QSize calculateMaximumSize() const;
+    QString customizedLabelText(const QString &text, Qt::Orientation orientation, qreal value) const;
+    bool isVertical() const;
+
+    const TickLabelMeasurements &tickLabelMeasurements(CartesianCoordinatePlane *plane, bool centerTicks) const;
+    void measureTickLabels(TickLabelMeasurements *measurements, CartesianCoordinatePlane *plane,
+                           bool centerTicks, const TextAttributes &ta, int majorThinningFactor) const;
+    const TickLabelLayout &tickLabelLayout(CartesianCoordinatePlane *plane, bool centerTicks, const QLineF &axisLine,
+                                           qreal transversePosition, qreal transverseScreenSpaceShift) const;
+    int firstTickLabelCollision(const TickLabelMeasurements &measurements, CartesianCoordinatePlane *plane,
+                                const TextAttributes &ta, int thinningFactor,
+                                qreal transversePosition, qreal transverseScreenSpaceShift) const;
+    QLineF tickLine(CartesianCoordinatePlane *plane, qreal drawPos, TickIterator::TickType type,
+                    qreal transversePosition, qreal transverseScreenSpaceShift) const;
+    QPointF tickLabelPosition(const QPointF &tickEnd, const QSize &size, const QPolygon &labelPoly,
+                              int rotation, qreal labelMargin) const;
+    void invalidateTickLabels();
+
+    QMultiMap<qreal, QString> annotations;
+
+private:
+    friend class TickIterator;
+    QString titleText;
+    TextAttributes titleTextAttributes;
+    bool useDefaultTextAttributes;
+    Position position;
+    QRect geometry;
+    int customTickLength;
+    QList<qreal> customTicksPositions;
+    mutable QStringList cachedHeaderLabels;
+    mutable qreal cachedLabelHeight;
+    mutable qreal cachedLabelWidth;
+    mutable int cachedFontHeight;
+    mutable int cachedFontWidth;
+    mutable QSize cachedMaximumSize;
+    mutable TickLabelMeasurements measuredTickLabels;
+    mutable TickLabelLayout labelLayout;
+    qreal axisTitleSpace;
+};
+
+inline CartesianAxis::CartesianAxis(Private *p, AbstractDiagram *diagram)
+    : AbstractAxis(p, diagram)
+{
+    init();
+}
+
+inline CartesianAxis::Private *CartesianAxis::d_func()
+{
+    return static_cast<Private *>(AbstractAxis::d_func());
+}
+inline const CartesianAxis::Private *CartesianAxis::d_func() const
+{
+    return static_cast<const Private *>(AbstractAxis::d_func());
+}
+
 }
 
 #endif
@@ -18,6 +18,7 @@
 #include "KDChartBarDiagram.h"
 #include "KDChartGridAttributes.h"
 #include "KDChartPaintContext.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartStockDiagram.h"
 
@@ -28,6 +29,7 @@
 #include <QFont>
 #include <QList>
 #include <QPainter>
+#include <QPaintDevice>
 #include <QtDebug>
 
 using namespace KDChart;
@@ -37,12 +39,14 @@ using namespace KDChart;
 CartesianCoordinatePlane::Private::Private()
     : AbstractCoordinatePlane::Private()
 {
+    zoomSettleTimer.setSingleShot(true);
+    zoomSettleTimer.setInterval(150);
 }
 
 CartesianCoordinatePlane::CartesianCoordinatePlane(Chart *parent)
     : AbstractCoordinatePlane(new Private(), parent)
 {
-    // this block left empty intentionally
+    init();
 }
 
 CartesianCoordinatePlane::~CartesianCoordinatePlane()
@@ -52,7 +56,8 @@ CartesianCoordinatePlane::~CartesianCoordinatePlane()
 
 void CartesianCoordinatePlane::init()
 {
-    // this block left empty intentionally
+    // paint the diagrams again at the new zoom
+    connect(&d->zoomSettleTimer, &QTimer::timeout, this, &CartesianCoordinatePlane::update);
 }
 
 void CartesianCoordinatePlane::addDiagram(AbstractDiagram *diagram)
@@ -67,6 +72,46 @@ void CartesianCoordinatePlane::addDiagram(AbstractDiagram *diagram)
     connect(diagram, &AbstractDiagram::propertiesChanged, this, &CartesianCoordinatePlane::propertiesChanged);
 }
 
+static void paintDiagrams(PaintContext *ctx, const AbstractDiagramList &diags)
+{
+    QPainter *const painter = ctx->painter();
+    for (int i = 0; i < diags.size(); i++) {
+        if (diags[i]->isHidden()) {
+            continue;
+        }
+        bool doDumpPaintTime = AbstractDiagram::Private::get(diags[i])->doDumpPaintTime;
+        QElapsedTimer stopWatch;
+        if (doDumpPaintTime) {
+            stopWatch.start();
+        }
+
+        PaintProfiler::Scope scope(PaintProfile::DiagramPhase);
+        PainterSaver diagramPainterSaver(painter);
+        diags[i]->paint(ctx);
+
+        if (doDumpPaintTime) {
+            qDebug() << "Painting diagram" << i << "took" << stopWatch.elapsed() << "milliseconds";
+        }
+    }
+}
+
+static bool canPaintDataLayer(QPainter *painter)
+{
+    // the image is painted pixel for pixel, which only works on raster devices without scaling
+    const QPaintDevice *device = painter->device();
+    if (!device || painter->worldTransform().type() > QTransform::TxTranslate) {
+        return false;
+    }
+    switch (device->devType()) {
+    case QInternal::Widget:
+    case QInternal::Image:
+    case QInternal::Pixmap:
+        return true;
+    default:
+        return false;
+    }
+}
+
 void CartesianCoordinatePlane::paint(QPainter *painter)
 {
     // prevent recursive call:
@@ -90,25 +135,45 @@ void CartesianCoordinatePlane::paint(QPainter *painter)
         painter->setClipRegion(clipRegion);
 
         // paint the coordinate system rulers:
-        d->grid->drawGrid(&ctx);
+        {
+            PaintProfiler::Scope scope(PaintProfile::GridPhase);
+            d->grid->drawGrid(&ctx);
+        }
 
         // paint the diagrams:
-        for (int i = 0; i < diags.size(); i++) {
-            if (diags[i]->isHidden()) {
-                continue;
+        if (!d->deferredZoomRendering || !canPaintDataLayer(painter)) {
+            d->dataLayer = QImage();
+            paintDiagrams(&ctx, diags);
+        } else if (d->canMoveDataLayer()) {
+            // zoom or pan in progress: move the diagrams as painted last to the new zoom
+            PainterSaver layerPainterSaver(painter);
+            painter->setRenderHint(QPainter::SmoothPixmapTransform);
+            painter->setTransform(d->dataLayerTransformation.backTransform * d->coordinateTransformation.transform, true);
+            painter->drawImage(d->dataLayerRect.topLeft(), d->dataLayer);
+        } else {
+            d->zoomSettleTimer.stop();
+            const qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+            const QSize imageSize = (QSizeF(clipRect.size()) * devicePixelRatio).toSize();
+            if (d->dataLayer.size() != imageSize || d->dataLayer.devicePixelRatio() != devicePixelRatio) {
+                d->dataLayer = QImage(imageSize, QImage::Format_ARGB32_Premultiplied);
+                d->dataLayer.setDevicePixelRatio(devicePixelRatio);
             }
-            bool doDumpPaintTime = AbstractDiagram::Private::get(diags[i])->doDumpPaintTime;
-            QElapsedTimer stopWatch;
-            if (doDumpPaintTime) {
-                stopWatch.start();
-            }
-
-            PainterSaver diagramPainterSaver(painter);
-            diags[i]->paint(&ctx);
-
-            if (doDumpPaintTime) {
-                qDebug() << "Painting diagram" << i << "took" << stopWatch.elapsed() << "milliseconds";
+            d->dataLayer.fill(Qt::transparent);
+            d->dataLayerRect = clipRect;
+            d->dataLayerTransformation = d->coordinateTransformation;
+            {
+                QPainter layerPainter(&d->dataLayer);
+                layerPainter.setRenderHints(painter->renderHints());
+                layerPainter.setFont(painter->font());
+                layerPainter.setPen(painter->pen());
+                layerPainter.setBrush(painter->brush());
+                layerPainter.translate(-clipRect.topLeft());
+                layerPainter.setClipRect(clipRect);
+                ctx.setPainter(&layerPainter);
+                paintDiagrams(&ctx, diags);
+                ctx.setPainter(painter);
             }
+            painter->drawImage(clipRect.topLeft(), d->dataLayer);
         }
     }
     d->bPaintIsRunning = false;
@@ -486,6 +551,7 @@ void CartesianCoordinatePlane::setZoomFactors(qreal factorX, qreal factorY)
 {
     if (doneSetZoomFactorX(factorX) || doneSetZoomFactorY(factorY)) {
         d->coordinateTransformation.updateTransform(logicalArea(), drawingArea());
+        d->zoomChanged();
         Q_EMIT propertiesChanged();
     }
 }
@@ -494,6 +560,7 @@ void CartesianCoordinatePlane::setZoomFactorX(qreal factor)
 {
     if (doneSetZoomFactorX(factor)) {
         d->coordinateTransformation.updateTransform(logicalArea(), drawingArea());
+        d->zoomChanged();
         Q_EMIT propertiesChanged();
     }
 }
@@ -502,6 +569,7 @@ void CartesianCoordinatePlane::setZoomFactorY(qreal factor)
 {
     if (doneSetZoomFactorY(factor)) {
         d->coordinateTransformation.updateTransform(logicalArea(), drawingArea());
+        d->zoomChanged();
         Q_EMIT propertiesChanged();
     }
 }
@@ -510,10 +578,39 @@ void CartesianCoordinatePlane::setZoomCenter(const QPointF &point)
 {
     if (doneSetZoomCenter(point)) {
         d->coordinateTransformation.updateTransform(logicalArea(), drawingArea());
+        d->zoomChanged();
         Q_EMIT propertiesChanged();
     }
 }
 
+void CartesianCoordinatePlane::setDeferredZoomRendering(bool enable)
+{
+    if (d->deferredZoomRendering == enable) {
+        return;
+    }
+    d->deferredZoomRendering = enable;
+    if (!enable) {
+        d->zoomSettleTimer.stop();
+        d->dataLayer = QImage();
+        update();
+    }
+}
+
+bool CartesianCoordinatePlane::isDeferredZoomRenderingEnabled() const
+{
+    return d->deferredZoomRendering;
+}
+
+void CartesianCoordinatePlane::setZoomSettleTime(int msecs)
+{
+    d->zoomSettleTimer.setInterval(msecs);
+}
+
+int CartesianCoordinatePlane::zoomSettleTime() const
+{
+    return d->zoomSettleTimer.interval();
+}
+
 QPointF CartesianCoordinatePlane::zoomCenter() const
 {
     return d->coordinateTransformation.zoom.center();
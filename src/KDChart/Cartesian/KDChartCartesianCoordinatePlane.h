@@ -83,6 +83,38 @@ public:
      */
     void setZoomCenter(const QPointF &center) override;
 
+    /**
+     * Enables or disables deferred rendering of zoom and pan changes.
+     *
+     * When enabled, the plane keeps an image of its diagrams as painted last. While the zoom
+     * factors or the zoom center keep changing, e.g. during wheel zooming or when dragging to pan,
+     * this image is moved and scaled to the new zoom instead of painting all diagrams again; the
+     * grid and the axes are painted at the new zoom right away. The diagrams are painted again
+     * once the zoom did not change for zoomSettleTime() milliseconds.
+     *
+     * The image is only used when painting onto widgets, images and pixmaps without scaling.
+     * Disabled by default.
+     *
+     * \sa setZoomSettleTime
+     */
+    void setDeferredZoomRendering(bool enable);
+    /**
+     * \sa setDeferredZoomRendering
+     */
+    bool isDeferredZoomRenderingEnabled() const;
+
+    /**
+     * Sets the time in milliseconds after the last zoom or pan change until the diagrams
+     * are painted again at the new zoom. The default is 150 milliseconds.
+     *
+     * \sa setDeferredZoomRendering
+     */
+    void setZoomSettleTime(int msecs);
+    /**
+     * \sa setZoomSettleTime
+     */
+    int zoomSettleTime() const;
+
     /**
      * Allows to specify a fixed data-space / coordinate-space relation. If set
      * to true then fixed bar widths are used, so you see more bars as the window
@@ -27,6 +27,9 @@
 #include "KDChartCartesianGrid.h"
 #include "KDChartZoomParameters.h"
 
+#include <QImage>
+#include <QTimer>
+
 #include <KDABLibFakes>
 
 namespace KDChart {
@@ -123,6 +126,32 @@ public:
 
     bool reverseVerticalPlane = false;
     bool reverseHorizontalPlane = false;
+
+    // the diagrams as painted last, moved and scaled while zoom or pan is in progress,
+    // see setDeferredZoomRendering()
+    bool deferredZoomRendering = false;
+    QImage dataLayer;
+    QRect dataLayerRect;
+    CoordinateTransformation dataLayerTransformation;
+    // running from a zoom or pan change until the diagrams are painted again
+    QTimer zoomSettleTimer;
+
+    void zoomChanged()
+    {
+        if (deferredZoomRendering && !dataLayer.isNull()) {
+            zoomSettleTimer.start();
+        }
+    }
+
+    bool canMoveDataLayer() const
+    {
+        // the image only maps linearly to the new zoom if the axes are scaled the same way
+        const CoordinateTransformation &layer = dataLayerTransformation;
+        const CoordinateTransformation &current = coordinateTransformation;
+        return zoomSettleTimer.isActive() && !dataLayer.isNull()
+            && layer.axesCalcModeX == current.axesCalcModeX && layer.axesCalcModeY == current.axesCalcModeY
+            && layer.isPositiveX == current.isPositiveX && layer.isPositiveY == current.isPositiveY;
+    }
 };
 
 KDCHART_IMPL_DERIVED_PLANE(CartesianCoordinatePlane, AbstractCoordinatePlane)
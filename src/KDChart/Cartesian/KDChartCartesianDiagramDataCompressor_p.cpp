@@ -11,20 +11,287 @@
 #include "KDChartCartesianDiagramDataCompressor_p.h"
 
 #include <QAbstractItemModel>
+#include <QAbstractProxyModel>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QThreadPool>
 #include <QtDebug>
 
 #include "KDChartAbstractCartesianDiagram.h"
+#include "KDChartAggregationKernels_p.h"
+#include "KDChartAttributesModel.h"
+#include "KDChartNumericDataModel_p.h"
+#include "KDChartPaintProfiler_p.h"
 
 #include <KDABLibFakes>
 
 using namespace KDChart;
 using namespace std;
 
+// models with fewer rows are compressed while painting, even if asynchronous preparation is on
+static const int MinimumAsynchronousRows = 100000;
+
+namespace {
+// merges the values of the rows that fall into one data point
+class Aggregate
+{
+public:
+    explicit Aggregate(CartesianDiagramDataCompressor::AggregationMode mode)
+        : m_mode(mode)
+    {
+    }
+
+    void add(int row, qreal value)
+    {
+        if (m_count++ == 0) {
+            m_sourceRow = row;
+        }
+        m_rowSum += row;
+        if (ISNAN(value)) {
+            return;
+        }
+        switch (m_mode) {
+        case CartesianDiagramDataCompressor::AverageAggregation:
+            m_value = ISNAN(m_value) ? value : m_value + value;
+            break;
+        case CartesianDiagramDataCompressor::FirstAggregation:
+            if (ISNAN(m_value)) {
+                m_value = value;
+                m_sourceRow = row;
+            }
+            break;
+        case CartesianDiagramDataCompressor::LastAggregation:
+            m_value = value;
+            m_sourceRow = row;
+            break;
+        case CartesianDiagramDataCompressor::MaximumAggregation:
+            if (ISNAN(m_value) || value > m_value) {
+                m_value = value;
+                m_sourceRow = row;
+            }
+            break;
+        case CartesianDiagramDataCompressor::MinimumAggregation:
+            if (ISNAN(m_value) || value < m_value) {
+                m_value = value;
+                m_sourceRow = row;
+            }
+            break;
+        }
+    }
+
+    qreal key() const
+    {
+        return m_rowSum / m_count;
+    }
+
+    qreal value() const
+    {
+        return m_mode == CartesianDiagramDataCompressor::AverageAggregation ? m_value / m_count : m_value;
+    }
+
+    // the row the value comes from; the first row for averages and empty values
+    int sourceRow() const
+    {
+        return m_sourceRow;
+    }
+
+    int count() const
+    {
+        return m_count;
+    }
+
+private:
+    CartesianDiagramDataCompressor::AggregationMode m_mode;
+    int m_count = 0;
+    qreal m_rowSum = 0.0;
+    qreal m_value = std::numeric_limits<qreal>::quiet_NaN();
+    int m_sourceRow = -1;
+};
+
+// the result of aggregating rows
+struct Aggregated
+{
+    qreal key;
+    qreal value;
+    int sourceRow;
+};
+
+// the same as adding the rows from baseRow to endRow - 1 to an Aggregate, for values
+// in one array; rows past the end of the array are empty
+Aggregated aggregateValues(const QVector<qreal> &values, int baseRow, int endRow,
+                           CartesianDiagramDataCompressor::AggregationMode mode)
+{
+    Aggregated result = { (baseRow + endRow - 1) / 2.0, std::numeric_limits<qreal>::quiet_NaN(), baseRow };
+    const int count = qBound(0, values.size() - baseRow, endRow - baseRow);
+    const qreal *first = count > 0 ? values.constData() + baseRow : nullptr;
+    int index = -1;
+    switch (mode) {
+    case CartesianDiagramDataCompressor::AverageAggregation: {
+        const AggregationKernels::Sum sum = AggregationKernels::sum(first, count);
+        if (sum.count > 0) {
+            result.value = sum.sum / (endRow - baseRow);
+        }
+        return result;
+    }
+    case CartesianDiagramDataCompressor::FirstAggregation:
+        index = AggregationKernels::firstIndex(first, count);
+        break;
+    case CartesianDiagramDataCompressor::LastAggregation:
+        index = AggregationKernels::lastIndex(first, count);
+        break;
+    case CartesianDiagramDataCompressor::MaximumAggregation:
+        index = AggregationKernels::maximumIndex(first, count);
+        break;
+    case CartesianDiagramDataCompressor::MinimumAggregation:
+        index = AggregationKernels::minimumIndex(first, count);
+        break;
+    }
+    if (index >= 0) {
+        result.value = first[index];
+        result.sourceRow = baseRow + index;
+    }
+    return result;
+}
+
+// an aggregated data point and the number of rows it covers
+struct Bucket
+{
+    qreal key;
+    qreal value;
+    int sourceRow;
+    int rows;
+    bool hidden;
+};
+
+// the data point of the rows of two adjacent buckets, as Aggregate would calculate it
+// from the model
+Bucket merged(const Bucket &first, const Bucket &second, CartesianDiagramDataCompressor::AggregationMode mode)
+{
+    Bucket result = first;
+    result.rows = first.rows + second.rows;
+    result.key = (first.key * first.rows + second.key * second.rows) / result.rows;
+    result.hidden = first.hidden && second.hidden;
+    if (ISNAN(second.value)) {
+        if (mode == CartesianDiagramDataCompressor::AverageAggregation) {
+            result.value = first.value * first.rows / result.rows;
+        }
+        return result;
+    }
+    bool takeSecond = ISNAN(first.value);
+    switch (mode) {
+    case CartesianDiagramDataCompressor::AverageAggregation:
+        result.value = ((takeSecond ? 0.0 : first.value * first.rows) + second.value * second.rows) / result.rows;
+        return result;
+    case CartesianDiagramDataCompressor::FirstAggregation:
+        break;
+    case CartesianDiagramDataCompressor::LastAggregation:
+        takeSecond = true;
+        break;
+    case CartesianDiagramDataCompressor::MaximumAggregation:
+        takeSecond = takeSecond || second.value > first.value;
+        break;
+    case CartesianDiagramDataCompressor::MinimumAggregation:
+        takeSecond = takeSecond || second.value < first.value;
+        break;
+    }
+    if (takeSecond) {
+        result.value = second.value;
+        result.sourceRow = second.sourceRow;
+    }
+    return result;
+}
+}
+
+void CartesianDiagramDataCompressor::Dataset::resize(int size)
+{
+    keys.fill(std::numeric_limits<qreal>::quiet_NaN(), size);
+    values.fill(std::numeric_limits<qreal>::quiet_NaN(), size);
+    flags.fill(0, size);
+    sourceRows.clear();
+}
+
+void CartesianDiagramDataCompressor::Dataset::insert(int row, int count)
+{
+    keys.insert(row, count, std::numeric_limits<qreal>::quiet_NaN());
+    values.insert(row, count, std::numeric_limits<qreal>::quiet_NaN());
+    flags.insert(row, count, 0);
+    if (!sourceRows.isEmpty()) {
+        sourceRows.insert(row, count, -1);
+    }
+}
+
+void CartesianDiagramDataCompressor::Dataset::remove(int row, int count)
+{
+    keys.remove(row, count);
+    values.remove(row, count);
+    flags.remove(row, count);
+    if (!sourceRows.isEmpty()) {
+        sourceRows.remove(row, count);
+    }
+}
+
+void CartesianDiagramDataCompressor::Dataset::clear(int row)
+{
+    keys[row] = std::numeric_limits<qreal>::quiet_NaN();
+    values[row] = std::numeric_limits<qreal>::quiet_NaN();
+    flags[row] = 0;
+}
+
+void CartesianDiagramDataCompressor::Dataset::clear()
+{
+    resize(size());
+}
+
+void CartesianDiagramDataCompressor::Dataset::set(int row, qreal key, qreal value, int sourceRow, bool hidden)
+{
+    keys[row] = key;
+    values[row] = value;
+    flags[row] = hidden ? Cached | Hidden : Cached;
+    if (sourceRows.isEmpty() && sourceRow != row) {
+        sourceRows.resize(size());
+        for (int i = 0; i < sourceRows.size(); ++i) {
+            sourceRows[i] = i;
+        }
+    }
+    if (!sourceRows.isEmpty()) {
+        sourceRows[row] = sourceRow;
+    }
+}
+
+struct CartesianDiagramDataCompressor::Preparation
+{
+    struct Point
+    {
+        qreal key;
+        qreal value;
+        int row;
+    };
+
+    QMutex mutex;
+    // the compressor to report to; null once the result is not wanted anymore
+    CartesianDiagramDataCompressor *compressor = nullptr;
+    QAtomicInt canceled;
+    int generation = 0;
+
+    int rowCount = 0;
+    int pointCount = 0;
+    QVector<AggregationMode> aggregationPattern;
+    QVector<QVector<qreal>> columns; // shared with the model, which detaches when it changes
+    QVector<QVector<Point>> points;
+};
+
 CartesianDiagramDataCompressor::CartesianDiagramDataCompressor(QObject *parent)
     : QObject(parent)
 {
     calculateSampleStepWidth();
-    m_data.resize(0);
+}
+
+CartesianDiagramDataCompressor::~CartesianDiagramDataCompressor()
+{
+    cancelPreparation();
+    if (m_sharedModelCache) {
+        m_sharedModelCache->release();
+    }
 }
 
 static bool contains(const CartesianDiagramDataCompressor::AggregatedDataValueAttributes &aggregated,
@@ -101,19 +368,154 @@ bool CartesianDiagramDataCompressor::prepareDataChange(const QModelIndex &parent
     return true;
 }
 
+bool CartesianDiagramDataCompressor::isAppend(const QModelIndex &parent, int start, int end, bool inserted) const
+{
+    if (parent != m_rootIndex || !m_model || m_data.isEmpty() || m_data.first().size() == 0) {
+        return false;
+    }
+    // datasets that are not compressed simply get one more data point per row
+    if (m_datasetDimension == 2 || (m_datasetDimension != 1 && m_aggregationPattern.isEmpty())) {
+        return false;
+    }
+    const int rowCount = m_model->rowCount(m_rootIndex);
+    return inserted ? end == rowCount - 1 : start == rowCount;
+}
+
+void CartesianDiagramDataCompressor::appendRows(int start, int end)
+{
+    const int rowCount = end + 1;
+    if (m_bucketRows == 0) {
+        // a whole number of rows per data point lets the data points of the old rows
+        // stay as they are while rows are added
+        const int pointCount = m_data.first().size();
+        m_bucketRows = (start + pointCount - 1) / pointCount;
+        const int newPointCount = (start + m_bucketRows - 1) / m_bucketRows;
+        for (int column = 0; column < m_data.size(); ++column) {
+            if (start != pointCount) {
+                m_data[column].resize(newPointCount);
+            }
+            // the data points never outgrow the resolution
+            m_data[column].keys.reserve(m_xResolution);
+            m_data[column].values.reserve(m_xResolution);
+            m_data[column].flags.reserve(m_xResolution);
+        }
+        if (start != pointCount) {
+            m_dataValueAttributesCache.clear();
+        }
+    }
+    while ((rowCount + m_bucketRows - 1) / m_bucketRows > m_xResolution) {
+        mergeDataPoints(start);
+    }
+
+    const int pointCount = (rowCount + m_bucketRows - 1) / m_bucketRows;
+    const int lastPoint = (start - 1) / m_bucketRows;
+    const int foldedEnd = qMin(rowCount, (lastPoint + 1) * m_bucketRows);
+    for (int column = 0; column < m_data.size(); ++column) {
+        Dataset &data = m_data[column];
+        // the new rows of a partially filled last data point are folded into it, the
+        // other new data points are retrieved from the model once they are needed
+        if (foldedEnd > start && (data.flags.at(lastPoint) & Dataset::Cached)) {
+            Aggregate aggregate(aggregationMode(column));
+            bool hidden = true;
+            for (int row = start; row < foldedEnd; ++row) {
+                const QModelIndex index = m_model->index(row, column, m_rootIndex);
+                aggregate.add(row, modelValue(index));
+                if (m_model->data(index, DataHiddenRole).value<bool>() == false) {
+                    hidden = false;
+                }
+            }
+            PaintProfiler::count(PaintProfile::ModelFetchCounter, aggregate.count());
+            const Bucket old = { data.keys.at(lastPoint), data.values.at(lastPoint), data.sourceRow(lastPoint),
+                                 start - lastPoint * m_bucketRows, bool(data.flags.at(lastPoint) & Dataset::Hidden) };
+            const Bucket added = { aggregate.key(), aggregate.value(), aggregate.sourceRow(), aggregate.count(), hidden };
+            const Bucket point = merged(old, added, aggregationMode(column));
+            data.set(lastPoint, point.key, point.value, point.sourceRow, point.hidden);
+        } else if (foldedEnd > start) {
+            data.clear(lastPoint);
+        }
+        data.insert(data.size(), pointCount - data.size());
+    }
+    if (foldedEnd > start) {
+        for (int column = 0; column < m_data.size(); ++column) {
+            m_dataValueAttributesCache.remove(CachePosition(lastPoint, column));
+        }
+    }
+}
+
+void CartesianDiagramDataCompressor::mergeDataPoints(int rowCount)
+{
+    for (int column = 0; column < m_data.size(); ++column) {
+        Dataset &data = m_data[column];
+        const AggregationMode mode = aggregationMode(column);
+        const int pointCount = (data.size() + 1) / 2;
+        for (int point = 0; point < pointCount; ++point) {
+            const int first = point * 2;
+            const int second = first + 1;
+            const bool firstCached = data.flags.at(first) & Dataset::Cached;
+            if (second == data.size()) {
+                if (firstCached) {
+                    data.set(point, data.keys.at(first), data.values.at(first), data.sourceRow(first),
+                             data.flags.at(first) & Dataset::Hidden);
+                } else {
+                    data.clear(point);
+                }
+            } else if (firstCached && (data.flags.at(second) & Dataset::Cached)) {
+                const Bucket a = { data.keys.at(first), data.values.at(first), data.sourceRow(first),
+                                   m_bucketRows, bool(data.flags.at(first) & Dataset::Hidden) };
+                const Bucket b = { data.keys.at(second), data.values.at(second), data.sourceRow(second),
+                                   qMin(m_bucketRows, rowCount - second * m_bucketRows),
+                                   bool(data.flags.at(second) & Dataset::Hidden) };
+                const Bucket result = merged(a, b, mode);
+                data.set(point, result.key, result.value, result.sourceRow, result.hidden);
+            } else {
+                // retrieved from the model once it is needed
+                data.clear(point);
+            }
+        }
+        data.remove(pointCount, data.size() - pointCount);
+    }
+    m_bucketRows *= 2;
+    m_dataValueAttributesCache.clear();
+}
+
+CartesianDiagramDataCompressor::AggregationMode CartesianDiagramDataCompressor::aggregationMode(int column) const
+{
+    return m_aggregationPattern.isEmpty() ? AverageAggregation
+                                          : m_aggregationPattern.at(column % m_aggregationPattern.size());
+}
+
 void CartesianDiagramDataCompressor::slotRowsAboutToBeInserted(const QModelIndex &parent, int start, int end)
 {
+    if (restartPreparation(false)) {
+        return;
+    }
+    // appended rows are folded into the data points once they are inserted, other
+    // changes of appended data points rebuild the cache then
+    if (isAppend(parent, start, end, false) || (m_bucketRows && parent == m_rootIndex)) {
+        return;
+    }
     if (!prepareDataChange(parent, true, &start, &end)) {
         return;
     }
     for (int i = 0; i < m_data.size(); ++i) {
         Q_ASSERT(start >= 0 && start <= m_data[i].size());
-        m_data[i].insert(start, end - start + 1, DataPoint());
+        m_data[i].insert(start, end - start + 1);
     }
 }
 
 void CartesianDiagramDataCompressor::slotRowsInserted(const QModelIndex &parent, int start, int end)
 {
+    if (restartPreparation(true)) {
+        return;
+    }
+    if (isAppend(parent, start, end, true)) {
+        appendRows(start, end);
+        return;
+    }
+    if (m_bucketRows && parent == m_rootIndex) {
+        rebuildCache();
+        return;
+    }
     if (!prepareDataChange(parent, true, &start, &end)) {
         return;
     }
@@ -126,16 +528,31 @@ void CartesianDiagramDataCompressor::slotRowsInserted(const QModelIndex &parent,
 
 void CartesianDiagramDataCompressor::slotColumnsAboutToBeInserted(const QModelIndex &parent, int start, int end)
 {
+    if (restartPreparation(false)) {
+        return;
+    }
+    if (m_bucketRows && parent == m_rootIndex) {
+        return;
+    }
     if (!prepareDataChange(parent, false, &start, &end)) {
         return;
     }
     const int rowCount = qMin(m_model ? m_model->rowCount(m_rootIndex) : 0, m_xResolution);
     Q_ASSERT(start >= 0 && start <= m_data.size());
-    m_data.insert(start, end - start + 1, QVector<DataPoint>(rowCount));
+    Dataset dataset;
+    dataset.resize(rowCount);
+    m_data.insert(start, end - start + 1, dataset);
 }
 
 void CartesianDiagramDataCompressor::slotColumnsInserted(const QModelIndex &parent, int start, int end)
 {
+    if (restartPreparation(true)) {
+        return;
+    }
+    if (m_bucketRows && parent == m_rootIndex) {
+        rebuildCache();
+        return;
+    }
     if (!prepareDataChange(parent, false, &start, &end)) {
         return;
     }
@@ -148,6 +565,12 @@ void CartesianDiagramDataCompressor::slotColumnsInserted(const QModelIndex &pare
 
 void CartesianDiagramDataCompressor::slotRowsAboutToBeRemoved(const QModelIndex &parent, int start, int end)
 {
+    if (restartPreparation(false)) {
+        return;
+    }
+    if (m_bucketRows && parent == m_rootIndex) {
+        return;
+    }
     if (!prepareDataChange(parent, true, &start, &end)) {
         return;
     }
@@ -158,6 +581,13 @@ void CartesianDiagramDataCompressor::slotRowsAboutToBeRemoved(const QModelIndex
 
 void CartesianDiagramDataCompressor::slotRowsRemoved(const QModelIndex &parent, int start, int end)
 {
+    if (restartPreparation(true)) {
+        return;
+    }
+    if (m_bucketRows && parent == m_rootIndex) {
+        rebuildCache();
+        return;
+    }
     if (parent != m_rootIndex)
         return;
     Q_ASSERT(start <= end);
@@ -180,6 +610,12 @@ void CartesianDiagramDataCompressor::slotRowsRemoved(const QModelIndex &parent,
 
 void CartesianDiagramDataCompressor::slotColumnsAboutToBeRemoved(const QModelIndex &parent, int start, int end)
 {
+    if (restartPreparation(false)) {
+        return;
+    }
+    if (m_bucketRows && parent == m_rootIndex) {
+        return;
+    }
     if (!prepareDataChange(parent, false, &start, &end)) {
         return;
     }
@@ -188,6 +624,13 @@ void CartesianDiagramDataCompressor::slotColumnsAboutToBeRemoved(const QModelInd
 
 void CartesianDiagramDataCompressor::slotColumnsRemoved(const QModelIndex &parent, int start, int end)
 {
+    if (restartPreparation(true)) {
+        return;
+    }
+    if (m_bucketRows && parent == m_rootIndex) {
+        rebuildCache();
+        return;
+    }
     if (parent != m_rootIndex)
         return;
     Q_ASSERT(start <= end);
@@ -231,11 +674,18 @@ void CartesianDiagramDataCompressor::slotModelDataChanged(
     Q_ASSERT(topLeftIndex.parent() == bottomRightIndex.parent());
     Q_ASSERT(topLeftIndex.row() <= bottomRightIndex.row());
     Q_ASSERT(topLeftIndex.column() <= bottomRightIndex.column());
+    // only the data points of the changed rows are read again; a running preparation
+    // still works on the old values, those data points are invalidated again once it is done
     CachePosition topleft = mapToCache(topLeftIndex);
     CachePosition bottomright = mapToCache(bottomRightIndex);
-    for (int row = topleft.row; row <= bottomright.row; ++row)
-        for (int column = topleft.column; column <= bottomright.column; ++column)
+    for (int row = topleft.row; row <= bottomright.row; ++row) {
+        for (int column = topleft.column; column <= bottomright.column; ++column) {
             invalidate(CachePosition(row, column));
+            if (m_preparation) {
+                m_changedWhilePreparing.append(CachePosition(row, column));
+            }
+        }
+    }
 }
 
 void CartesianDiagramDataCompressor::slotModelLayoutChanged()
@@ -308,13 +758,18 @@ void CartesianDiagramDataCompressor::setModel(QAbstractItemModel *model)
                    this, &CartesianDiagramDataCompressor::slotColumnsAboutToBeRemoved);
         disconnect(m_model, &QAbstractItemModel::modelReset,
                    this, &CartesianDiagramDataCompressor::rebuildCache);
+        if (auto *attributesModel = qobject_cast<AttributesModel *>(m_model.data())) {
+            disconnect(attributesModel, &QAbstractProxyModel::sourceModelChanged,
+                       this, &CartesianDiagramDataCompressor::slotSourceModelChanged);
+        }
         m_model = nullptr;
     }
 
-    m_modelCache.setModel(model);
+    // the model caches have to be connected to the model before this compressor
+    m_model = model;
+    updateModelSource();
 
     if (model != nullptr) {
-        m_model = model;
         connect(m_model, &QAbstractItemModel::headerDataChanged,
                 this, &CartesianDiagramDataCompressor::slotModelHeaderDataChanged);
         connect(m_model, &QAbstractItemModel::dataChanged,
@@ -339,6 +794,10 @@ void CartesianDiagramDataCompressor::setModel(QAbstractItemModel *model)
                 this, &CartesianDiagramDataCompressor::slotColumnsAboutToBeRemoved);
         connect(m_model, &QAbstractItemModel::modelReset,
                 this, &CartesianDiagramDataCompressor::rebuildCache);
+        if (auto *attributesModel = qobject_cast<AttributesModel *>(m_model.data())) {
+            connect(attributesModel, &QAbstractProxyModel::sourceModelChanged,
+                    this, &CartesianDiagramDataCompressor::slotSourceModelChanged);
+        }
     }
     rebuildCache();
     calculateSampleStepWidth();
@@ -349,6 +808,7 @@ void CartesianDiagramDataCompressor::setRootIndex(const QModelIndex &root)
     if (m_rootIndex != root) {
         Q_ASSERT(root.model() == m_model || !root.isValid());
         m_rootIndex = root;
+        updateModelSource();
         m_modelCache.setRootIndex(root);
         rebuildCache();
         calculateSampleStepWidth();
@@ -373,7 +833,7 @@ bool CartesianDiagramDataCompressor::setResolutionInternal(int x, int y)
     const int oldXRes = m_xResolution;
     const int oldYRes = m_yResolution;
 
-    if (m_datasetDimension != 1) {
+    if (m_datasetDimension == 2 || (m_datasetDimension != 1 && m_aggregationPattern.isEmpty())) {
         // just ignore the X resolution in that case
         m_xResolution = m_model ? m_model->rowCount(m_rootIndex) : 0;
     } else {
@@ -387,7 +847,7 @@ bool CartesianDiagramDataCompressor::setResolutionInternal(int x, int y)
 void CartesianDiagramDataCompressor::clearCache()
 {
     for (int column = 0; column < m_data.size(); ++column)
-        m_data[column].fill(DataPoint());
+        m_data[column].clear();
 }
 
 void CartesianDiagramDataCompressor::rebuildCache()
@@ -395,6 +855,7 @@ void CartesianDiagramDataCompressor::rebuildCache()
     Q_ASSERT(m_datasetDimension != 0);
 
     m_data.clear();
+    m_bucketRows = 0;
     setResolutionInternal(m_xResolution, m_yResolution);
     const int columnDivisor = m_datasetDimension == 2 ? 2 : 1;
     const int columnCount = m_model ? m_model->columnCount(m_rootIndex) / columnDivisor : 0;
@@ -405,18 +866,69 @@ void CartesianDiagramDataCompressor::rebuildCache()
     }
     // also empty the attrs cache
     m_dataValueAttributesCache.clear();
+    startPreparation();
 }
 
-const CartesianDiagramDataCompressor::DataPoint &CartesianDiagramDataCompressor::data(const CachePosition &position) const
+bool CartesianDiagramDataCompressor::fetch(const CachePosition &position) const
 {
-    static DataPoint nullDataPoint;
     if (!mapsToModelIndex(position)) {
-        return nullDataPoint;
+        return false;
     }
-    if (!isCached(position)) {
+    const bool cached = isCached(position);
+    PaintProfiler::countCacheLookup(cached);
+    if (!cached) {
         retrieveModelData(position);
     }
-    return m_data[position.column][position.row];
+    return true;
+}
+
+CartesianDiagramDataCompressor::DataPoint CartesianDiagramDataCompressor::data(const CachePosition &position) const
+{
+    DataPoint point;
+    if (!fetch(position)) {
+        return point;
+    }
+    const Dataset &dataset = m_data.at(position.column);
+    point.key = dataset.keys.at(position.row);
+    point.value = dataset.values.at(position.row);
+    point.hidden = dataset.flags.at(position.row) & Dataset::Hidden;
+    // a data point without a row to come from stays uncached, and has no index
+    if (dataset.flags.at(position.row) & Dataset::Cached) {
+        point.index = modelIndex(position);
+    }
+    return point;
+}
+
+qreal CartesianDiagramDataCompressor::key(const CachePosition &position) const
+{
+    return fetch(position) ? m_data.at(position.column).keys.at(position.row)
+                           : std::numeric_limits<qreal>::quiet_NaN();
+}
+
+qreal CartesianDiagramDataCompressor::value(const CachePosition &position) const
+{
+    return fetch(position) ? m_data.at(position.column).values.at(position.row)
+                           : std::numeric_limits<qreal>::quiet_NaN();
+}
+
+bool CartesianDiagramDataCompressor::isHidden(const CachePosition &position) const
+{
+    return fetch(position) && (m_data.at(position.column).flags.at(position.row) & Dataset::Hidden);
+}
+
+QModelIndex CartesianDiagramDataCompressor::index(const CachePosition &position) const
+{
+    if (!fetch(position) || !isCached(position)) {
+        return QModelIndex();
+    }
+    return modelIndex(position);
+}
+
+QModelIndex CartesianDiagramDataCompressor::modelIndex(const CachePosition &position) const
+{
+    // the index of a data point of two-dimensional datasets is the one of its key
+    const int column = m_datasetDimension == 2 ? position.column * 2 : position.column;
+    return m_model->index(m_data.at(position.column).sourceRow(position.row), column, m_rootIndex);
 }
 
 QPair<QPointF, QPointF> CartesianDiagramDataCompressor::dataBoundaries() const
@@ -428,28 +940,28 @@ QPair<QPointF, QPointF> CartesianDiagramDataCompressor::dataBoundaries() const
     qreal yMax = std::numeric_limits<qreal>::quiet_NaN();
 
     for (int column = 0; column < colCount; ++column) {
-        const DataPointVector &data = m_data[column];
-        int row = 0;
-        for (DataPointVector::const_iterator it = data.begin(); it != data.end(); ++it, ++row) {
-            const DataPoint &p = *it;
-            if (!p.index.isValid())
+        const Dataset &data = m_data[column];
+        for (int row = 0; row < data.size(); ++row) {
+            if (!(data.flags.at(row) & Dataset::Cached))
                 retrieveModelData(CachePosition(row, column));
+        }
 
-            if (ISNAN(p.key) || ISNAN(p.value)) {
-                continue;
-            }
+        const AggregationKernels::Boundaries boundaries =
+            AggregationKernels::boundaries(data.keys.constData(), data.values.constData(), data.size());
+        if (ISNAN(boundaries.minimumKey)) {
+            continue;
+        }
 
-            if (ISNAN(xMin)) {
-                xMin = p.key;
-                xMax = p.key;
-                yMin = p.value;
-                yMax = p.value;
-            } else {
-                xMin = qMin(xMin, p.key);
-                xMax = qMax(xMax, p.key);
-                yMin = qMin(yMin, p.value);
-                yMax = qMax(yMax, p.value);
-            }
+        if (ISNAN(xMin)) {
+            xMin = boundaries.minimumKey;
+            xMax = boundaries.maximumKey;
+            yMin = boundaries.minimumValue;
+            yMax = boundaries.maximumValue;
+        } else {
+            xMin = qMin(xMin, boundaries.minimumKey);
+            xMax = qMax(xMax, boundaries.maximumKey);
+            yMin = qMin(yMin, boundaries.minimumValue);
+            yMax = qMax(yMax, boundaries.maximumValue);
         }
     }
 
@@ -458,44 +970,105 @@ QPair<QPointF, QPointF> CartesianDiagramDataCompressor::dataBoundaries() const
     return qMakePair(bottomLeft, topRight);
 }
 
+void CartesianDiagramDataCompressor::slotSourceModelChanged()
+{
+    updateModelSource();
+    rebuildCache();
+}
+
+void CartesianDiagramDataCompressor::updateModelSource()
+{
+    QAbstractItemModel *model = m_model;
+    // AttributesModel maps rows and columns of its source model one to one
+    if (auto *attributesModel = qobject_cast<AttributesModel *>(model)) {
+        model = attributesModel->sourceModel();
+    }
+    m_numericModel = m_rootIndex.isValid() ? nullptr : qobject_cast<NumericDataModel *>(model);
+
+    // other diagrams showing the same model read it through their own AttributesModel,
+    // so the values are cached per source model; the compressed data depends on the
+    // settings of each diagram and stays private
+    SharedModelDataCache *sharedModelCache = nullptr;
+    if (model && !m_numericModel && !m_rootIndex.isValid()) {
+        sharedModelCache = m_sharedModelCache && m_sharedModelCache->model() == model
+            ? m_sharedModelCache
+            : SharedModelDataCache::acquire(model);
+    }
+    if (sharedModelCache != m_sharedModelCache) {
+        if (m_sharedModelCache) {
+            m_sharedModelCache->release();
+        }
+        m_sharedModelCache = sharedModelCache;
+    }
+
+    // the own model cache is only needed for the children of a root index
+    QAbstractItemModel *const cachedModel = m_numericModel || m_sharedModelCache ? nullptr : m_model.data();
+    if (m_modelCache.model() != cachedModel) {
+        m_modelCache.setModel(cachedModel);
+    }
+}
+
+qreal CartesianDiagramDataCompressor::modelValue(const QModelIndex &index) const
+{
+    if (m_numericModel) {
+        return m_numericModel->value(index.row(), index.column());
+    }
+    if (m_sharedModelCache) {
+        const QAbstractItemModel *model = m_sharedModelCache->model();
+        return model ? m_sharedModelCache->data(model->index(index.row(), index.column()))
+                     : std::numeric_limits<qreal>::quiet_NaN();
+    }
+    return m_modelCache.data(index);
+}
+
 void CartesianDiagramDataCompressor::retrieveModelData(const CachePosition &position) const
 {
     Q_ASSERT(mapsToModelIndex(position));
-    DataPoint result;
-    result.hidden = true;
+    qreal key = std::numeric_limits<qreal>::quiet_NaN();
+    qreal value = std::numeric_limits<qreal>::quiet_NaN();
+    int sourceRow = -1;
+    bool hidden = true;
 
     switch (m_mode) {
     case Precise: {
         const QModelIndexList indexes = mapToModel(position);
+        PaintProfiler::count(PaintProfile::ModelFetchCounter, indexes.size());
 
         if (m_datasetDimension == 2) {
             Q_ASSERT(indexes.count() == 2);
             const QModelIndex &xIndex = indexes.at(0);
-            result.index = xIndex;
-            result.key = m_modelCache.data(xIndex);
-            result.value = m_modelCache.data(indexes.at(1));
+            sourceRow = xIndex.row();
+            key = modelValue(xIndex);
+            value = modelValue(indexes.at(1));
         } else {
             if (indexes.isEmpty()) {
                 break;
             }
-            result.value = std::numeric_limits<qreal>::quiet_NaN();
-            result.key = 0.0;
-            for (const QModelIndex &index : indexes) {
-                const qreal value = m_modelCache.data(index);
-                if (!ISNAN(value)) {
-                    result.value = ISNAN(result.value) ? value : result.value + value;
+            if (m_numericModel) {
+                // the rows of a data point are adjacent in the array of their column
+                const Aggregated aggregated = aggregateValues(m_numericModel->column(position.column),
+                                                              indexes.first().row(), indexes.last().row() + 1,
+                                                              aggregationMode(position.column));
+                key = aggregated.key;
+                value = aggregated.value;
+                sourceRow = aggregated.sourceRow;
+            } else {
+                Aggregate aggregate(aggregationMode(position.column));
+                for (const QModelIndex &index : indexes) {
+                    aggregate.add(index.row(), modelValue(index));
                 }
-                result.key += index.row();
+                key = aggregate.key();
+                value = aggregate.value();
+                // the index of an aggregated data point is the one its value comes from
+                sourceRow = aggregate.sourceRow();
             }
-            result.index = indexes.at(0);
-            result.key /= indexes.size();
-            result.value /= indexes.size();
         }
 
         for (const QModelIndex &index : indexes) {
             // the DataPoint point is visible if any of the underlying, aggregated points is visible
             if (m_model->data(index, DataHiddenRole).value<bool>() == false) {
-                result.hidden = false;
+                hidden = false;
+                break;
             }
         }
         break;
@@ -504,8 +1077,13 @@ void CartesianDiagramDataCompressor::retrieveModelData(const CachePosition &posi
         break;
     }
 
-    m_data[position.column][position.row] = result;
-    Q_ASSERT(isCached(position));
+    // without a row to come from, the data point stays uncached, and hidden
+    if (sourceRow >= 0) {
+        m_data[position.column].set(position.row, key, value, sourceRow, hidden);
+        Q_ASSERT(isCached(position));
+    } else {
+        m_data[position.column].flags[position.row] = Dataset::Hidden;
+    }
 }
 
 CartesianDiagramDataCompressor::CachePosition CartesianDiagramDataCompressor::mapToCache(
@@ -532,7 +1110,8 @@ CartesianDiagramDataCompressor::CachePosition CartesianDiagramDataCompressor::ma
     if (indexesPerPixel() == 0) {
         return mapToCache(QModelIndex());
     }
-    return CachePosition(int(row / indexesPerPixel()), column / m_datasetDimension);
+    const int effectiveDimension = m_datasetDimension == 2 ? 2 : 1;
+    return CachePosition(int(row / indexesPerPixel()), column / effectiveDimension);
 }
 
 QModelIndexList CartesianDiagramDataCompressor::mapToModel(const CachePosition &position) const
@@ -552,7 +1131,7 @@ QModelIndexList CartesianDiagramDataCompressor::mapToModel(const CachePosition &
         const qreal ipp = indexesPerPixel();
         const int baseRow = floor(position.row * ipp);
         // the following line needs to work for the last row(s), too...
-        const int endRow = floor((position.row + 1) * ipp);
+        const int endRow = qMin(int(floor((position.row + 1) * ipp)), m_model->rowCount(m_rootIndex));
         for (int row = baseRow; row < endRow; ++row) {
             Q_ASSERT(row < m_model->rowCount(m_rootIndex));
             const QModelIndex index = m_model->index(row, position.column, m_rootIndex);
@@ -569,6 +1148,9 @@ qreal CartesianDiagramDataCompressor::indexesPerPixel() const
     if (!m_model || m_data.size() == 0 || m_data[0].size() == 0) {
         return 0;
     }
+    if (m_bucketRows) {
+        return m_bucketRows;
+    }
     return qreal(m_model->rowCount(m_rootIndex)) / qreal(m_data[0].size());
 }
 
@@ -580,7 +1162,7 @@ bool CartesianDiagramDataCompressor::mapsToModelIndex(const CachePosition &posit
 void CartesianDiagramDataCompressor::invalidate(const CachePosition &position)
 {
     if (mapsToModelIndex(position)) {
-        m_data[position.column][position.row] = DataPoint();
+        m_data[position.column].clear(position.row);
         // Also invalidate the data value attributes at "position".
         // Otherwise the user overwrites the attributes without us noticing
         // it because we keep reading what's in the cache.
@@ -591,8 +1173,7 @@ void CartesianDiagramDataCompressor::invalidate(const CachePosition &position)
 bool CartesianDiagramDataCompressor::isCached(const CachePosition &position) const
 {
     Q_ASSERT(mapsToModelIndex(position));
-    const DataPoint &p = m_data[position.column][position.row];
-    return p.index.isValid();
+    return m_data[position.column].flags.at(position.row) & Dataset::Cached;
 }
 
 void CartesianDiagramDataCompressor::calculateSampleStepWidth()
@@ -629,6 +1210,15 @@ void CartesianDiagramDataCompressor::calculateSampleStepWidth()
     }
 }
 
+void CartesianDiagramDataCompressor::setAggregationPattern(const QVector<AggregationMode> &pattern)
+{
+    if (pattern != m_aggregationPattern) {
+        m_aggregationPattern = pattern;
+        rebuildCache();
+        calculateSampleStepWidth();
+    }
+}
+
 void CartesianDiagramDataCompressor::setDatasetDimension(int dimension)
 {
     if (dimension != m_datasetDimension) {
@@ -637,3 +1227,205 @@ void CartesianDiagramDataCompressor::setDatasetDimension(int dimension)
         calculateSampleStepWidth();
     }
 }
+
+void CartesianDiagramDataCompressor::setAsynchronousPreparation(bool enabled)
+{
+    if (enabled != m_asynchronousPreparation) {
+        m_asynchronousPreparation = enabled;
+        rebuildCache();
+    }
+}
+
+bool CartesianDiagramDataCompressor::asynchronousPreparation() const
+{
+    return m_asynchronousPreparation;
+}
+
+bool CartesianDiagramDataCompressor::isPreparing() const
+{
+    return !m_preparation.isNull();
+}
+
+void CartesianDiagramDataCompressor::startPreparation()
+{
+    cancelPreparation();
+    // only a NumericDataModel can be read from another thread, through a copy of its columns
+    if (!m_asynchronousPreparation || !m_numericModel || m_datasetDimension == 2 || m_data.isEmpty()) {
+        return;
+    }
+    const int rowCount = m_model->rowCount(m_rootIndex);
+    const int pointCount = m_data.first().size();
+    if (rowCount < MinimumAsynchronousRows || pointCount == 0) {
+        return;
+    }
+
+    QSharedPointer<Preparation> preparation = QSharedPointer<Preparation>::create();
+    preparation->compressor = this;
+    preparation->generation = ++m_preparationGeneration;
+    preparation->rowCount = rowCount;
+    preparation->pointCount = pointCount;
+    preparation->aggregationPattern = m_aggregationPattern;
+    preparation->columns.reserve(m_data.size());
+    for (int column = 0; column < m_data.size(); ++column) {
+        preparation->columns.append(m_numericModel->column(column));
+    }
+
+    // until the worker is done, each data point shows the value of its middle row
+    const qreal ipp = indexesPerPixel();
+    for (int column = 0; column < m_data.size(); ++column) {
+        Dataset &data = m_data[column];
+        bool columnHidden = false;
+        const bool uniform = uniformHiddenState(column, &columnHidden);
+        for (int row = 0; row < data.size(); ++row) {
+            const int baseRow = floor(row * ipp);
+            const int endRow = floor((row + 1) * ipp);
+            const int sampleRow = (baseRow + endRow - 1) / 2;
+            const bool hidden = uniform
+                ? columnHidden
+                : m_model->data(m_model->index(sampleRow, column, m_rootIndex), DataHiddenRole).value<bool>();
+            data.set(row, (baseRow + endRow - 1) / 2.0, m_numericModel->value(sampleRow, column), sampleRow, hidden);
+        }
+    }
+
+    m_preparation = preparation;
+    QThreadPool::globalInstance()->start([preparation]() {
+        runPreparation(preparation);
+    });
+}
+
+void CartesianDiagramDataCompressor::cancelPreparation()
+{
+    if (m_preparation) {
+        QMutexLocker locker(&m_preparation->mutex);
+        m_preparation->compressor = nullptr;
+        m_preparation->canceled.storeRelease(1);
+    }
+    m_preparation.reset();
+    m_changedWhilePreparing.clear();
+}
+
+bool CartesianDiagramDataCompressor::restartPreparation(bool changeDone)
+{
+    if (!m_preparation) {
+        return false;
+    }
+    if (changeDone) {
+        rebuildCache();
+    }
+    return true;
+}
+
+bool CartesianDiagramDataCompressor::uniformHiddenState(int column, bool *hidden) const
+{
+    // a NumericDataModel has no DataHiddenRole of its own, so only cells set in
+    // the AttributesModel can differ from the dataset
+    const auto *attributesModel = qobject_cast<const AttributesModel *>(m_model.data());
+    if (!attributesModel || !m_numericModel || attributesModel->hasCellData(column, DataHiddenRole)) {
+        return false;
+    }
+    *hidden = attributesModel->data(column, DataHiddenRole).value<bool>();
+    return true;
+}
+
+// runs on a worker thread, and must only touch the preparation
+void CartesianDiagramDataCompressor::runPreparation(const QSharedPointer<Preparation> &preparation)
+{
+    Preparation &p = *preparation;
+    const qreal ipp = qreal(p.rowCount) / qreal(p.pointCount);
+    const int pointTotal = p.columns.size() * p.pointCount;
+    int reportedPercent = 0;
+
+    p.points.resize(p.columns.size());
+    for (int column = 0; column < p.columns.size(); ++column) {
+        const QVector<qreal> &values = p.columns.at(column);
+        const AggregationMode mode = p.aggregationPattern.isEmpty()
+            ? AverageAggregation
+            : p.aggregationPattern.at(column % p.aggregationPattern.size());
+        QVector<Preparation::Point> &points = p.points[column];
+        points.resize(p.pointCount);
+        for (int point = 0; point < p.pointCount; ++point) {
+            if (p.canceled.loadAcquire()) {
+                return;
+            }
+            const int baseRow = floor(point * ipp);
+            const int endRow = floor((point + 1) * ipp);
+            const Aggregated aggregated = aggregateValues(values, baseRow, endRow, mode);
+            const Preparation::Point result = {aggregated.key, aggregated.value, aggregated.sourceRow};
+            points[point] = result;
+
+            const int percent = int(qint64(100) * (column * p.pointCount + point + 1) / pointTotal);
+            if (percent != reportedPercent && percent < 100) {
+                reportedPercent = percent;
+                QMutexLocker locker(&p.mutex);
+                if (CartesianDiagramDataCompressor *compressor = p.compressor) {
+                    const int generation = p.generation;
+                    QMetaObject::invokeMethod(
+                        compressor, [compressor, generation, percent]() {
+                            compressor->preparationProgressed(generation, percent);
+                        },
+                        Qt::QueuedConnection);
+                }
+            }
+        }
+    }
+
+    QMutexLocker locker(&p.mutex);
+    if (CartesianDiagramDataCompressor *compressor = p.compressor) {
+        const int generation = p.generation;
+        QMetaObject::invokeMethod(
+            compressor, [compressor, generation]() {
+                compressor->preparationDone(generation);
+            },
+            Qt::QueuedConnection);
+    }
+}
+
+void CartesianDiagramDataCompressor::preparationProgressed(int generation, int percent)
+{
+    if (m_preparation && m_preparation->generation == generation) {
+        Q_EMIT preparationProgress(percent);
+    }
+}
+
+void CartesianDiagramDataCompressor::preparationDone(int generation)
+{
+    if (!m_preparation || m_preparation->generation != generation) {
+        return;
+    }
+    // any change of the cache geometry would have restarted the preparation
+    const QSharedPointer<Preparation> preparation = m_preparation;
+    m_preparation.reset();
+    Q_ASSERT(preparation->points.size() == m_data.size());
+
+    const qreal ipp = indexesPerPixel();
+    for (int column = 0; column < m_data.size(); ++column) {
+        const QVector<Preparation::Point> &points = preparation->points.at(column);
+        Dataset &data = m_data[column];
+        Q_ASSERT(points.size() == data.size());
+        bool columnHidden = false;
+        const bool uniform = uniformHiddenState(column, &columnHidden);
+        for (int row = 0; row < data.size(); ++row) {
+            const Preparation::Point &prepared = points.at(row);
+            // the data point is visible if any of the aggregated rows is visible
+            bool hidden = columnHidden;
+            if (!uniform) {
+                hidden = true;
+                const int endRow = floor((row + 1) * ipp);
+                for (int modelRow = floor(row * ipp); modelRow < endRow; ++modelRow) {
+                    if (m_model->data(m_model->index(modelRow, column, m_rootIndex), DataHiddenRole).value<bool>() == false) {
+                        hidden = false;
+                        break;
+                    }
+                }
+            }
+            data.set(row, prepared.key, prepared.value, prepared.row, hidden);
+        }
+    }
+    // the worker read the values from before these changes
+    for (const CachePosition &position : qAsConst(m_changedWhilePreparing)) {
+        invalidate(position);
+    }
+    m_changedWhilePreparing.clear();
+    m_dataValueAttributesCache.clear();
+    Q_EMIT preparationFinished();
+}
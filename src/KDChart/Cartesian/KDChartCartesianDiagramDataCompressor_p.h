@@ -28,6 +28,7 @@
 #include <QObject>
 #include <QPair>
 #include <QPointer>
+#include <QSharedPointer>
 #include <QVector>
 
 #include "KDChartDataValueAttributes.h"
@@ -43,6 +44,7 @@ QT_END_NAMESPACE
 namespace KDChart {
 
 class AbstractDiagram;
+class NumericDataModel;
 
 // - transparently compress table model data if the diagram widget
 // size does not allow to display all data points in an acceptable way
@@ -64,6 +66,7 @@ class KDCHART_EXPORT CartesianDiagramDataCompressor : public QObject
     friend class AbstractCartesianDiagram;
 
 public:
+    // a data point as returned by data(); the cache itself keeps no model indexes
     class DataPoint
     {
     public:
@@ -77,7 +80,6 @@ public:
         bool hidden = false;
         QModelIndex index;
     };
-    typedef QVector<DataPoint> DataPointVector;
     class CachePosition
     {
     public:
@@ -119,7 +121,18 @@ public:
         SamplingSeven
     };
 
+    // how the values of all rows that fall into one pixel are combined
+    enum AggregationMode
+    {
+        AverageAggregation,
+        FirstAggregation,
+        LastAggregation,
+        MaximumAggregation,
+        MinimumAggregation
+    };
+
     explicit CartesianDiagramDataCompressor(QObject *parent = nullptr);
+    ~CartesianDiagramDataCompressor() override;
 
     // input: model, chart resolution, approximation mode
     void setModel(QAbstractItemModel *);
@@ -128,12 +141,26 @@ public:
     void recalcResolution();
     void setApproximationMode(ApproximationMode mode);
     void setDatasetDimension(int dimension);
+    // the aggregation of each column, repeated for every pattern.size() columns;
+    // without a pattern, values are averaged, and datasets with a dimension
+    // other than 1 are not compressed at all
+    void setAggregationPattern(const QVector<AggregationMode> &pattern);
+    // compress the values of large NumericDataModels on a worker thread; until
+    // preparationFinished() one sample of the rows of each data point is shown
+    void setAsynchronousPreparation(bool enabled);
+    bool asynchronousPreparation() const;
+    bool isPreparing() const;
 
     // output: resulting model resolution, data points
     // FIXME (Mirko) rather stupid naming, Mirko!
     int modelDataColumns() const;
     int modelDataRows() const;
-    const DataPoint &data(const CachePosition &) const;
+    DataPoint data(const CachePosition &) const;
+    // parts of data(), without building the model index of the data point
+    qreal key(const CachePosition &) const;
+    qreal value(const CachePosition &) const;
+    bool isHidden(const CachePosition &) const;
+    QModelIndex index(const CachePosition &) const;
 
     QPair<QPointF, QPointF> dataBoundaries() const;
 
@@ -142,6 +169,10 @@ public:
         const QModelIndex &index,
         const CachePosition &position) const;
 
+Q_SIGNALS:
+    void preparationProgress(int percent);
+    void preparationFinished();
+
 private Q_SLOTS:
     void slotRowsAboutToBeInserted(const QModelIndex &, int, int);
     void slotRowsInserted(const QModelIndex &, int, int);
@@ -156,6 +187,7 @@ private Q_SLOTS:
     void slotModelHeaderDataChanged(Qt::Orientation, int, int);
     void slotModelDataChanged(const QModelIndex &, const QModelIndex &);
     void slotModelLayoutChanged();
+    void slotSourceModelChanged();
     // FIXME resolution changes and root index changes should all
     // be catchable with this method:
     void slotDiagramLayoutChanged(AbstractDiagram *);
@@ -183,15 +215,47 @@ private:
     bool prepareDataChange(const QModelIndex &parent,
                            bool isRows, /* columns otherwise */
                            int *start, int *end);
-
+    // check if rows are added after the last row of a compressible dataset
+    bool isAppend(const QModelIndex &parent, int start, int end, bool inserted) const;
+    // fold the rows added at the end into the data points, merging them pairwise
+    // as often as needed to stay within the resolution
+    void appendRows(int start, int end);
+    // halve the number of data points covering the first rowCount rows
+    void mergeDataPoints(int rowCount);
+    AggregationMode aggregationMode(int column) const;
+
+    // find out if the values can be read directly from a NumericDataModel,
+    // or else from the cache shared with other diagrams showing the same model
+    void updateModelSource();
+    // the value of a model cell, bypassing QVariant for a NumericDataModel
+    qreal modelValue(const QModelIndex &) const;
+    // the data compressed on a worker thread, and the state shared with it
+    struct Preparation;
+    // start compressing the data on a worker thread if the model allows it
+    void startPreparation();
+    void cancelPreparation();
+    // a running preparation is outdated by a change of the rows or columns; the cache is rebuilt
+    // once the change is done instead of being updated
+    bool restartPreparation(bool changeDone);
+    static void runPreparation(const QSharedPointer<Preparation> &);
+    // the hidden state shared by all rows of a column if DataHiddenRole is only set
+    // per dataset or diagram; false if the rows have to be looked up one by one
+    bool uniformHiddenState(int column, bool *hidden) const;
+    void preparationProgressed(int generation, int percent);
+    void preparationDone(int generation);
     // retrieve data from the model, put it into the cache
     void retrieveModelData(const CachePosition &) const;
     // check if a data point is in the cache:
     bool isCached(const CachePosition &) const;
+    // make sure the data point is cached, if the position is valid
+    bool fetch(const CachePosition &) const;
+    // the model index of a cached data point
+    QModelIndex modelIndex(const CachePosition &) const;
     // set sample step width according to settings:
     void calculateSampleStepWidth();
 
     QPointer<QAbstractItemModel> m_model;
+    QPointer<NumericDataModel> m_numericModel;
     QModelIndex m_rootIndex;
 
     ApproximationMode m_mode = Precise;
@@ -199,10 +263,52 @@ private:
     int m_yResolution = 0;
     unsigned int m_sampleStep = 0;
 
-    mutable QVector<DataPointVector> m_data; // one per dataset
+    // the data points of one dataset, with one array per member to keep large caches small
+    struct Dataset
+    {
+        enum Flag : quint8
+        {
+            Cached = 0x1,
+            Hidden = 0x2
+        };
+
+        QVector<qreal> keys;
+        QVector<qreal> values;
+        QVector<quint8> flags;
+        // the model row of each point, only allocated once a point does not come
+        // from the row of the same number, as it does without compression
+        QVector<int> sourceRows;
+
+        int size() const
+        {
+            return keys.size();
+        }
+        int sourceRow(int row) const
+        {
+            return sourceRows.isEmpty() ? row : sourceRows.at(row);
+        }
+        // all new points are empty
+        void resize(int size);
+        void insert(int row, int count);
+        void remove(int row, int count);
+        void clear(int row);
+        void clear();
+        void set(int row, qreal key, qreal value, int sourceRow, bool hidden);
+    };
+    mutable QVector<Dataset> m_data;
     ModelDataCache<qreal, Qt::DisplayRole> m_modelCache;
+    SharedModelDataCache *m_sharedModelCache = nullptr;
     mutable DataValueAttributesCache m_dataValueAttributesCache;
+    // the number of rows of each data point once rows were appended, or 0 while
+    // the rows are spread evenly over the data points
+    int m_bucketRows = 0;
     int m_datasetDimension = 1;
+    QVector<AggregationMode> m_aggregationPattern;
+    bool m_asynchronousPreparation = false;
+    QSharedPointer<Preparation> m_preparation;
+    int m_preparationGeneration = 0;
+    // data points whose data changed after the preparation copied the model
+    QVector<CachePosition> m_changedWhilePreparing;
 };
 }
 
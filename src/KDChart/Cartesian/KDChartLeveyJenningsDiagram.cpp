@@ -286,18 +286,42 @@ float LeveyJenningsDiagram::expectedStandardDeviation() const
 
 /**
  * Returns the calculated mean values over all QC values.
+ * \sa setStatisticsWindow
  */
 float LeveyJenningsDiagram::calculatedMeanValue() const
 {
-    return d->calculatedMeanValue;
+    return d->statistics.mean();
 }
 
 /**
  * Returns the calculated standard deviation over all QC values.
+ * \sa setStatisticsWindow
  */
 float LeveyJenningsDiagram::calculatedStandardDeviation() const
 {
-    return d->calculatedStandardDeviation;
+    return d->statistics.standardDeviation();
+}
+
+/**
+ * Restricts the calculated mean value and standard deviation to the QC values
+ * of the last \a rows rows of the model. Set it to 0 (default) to use all QC values.
+ */
+void LeveyJenningsDiagram::setStatisticsWindow(int rows)
+{
+    if (d->statistics.window() == rows)
+        return;
+
+    d->statistics.setWindow(rows);
+    update();
+}
+
+/**
+ * Returns the number of rows the calculated values are restricted to,
+ * or 0 if all QC values are used.
+ */
+int LeveyJenningsDiagram::statisticsWindow() const
+{
+    return d->statistics.window();
 }
 
 void LeveyJenningsDiagram::setModel(QAbstractItemModel *newModel)
@@ -305,11 +329,11 @@ void LeveyJenningsDiagram::setModel(QAbstractItemModel *newModel)
     QAbstractItemModel *oldModel = model();
     if (oldModel != nullptr) {
         disconnect(oldModel, &QAbstractItemModel::dataChanged,
-                   this, &LeveyJenningsDiagram::calculateMeanAndStandardDeviation);
+                   this, &LeveyJenningsDiagram::slotDataChanged);
         disconnect(oldModel, &QAbstractItemModel::rowsInserted,
-                   this, &LeveyJenningsDiagram::calculateMeanAndStandardDeviation);
+                   this, &LeveyJenningsDiagram::slotRowsInserted);
         disconnect(oldModel, &QAbstractItemModel::rowsRemoved,
-                   this, &LeveyJenningsDiagram::calculateMeanAndStandardDeviation);
+                   this, &LeveyJenningsDiagram::slotRowsRemoved);
         disconnect(oldModel, &QAbstractItemModel::columnsInserted,
                    this, &LeveyJenningsDiagram::calculateMeanAndStandardDeviation);
         disconnect(oldModel, &QAbstractItemModel::columnsRemoved,
@@ -322,11 +346,11 @@ void LeveyJenningsDiagram::setModel(QAbstractItemModel *newModel)
     LineDiagram::setModel(newModel);
     if (newModel != nullptr) {
         connect(newModel, &QAbstractItemModel::dataChanged,
-                this, &LeveyJenningsDiagram::calculateMeanAndStandardDeviation);
+                this, &LeveyJenningsDiagram::slotDataChanged);
         connect(newModel, &QAbstractItemModel::rowsInserted,
-                this, &LeveyJenningsDiagram::calculateMeanAndStandardDeviation);
+                this, &LeveyJenningsDiagram::slotRowsInserted);
         connect(newModel, &QAbstractItemModel::rowsRemoved,
-                this, &LeveyJenningsDiagram::calculateMeanAndStandardDeviation);
+                this, &LeveyJenningsDiagram::slotRowsRemoved);
         connect(newModel, &QAbstractItemModel::columnsInserted,
                 this, &LeveyJenningsDiagram::calculateMeanAndStandardDeviation);
         connect(newModel, &QAbstractItemModel::columnsRemoved,
@@ -337,39 +361,58 @@ void LeveyJenningsDiagram::setModel(QAbstractItemModel *newModel)
                 this, &LeveyJenningsDiagram::calculateMeanAndStandardDeviation);
 
         calculateMeanAndStandardDeviation();
+    } else {
+        d->statistics.setValues(QVector<qreal>());
     }
 }
 
-// TODO: This is the 'easy' solution
-// evaluate whether this is enough or we need some better one or even boost here
+/**
+ * Calculates the mean value and standard deviation of all QC values again.
+ *
+ * This is not needed when the model emits the usual change signals; rows being
+ * inserted, removed or changed only update the statistics of the affected rows.
+ */
 void LeveyJenningsDiagram::calculateMeanAndStandardDeviation() const
 {
-    QVector<qreal> values;
-    // first fetch all values
-    const QAbstractItemModel &m = *model();
-    const int rowCount = m.rowCount(rootIndex());
+    if (model() == nullptr)
+        return;
+    const int rowCount = model()->rowCount(rootIndex());
+    d->statistics.setValues(d->qcValues(0, rowCount - 1));
+}
 
-    for (int row = 0; row < rowCount; ++row) {
-        const QVariant var = m.data(m.index(row, 1, rootIndex()));
-        if (!var.isValid())
-            continue;
-        const qreal value = var.toReal();
-        if (ISNAN(value))
-            continue;
-        values << value;
+void LeveyJenningsDiagram::slotRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent != rootIndex())
+        return;
+    if (d->statistics.rowCount() + last - first + 1 != model()->rowCount(rootIndex())) {
+        calculateMeanAndStandardDeviation();
+        return;
     }
+    d->statistics.insertValues(first, d->qcValues(first, last));
+}
 
-    qreal sum = 0.0;
-    qreal sumSquares = 0.0;
-    for (qreal value : qAsConst(values)) {
-        sum += value;
-        sumSquares += value * value;
+void LeveyJenningsDiagram::slotRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent != rootIndex())
+        return;
+    if (d->statistics.rowCount() - (last - first + 1) != model()->rowCount(rootIndex())) {
+        calculateMeanAndStandardDeviation();
+        return;
     }
+    d->statistics.removeValues(first, last - first + 1);
+}
 
-    const int N = values.count();
-
-    d->calculatedMeanValue = sum / N;
-    d->calculatedStandardDeviation = sqrt((static_cast<qreal>(N) * sumSquares - sum * sum) / (N * (N - 1)));
+void LeveyJenningsDiagram::slotDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (topLeft.parent() != rootIndex() || topLeft.column() > 1 || bottomRight.column() < 1)
+        return;
+    if (bottomRight.row() >= d->statistics.rowCount()) {
+        calculateMeanAndStandardDeviation();
+        return;
+    }
+    const QVector<qreal> values = d->qcValues(topLeft.row(), bottomRight.row());
+    for (int i = 0; i < values.size(); ++i)
+        d->statistics.setValue(topLeft.row() + i, values.at(i));
 }
 
 // calculates the largest QDate not greater than \a dt.
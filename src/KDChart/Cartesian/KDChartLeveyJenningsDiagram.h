@@ -76,6 +76,9 @@ public:
     float calculatedMeanValue() const;
     float calculatedStandardDeviation() const;
 
+    void setStatisticsWindow(int rows);
+    int statisticsWindow() const;
+
     void setFluidicsPackChanges(const QVector<QDateTime> &changes);
     QVector<QDateTime> fluidicsPackChanges() const;
 
@@ -112,6 +115,11 @@ protected:
 
 protected Q_SLOTS:
     void calculateMeanAndStandardDeviation() const;
+
+private Q_SLOTS:
+    void slotRowsInserted(const QModelIndex &parent, int first, int last);
+    void slotRowsRemoved(const QModelIndex &parent, int first, int last);
+    void slotDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
 }; // End of class KDChartLineDiagram
 }
 
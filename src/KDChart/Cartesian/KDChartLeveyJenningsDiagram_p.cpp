@@ -13,8 +13,129 @@
 
 #include "KDChartLeveyJenningsDiagram_p.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 using namespace KDChart;
 
+void LeveyJenningsStatistics::setWindow(int rows)
+{
+    m_window = qMax(0, rows);
+    recalculate();
+}
+
+void LeveyJenningsStatistics::setValues(const QVector<qreal> &values)
+{
+    m_values = values;
+    recalculate();
+}
+
+void LeveyJenningsStatistics::insertValues(int first, const QVector<qreal> &values)
+{
+    Q_ASSERT(first >= 0 && first <= m_values.size());
+    const int count = values.size();
+    const int oldStart = windowStart();
+    m_values.insert(first, count, std::numeric_limits<qreal>::quiet_NaN());
+    std::copy(values.constBegin(), values.constEnd(), m_values.begin() + first);
+    const int newStart = windowStart();
+
+    // rows that were pushed out of the window, in front of and behind the inserted ones
+    for (int row = oldStart; row < qMin(first, newStart); ++row)
+        remove(m_values.at(row));
+    for (int row = qMax(first, oldStart) + count; row < newStart; ++row)
+        remove(m_values.at(row));
+    for (int row = qMax(first, newStart); row < first + count; ++row)
+        add(m_values.at(row));
+    recalculateIfInaccurate();
+}
+
+void LeveyJenningsStatistics::removeValues(int first, int count)
+{
+    Q_ASSERT(first >= 0 && count >= 0 && first + count <= m_values.size());
+    const int oldStart = windowStart();
+    for (int row = qMax(first, oldStart); row < first + count; ++row)
+        remove(m_values.at(row));
+    m_values.remove(first, count);
+    const int newStart = windowStart();
+
+    // rows in front of the removed ones that moved into the window
+    for (int row = newStart; row < qMin(first, oldStart); ++row)
+        add(m_values.at(row));
+    recalculateIfInaccurate();
+}
+
+void LeveyJenningsStatistics::setValue(int row, qreal value)
+{
+    Q_ASSERT(row >= 0 && row < m_values.size());
+    if (row >= windowStart()) {
+        remove(m_values.at(row));
+        add(value);
+    }
+    m_values[row] = value;
+    recalculateIfInaccurate();
+}
+
+qreal LeveyJenningsStatistics::mean() const
+{
+    return m_count > 0 ? m_mean : std::numeric_limits<qreal>::quiet_NaN();
+}
+
+qreal LeveyJenningsStatistics::standardDeviation() const
+{
+    return m_count > 1 ? std::sqrt(m_m2 / (m_count - 1)) : std::numeric_limits<qreal>::quiet_NaN();
+}
+
+int LeveyJenningsStatistics::windowStart() const
+{
+    return m_window > 0 ? qMax(0, m_values.size() - m_window) : 0;
+}
+
+void LeveyJenningsStatistics::add(qreal value)
+{
+    if (ISNAN(value))
+        return;
+    ++m_count;
+    const qreal delta = value - m_mean;
+    m_mean += delta / m_count;
+    m_m2 += delta * (value - m_mean);
+}
+
+void LeveyJenningsStatistics::remove(qreal value)
+{
+    if (ISNAN(value))
+        return;
+    ++m_removals;
+    if (m_count <= 1) {
+        m_count = 0;
+        m_mean = 0.0;
+        m_m2 = 0.0;
+        return;
+    }
+    // the inverse of add()
+    const qreal delta = value - m_mean;
+    --m_count;
+    m_mean -= delta / m_count;
+    m_m2 = qMax(qreal(0.0), m_m2 - delta * (value - m_mean));
+}
+
+void LeveyJenningsStatistics::recalculate()
+{
+    m_count = 0;
+    m_removals = 0;
+    m_mean = 0.0;
+    m_m2 = 0.0;
+    for (int row = windowStart(); row < m_values.size(); ++row)
+        add(m_values.at(row));
+}
+
+void LeveyJenningsStatistics::recalculateIfInaccurate()
+{
+    // amortized, this keeps the cost of a removal constant
+    if (m_removals > m_count)
+        recalculate();
+}
+
 LeveyJenningsDiagram::Private::Private(const Private &rhs)
     : LineDiagram::Private(rhs)
     , lotChangedPosition(rhs.lotChangedPosition)
@@ -27,6 +148,20 @@ LeveyJenningsDiagram::Private::Private(const Private &rhs)
     , expectedMeanValue(rhs.expectedMeanValue)
     , expectedStandardDeviation(rhs.expectedStandardDeviation)
 {
+    statistics.setWindow(rhs.statistics.window());
+}
+
+QVector<qreal> LeveyJenningsDiagram::Private::qcValues(int first, int last) const
+{
+    const QAbstractItemModel &m = *diagram->model();
+    const QModelIndex root = diagram->rootIndex();
+    QVector<qreal> values;
+    values.reserve(last - first + 1);
+    for (int row = first; row <= last; ++row) {
+        const QVariant var = m.data(m.index(row, 1, root));
+        values << (var.isValid() ? var.toReal() : std::numeric_limits<qreal>::quiet_NaN());
+    }
+    return values;
 }
 
 void LeveyJenningsDiagram::Private::setYAxisRange() const
@@ -37,6 +37,63 @@ namespace KDChart {
 
 class PaintContext;
 
+/**
+ * \internal
+ * Mean and sample standard deviation of the QC values of a Levey Jennings diagram.
+ *
+ * The value of each row is kept, so that rows can be inserted, removed and changed
+ * with the cost depending on the number of affected rows only. The values are
+ * accumulated with Welford's algorithm; to keep rounding errors of repeated
+ * removals from piling up, the sums are recalculated from the kept values once
+ * there have been more removals than values.
+ *
+ * With a window set, only the values of the last window() rows are taken into
+ * account.
+ */
+class LeveyJenningsStatistics
+{
+public:
+    void setWindow(int rows);
+    int window() const
+    {
+        return m_window;
+    }
+
+    /** Replaces all values. Empty rows are NaN. */
+    void setValues(const QVector<qreal> &values);
+    /** Inserts \a values so that the first of them ends up in row \a first. */
+    void insertValues(int first, const QVector<qreal> &values);
+    void removeValues(int first, int count);
+    void setValue(int row, qreal value);
+
+    /** Returns the number of rows, including empty ones. */
+    int rowCount() const
+    {
+        return m_values.size();
+    }
+    /** Returns the number of values the statistics are calculated from. */
+    int count() const
+    {
+        return m_count;
+    }
+    qreal mean() const;
+    qreal standardDeviation() const;
+
+private:
+    int windowStart() const;
+    void add(qreal value);
+    void remove(qreal value);
+    void recalculate();
+    void recalculateIfInaccurate();
+
+    QVector<qreal> m_values;
+    int m_window = 0;
+    int m_count = 0;
+    int m_removals = 0;
+    qreal m_mean = 0.0;
+    qreal m_m2 = 0.0; // the sum of squared differences from the mean
+};
+
 /**
  * \internal
  */
@@ -50,6 +107,7 @@ public:
     ~Private() override;
 
     void setYAxisRange() const;
+    QVector<qreal> qcValues(int first, int last) const;
 
     Qt::Alignment lotChangedPosition;
     Qt::Alignment fluidicsPackChangedPosition;
@@ -68,8 +126,7 @@ public:
     float expectedMeanValue;
     float expectedStandardDeviation;
 
-    mutable float calculatedMeanValue;
-    mutable float calculatedStandardDeviation;
+    mutable LeveyJenningsStatistics statistics;
 };
 
 KDCHART_IMPL_DERIVED_DIAGRAM(LeveyJenningsDiagram, LineDiagram, LeveyJenningsCoordinatePlane)
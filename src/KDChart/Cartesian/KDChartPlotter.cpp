@@ -54,6 +54,13 @@ void Plotter::init()
     connect(this, &Plotter::attributesModelAboutToChange,
             this, &Plotter::connectAttributesModel);
     setDatasetDimensionInternal(2);
+
+    d->refinementTimer.setSingleShot(true);
+    connect(&d->refinementTimer, &QTimer::timeout, d, &Private::refine);
+    connect(this, &AbstractDiagram::modelsChanged, d, &Private::invalidateData);
+    connect(this, &AbstractDiagram::modelDataChanged, d, &Private::invalidateData);
+    connect(this, &AbstractDiagram::dataHidden, d, &Private::cancelRefinement);
+    connect(this, &AbstractDiagram::propertiesChanged, d, &Private::cancelRefinement);
 }
 
 Plotter::~Plotter()
@@ -88,6 +95,18 @@ void Plotter::connectAttributesModel(AttributesModel *newModel)
     // invocation order. Refer to the longer comment in
     // AbstractCartesianDiagram::connectAttributesModel() for details.
 
+    // the detected key order and the refined image depend on the rows
+    if (attributesModel())
+        disconnect(attributesModel(), nullptr, d, nullptr);
+    if (newModel) {
+        connect(newModel, &QAbstractItemModel::rowsInserted, d, &Private::invalidateData);
+        connect(newModel, &QAbstractItemModel::rowsRemoved, d, &Private::invalidateData);
+        connect(newModel, &QAbstractItemModel::columnsInserted, d, &Private::invalidateData);
+        connect(newModel, &QAbstractItemModel::columnsRemoved, d, &Private::invalidateData);
+        connect(newModel, &QAbstractItemModel::modelReset, d, &Private::invalidateData);
+        connect(newModel, &QAbstractItemModel::layoutChanged, d, &Private::invalidateData);
+    }
+
     if (useDataCompression() == Plotter::NONE) {
         d->plotterCompressor.setModel(nullptr);
         AbstractCartesianDiagram::connectAttributesModel(newModel);
@@ -148,6 +167,86 @@ void Plotter::setMergeRadiusPercentage(qreal value)
     }
 }
 
+/**
+ * Sets whether large datasets are painted progressively. This is off by default.
+ *
+ * If enabled, a normal plotter without data compression that has many more rows than
+ * pixels first paints a coarse sample of its rows. All rows are then painted in steps
+ * of about progressiveFrameBudget() milliseconds each, between which the event loop
+ * keeps running. refinementFinished() is emitted when the result is shown. Zooming,
+ * panning, resizing or changing the data starts over with a coarse sample.
+ *
+ * When painting into an image or a printer, disable progressive rendering or wait for
+ * refinementFinished() first.
+ */
+void Plotter::setProgressiveRendering(bool enabled)
+{
+    if (d->progressiveRendering != enabled) {
+        d->progressiveRendering = enabled;
+        Q_EMIT propertiesChanged();
+    }
+}
+
+/**
+ * @return whether large datasets are painted progressively
+ */
+bool Plotter::progressiveRendering() const
+{
+    return d->progressiveRendering;
+}
+
+/**
+ * Sets the time spent painting rows at once during progressive rendering to \a msecs.
+ * The default is 16 milliseconds.
+ */
+void Plotter::setProgressiveFrameBudget(int msecs)
+{
+    d->progressiveFrameBudget = qMax(1, msecs);
+}
+
+/**
+ * @return the time spent painting rows at once during progressive rendering
+ */
+int Plotter::progressiveFrameBudget() const
+{
+    return d->progressiveFrameBudget;
+}
+
+/**
+ * @return true while a progressively rendered diagram is painting its rows in slices
+ */
+bool Plotter::isRefining() const
+{
+    return d->refinementTimer.isActive();
+}
+
+/**
+ * Sets whether the keys of each dataset are sorted to \a order. The default is DetectKeyOrder.
+ *
+ * A normal plotter without data compression only paints the rows of a dataset with sorted
+ * keys that are within the visible range of the coordinate plane, plus one row on each side,
+ * which it finds by binary search. Zoomed in views of long time series then paint as fast
+ * as short ones. DetectKeyOrder checks each dataset once after its data changed, SortedKeys
+ * skips the check, and UnsortedKeys always paints all rows.
+ *
+ * Use SortedKeys only if no key of the datasets is missing or decreasing.
+ */
+void Plotter::setKeyOrder(KeyOrder order)
+{
+    if (d->keyOrder != order) {
+        d->keyOrder = order;
+        Q_EMIT propertiesChanged();
+    }
+}
+
+/**
+ * @return whether the keys of each dataset are sorted, or if that is detected
+ */
+Plotter::KeyOrder Plotter::keyOrder() const
+{
+    return d->keyOrder;
+}
+
 /**
  * Sets the plotter's type to \a type
  */
@@ -404,10 +503,17 @@ void Plotter::paint(PaintContext *ctx)
     if (model()->rowCount(rootIndex()) == 0 || model()->columnCount(rootIndex()) == 0)
         return; // nothing to paint for us
 
+    const int progressiveStride = d->progressiveStride();
+    if (progressiveStride > 0 && d->paintRefinement(ctx))
+        return; // all rows have been painted before
+
     ctx->setCoordinatePlane(plane->sharedAxisMasterPlane(ctx->painter()));
 
     // paint different line types Normal - Stacked - Percent - Default Normal
-    d->implementor->paint(ctx);
+    if (progressiveStride > 0)
+        d->paintProgressively(ctx, progressiveStride);
+    else
+        d->implementor->paint(ctx);
 
     ctx->setCoordinatePlane(plane);
 }
@@ -29,6 +29,7 @@ class KDCHART_EXPORT Plotter : public AbstractCartesianDiagram
 
     Q_DISABLE_COPY(Plotter)
     Q_ENUMS(CompressionMode)
+    Q_ENUMS(KeyOrder)
 
     KDCHART_DECLARE_DERIVED_DIAGRAM(Plotter, CartesianCoordinatePlane)
     Q_PROPERTY(CompressionMode useDataCompression READ useDataCompression WRITE setUseDataCompression)
@@ -63,6 +64,17 @@ public:
         Percent
     };
 
+    /**
+     * Whether the keys of each dataset never decrease from one row to the next.
+     * \sa setKeyOrder
+     */
+    enum KeyOrder
+    {
+        DetectKeyOrder,
+        SortedKeys,
+        UnsortedKeys
+    };
+
     void setType(const PlotType type);
     PlotType type() const;
 
@@ -97,6 +109,15 @@ public:
     qreal mergeRadiusPercentage() const;
     void setMergeRadiusPercentage(qreal value);
 
+    void setProgressiveRendering(bool enabled);
+    bool progressiveRendering() const;
+    void setProgressiveFrameBudget(int msecs);
+    int progressiveFrameBudget() const;
+    bool isRefining() const;
+
+    void setKeyOrder(KeyOrder order);
+    KeyOrder keyOrder() const;
+
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0) && defined(Q_COMPILER_MANGLES_RETURN_TYPE)
     // implement AbstractCartesianDiagram
     /* reimp */
@@ -111,6 +132,10 @@ public:
     int numberOfOrdinateSegments() const override;
 #endif
 
+Q_SIGNALS:
+    /** Emitted when a progressively rendered diagram shows all of its rows. */
+    void refinementFinished();
+
 protected Q_SLOTS:
     void connectAttributesModel(AttributesModel *);
 
@@ -11,6 +11,8 @@
 #include "KDChartPlotterDiagramCompressor.h"
 
 #include "KDChartPlotterDiagramCompressor_p.h"
+
+#include "KDChartAggregationKernels_p.h"
 #include <QtCore/QPointF>
 
 #include <KDABLibFakes>
@@ -657,18 +659,25 @@ void PlotterDiagramCompressor::Private::calculateDataBoundaries()
         qreal minY = std::numeric_limits<qreal>::quiet_NaN();
         qreal maxX = std::numeric_limits<qreal>::quiet_NaN();
         qreal maxY = std::numeric_limits<qreal>::quiet_NaN();
+        const int rowCount = m_parent->rowCount();
+        QVector<qreal> keys(rowCount);
+        QVector<qreal> values(rowCount);
         for (int dataset = 0; dataset < m_parent->datasetCount(); ++dataset) {
-            for (int row = 0; row < m_parent->rowCount(); ++row) {
-                PlotterDiagramCompressor::DataPoint dp = m_parent->data(CachePosition(row, dataset));
-                minX = qMin(minX, dp.key);
-                minY = qMin(minY, dp.value);
-                maxX = qMax(dp.key, maxX);
-                maxY = qMax(dp.value, maxY);
-                Q_ASSERT(!ISNAN(minX));
-                Q_ASSERT(!ISNAN(minY));
-                Q_ASSERT(!ISNAN(maxX));
-                Q_ASSERT(!ISNAN(maxY));
+            for (int row = 0; row < rowCount; ++row) {
+                const PlotterDiagramCompressor::DataPoint dp = m_parent->data(CachePosition(row, dataset));
+                keys[row] = dp.key;
+                values[row] = dp.value;
+            }
+            const AggregationKernels::Boundaries boundaries =
+                AggregationKernels::boundaries(keys.constData(), values.constData(), rowCount);
+            if (ISNAN(boundaries.minimumKey)) {
+                continue;
             }
+            // the boundaries so far are NaN before the first dataset with data
+            minX = qMin(minX, boundaries.minimumKey);
+            minY = qMin(minY, boundaries.minimumValue);
+            maxX = qMax(boundaries.maximumKey, maxX);
+            maxY = qMax(boundaries.maximumValue, maxY);
         }
         if (forcedBoundaries(Qt::Vertical)) {
             minY = m_forcedYBoundaries.first;
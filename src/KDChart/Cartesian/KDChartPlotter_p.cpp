@@ -11,16 +11,27 @@
 #include "KDChartPlotter_p.h"
 #include "KDChartPlotter.h"
 
+#include "KDChartPaintContext.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartValueTrackerAttributes.h"
 #include "PaintingHelpers_p.h"
 
+#include <QElapsedTimer>
+
+#include <limits>
+
 using namespace KDChart;
 
+// rows painted at a time while refining; the frame budget is checked after each slice
+static const int RefinementSliceRows = 4096;
+
 Plotter::Private::Private(const Private &rhs)
     : QObject()
     , AbstractCartesianDiagram::Private(rhs)
     , useCompression(rhs.useCompression)
+    , progressiveRendering(rhs.progressiveRendering)
+    , progressiveFrameBudget(rhs.progressiveFrameBudget)
+    , keyOrder(rhs.keyOrder)
 {
 }
 
@@ -84,3 +95,180 @@ void Plotter::PlotterType::setUseCompression(Plotter::CompressionMode value)
 {
     m_private->useCompression = value;
 }
+
+bool Plotter::Private::hasSortedKeys(int column) const
+{
+    if (keyOrder != Plotter::DetectKeyOrder) {
+        return keyOrder == Plotter::SortedKeys;
+    }
+    const int columnCount = compressor.modelDataColumns();
+    if (detectedKeyOrders.size() != columnCount) {
+        detectedKeyOrders.fill(Plotter::DetectKeyOrder, columnCount);
+    }
+    if (detectedKeyOrders.at(column) == Plotter::DetectKeyOrder) {
+        // missing keys would leave holes in the binary search
+        bool sorted = true;
+        qreal lastKey = -std::numeric_limits<qreal>::infinity();
+        const int rowCount = compressor.modelDataRows();
+        for (int row = 0; row < rowCount && sorted; ++row) {
+            const qreal key = compressor.key(CartesianDiagramDataCompressor::CachePosition(row, column));
+            sorted = !ISNAN(key) && key >= lastKey;
+            lastKey = key;
+        }
+        detectedKeyOrders[column] = sorted ? Plotter::SortedKeys : Plotter::UnsortedKeys;
+    }
+    return detectedKeyOrders.at(column) == Plotter::SortedKeys;
+}
+
+void Plotter::Private::visibleRows(int column, const QRectF &visibleDataRange, int *begin, int *end) const
+{
+    const int rowCount = compressor.modelDataRows();
+    *begin = 0;
+    *end = rowCount;
+    if (!hasSortedKeys(column)) {
+        return;
+    }
+
+    const qreal left = qMin(visibleDataRange.left(), visibleDataRange.right());
+    const qreal right = qMax(visibleDataRange.left(), visibleDataRange.right());
+    const auto keyAt = [this, column](int row) {
+        return compressor.key(CartesianDiagramDataCompressor::CachePosition(row, column));
+    };
+    // the first row with a key of at least left, and the first one with a key beyond right
+    int low = 0;
+    int high = rowCount;
+    while (low < high) {
+        const int middle = low + (high - low) / 2;
+        if (keyAt(middle) < left) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    const int first = low;
+    high = rowCount;
+    while (low < high) {
+        const int middle = low + (high - low) / 2;
+        if (keyAt(middle) <= right) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    // the rows next to the visible ones connect to them with lines going out of view
+    *begin = qMax(0, first - 1);
+    *end = qMin(rowCount, low + 1);
+}
+
+int Plotter::Private::progressiveStride() const
+{
+    auto *plane = qobject_cast<CartesianCoordinatePlane *>(diagram->coordinatePlane());
+    if (!progressiveRendering || implementor != normalPlotter || useCompression != Plotter::NONE || !plane) {
+        return 0;
+    }
+    // only the visible rows count
+    int rowCount = 0;
+    for (int column = 0; column < compressor.modelDataColumns(); ++column) {
+        int begin;
+        int end;
+        visibleRows(column, plane->visibleDataRange(), &begin, &end);
+        rowCount = qMax(rowCount, end - begin);
+    }
+    // two rows per pixel are enough for a first impression
+    const int samples = 2 * qMax(1, plane->geometry().width());
+    const int stride = rowCount / samples;
+    return stride > 1 ? stride : 0;
+}
+
+bool Plotter::Private::paintRefinement(PaintContext *ctx)
+{
+    auto *plane = qobject_cast<CartesianCoordinatePlane *>(ctx->coordinatePlane());
+    QPainter *const painter = ctx->painter();
+    if (!plane) {
+        return false;
+    }
+
+    const qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+    if (refinement.drawingArea != ctx->rectangle() || refinement.visibleDataRange != plane->visibleDataRange()
+        || refinement.devicePixelRatio != devicePixelRatio || refinement.renderHints != painter->renderHints()) {
+        // resized, zoomed or panned: start over
+        cancelRefinement();
+        refinement.drawingArea = ctx->rectangle();
+        refinement.visibleDataRange = plane->visibleDataRange();
+        refinement.devicePixelRatio = devicePixelRatio;
+        refinement.renderHints = painter->renderHints();
+    }
+    if (!refinement.complete) {
+        return false;
+    }
+    painter->drawImage(refinement.drawingArea.toAlignedRect().topLeft(), refinement.image);
+    return true;
+}
+
+void Plotter::Private::paintProgressively(PaintContext *ctx, int stride)
+{
+    paintStride = stride;
+    implementor->paint(ctx);
+    paintStride = 1;
+    if (!refinementTimer.isActive()) {
+        refinementTimer.start();
+    }
+}
+
+void Plotter::Private::cancelRefinement()
+{
+    refinementTimer.stop();
+    refinement.image = QImage();
+    refinement.paintedRows = 0;
+    refinement.complete = false;
+}
+
+void Plotter::Private::invalidateData()
+{
+    cancelRefinement();
+    detectedKeyOrders.clear();
+}
+
+void Plotter::Private::refine()
+{
+    auto *plane = qobject_cast<CartesianCoordinatePlane *>(diagram->coordinatePlane());
+    // zoomed or panned since the last paint, which is going to start over
+    if (!plane || progressiveStride() == 0 || refinement.visibleDataRange != plane->visibleDataRange()) {
+        cancelRefinement();
+        return;
+    }
+
+    const QRect area = refinement.drawingArea.toAlignedRect();
+    if (refinement.image.isNull()) {
+        refinement.image = QImage(area.size() * refinement.devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+        refinement.image.setDevicePixelRatio(refinement.devicePixelRatio);
+        refinement.image.fill(Qt::transparent);
+    }
+    QPainter painter(&refinement.image);
+    painter.setRenderHints(refinement.renderHints);
+    painter.translate(-area.topLeft());
+    PaintContext ctx;
+    ctx.setPainter(&painter);
+    ctx.setRectangle(refinement.drawingArea);
+    ctx.setCoordinatePlane(plane->sharedAxisMasterPlane(&painter));
+
+    const int rowCount = compressor.modelDataRows();
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        paintBegin = refinement.paintedRows;
+        paintEnd = qMin(rowCount, paintBegin + RefinementSliceRows);
+        implementor->paint(&ctx);
+        refinement.paintedRows = paintEnd;
+    } while (refinement.paintedRows < rowCount && !timer.hasExpired(progressiveFrameBudget));
+    paintBegin = 0;
+    paintEnd = -1;
+
+    if (refinement.paintedRows < rowCount) {
+        refinementTimer.start();
+    } else {
+        refinement.complete = true;
+        plane->update();
+        Q_EMIT static_cast<Plotter *>(diagram)->refinementFinished();
+    }
+}
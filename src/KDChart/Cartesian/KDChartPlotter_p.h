@@ -24,7 +24,10 @@
 
 #include "KDChartPlotter.h"
 
+#include <QImage>
+#include <QPainter>
 #include <QPainterPath>
+#include <QTimer>
 
 #include "KDChartAbstractCartesianDiagram_p.h"
 #include "KDChartCartesianDiagramDataCompressor_p.h"
@@ -62,10 +65,55 @@ public:
     Plotter::CompressionMode useCompression;
     qreal mergeRadiusPercentage;
 
+    // the rows NormalPlotter paints without data compression: every paintStride-th row
+    // of [paintBegin, paintEnd), or up to the last row if paintEnd is -1
+    int paintBegin = 0;
+    int paintEnd = -1;
+    int paintStride = 1;
+
+    // progressive rendering: a coarse sample is painted right away, while all rows are
+    // painted into an image in time-boxed slices that replaces the sample when complete
+    struct Refinement
+    {
+        // what the image depends on besides data and attributes
+        QRectF drawingArea;
+        QRectF visibleDataRange;
+        qreal devicePixelRatio = 1.0;
+        QPainter::RenderHints renderHints;
+
+        QImage image;
+        int paintedRows = 0;
+        bool complete = false;
+    };
+    bool progressiveRendering = false;
+    int progressiveFrameBudget = 16;
+    Refinement refinement;
+    QTimer refinementTimer;
+
+    // viewport culling: the keys of a dataset are sorted if known, or else detected
+    // once per data change, and only the visible rows are painted then
+    Plotter::KeyOrder keyOrder = Plotter::DetectKeyOrder;
+    mutable QVector<Plotter::KeyOrder> detectedKeyOrders;
+    bool hasSortedKeys(int column) const;
+    // the visible rows of dataset column, plus one row of context on each side
+    void visibleRows(int column, const QRectF &visibleDataRange, int *begin, int *end) const;
+
+    // the stride of the coarse sample, or 0 if all rows can be painted right away
+    int progressiveStride() const;
+    // draws the complete refinement, if it matches the current painting
+    bool paintRefinement(PaintContext *ctx);
+    // paints the coarse sample and schedules the refinement
+    void paintProgressively(PaintContext *ctx, int stride);
+
 protected:
     void init();
 public Q_SLOTS:
     void changedProperties();
+    void cancelRefinement();
+    // cancels the refinement and forgets the detected key order
+    void invalidateData();
+    // paints the next slice of rows into the refinement image
+    void refine();
 };
 
 KDCHART_IMPL_DERIVED_DIAGRAM(Plotter, AbstractCartesianDiagram, CartesianCoordinatePlane)
@@ -44,6 +44,7 @@ void StockDiagram::init()
     d->downTrendCandlestickPen = QPen(Qt::black);
 
     d->lowHighLinePen = QPen(Qt::black);
+    d->updateAggregationPattern();
     setDatasetDimensionInternal(3);
     // setDatasetDimension( 3 );
 
@@ -57,6 +58,7 @@ void StockDiagram::init()
 void StockDiagram::setType(Type type)
 {
     d->type = type;
+    d->updateAggregationPattern();
     Q_EMIT propertiesChanged();
 }
 
@@ -285,7 +287,11 @@ void StockDiagram::paint(PaintContext *context)
     d->reverseMapper.clear();
 
     PainterSaver painterSaver(context->painter());
-    const int rowCount = attributesModel()->rowCount(attributesModelRootIndex());
+    // when zoomed out, the compressor merges several rows into one candle
+    const int rowCount = d->compressor.modelDataRows();
+    if (rowCount == 0)
+        return;
+    d->rowsPerCandle = qreal(attributesModel()->rowCount(attributesModelRootIndex())) / rowCount;
     const int divisor = (d->type == OpenHighLowClose || d->type == Candlestick) ? 4 : 3;
     const int colCount = attributesModel()->columnCount(attributesModelRootIndex()) / divisor;
     for (int col = 0; col < colCount; ++col) {
@@ -354,10 +360,15 @@ qreal StockDiagram::threeDItemDepth(const QModelIndex &index) const
 
 const QPair<QPointF, QPointF> StockDiagram::calculateDataBoundaries() const
 {
-    const int rowCount = attributesModel()->rowCount(attributesModelRootIndex());
-    const int colCount = attributesModel()->columnCount(attributesModelRootIndex());
+    d->compressor.setResolution(static_cast<int>(this->size().width() * coordinatePlane()->zoomFactorX()),
+                                static_cast<int>(this->size().height() * coordinatePlane()->zoomFactorY()));
+
+    // the aggregated candles keep the highest high and the lowest low of the rows
+    // they are made of, so this is exact even if the compressor merged rows
+    const int rowCount = d->compressor.modelDataRows();
+    const int colCount = d->compressor.modelDataColumns();
     qreal xMin = 0.0;
-    qreal xMax = rowCount;
+    qreal xMax = attributesModel()->rowCount(attributesModelRootIndex());
     qreal yMin = 0.0;
     qreal yMax = 0.0;
     for (int row = 0; row < rowCount; row++) {
@@ -10,6 +10,7 @@
 
 #include "KDChartStockDiagram_p.h"
 
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 
 using namespace KDChart;
@@ -223,6 +224,21 @@ StockDiagram::Private::~Private()
 {
 }
 
+/**
+ * Makes the data compressor merge rows into proper bars or candlesticks when
+ * there are more rows than pixels: the first open, the highest high,
+ * the lowest low and the last close value.
+ */
+void StockDiagram::Private::updateAggregationPattern()
+{
+    typedef CartesianDiagramDataCompressor Compressor;
+    QVector<Compressor::AggregationMode> pattern;
+    if (type != HighLowClose)
+        pattern << Compressor::FirstAggregation;
+    pattern << Compressor::MaximumAggregation << Compressor::MinimumAggregation << Compressor::LastAggregation;
+    compressor.setAggregationPattern(pattern);
+}
+
 /**
  * Projects a point onto the coordinate plane
  *
@@ -261,7 +277,7 @@ void StockDiagram::Private::drawOHLCBar(int dataset, const CartesianDiagramDataC
 
     StockBarAttributes attr = stockDiagram()->stockBarAttributes(col);
     ThreeDBarAttributes threeDAttr = stockDiagram()->threeDBarAttributes(col);
-    const qreal tickLength = attr.tickLength();
+    const qreal tickLength = attr.tickLength() * rowsPerCandle;
 
     const QPointF leftOpenPoint(open.key + 0.5 - tickLength, open.value);
     const QPointF rightOpenPoint(open.key + 0.5, open.value);
@@ -374,7 +390,7 @@ void StockDiagram::Private::drawCandlestick(int /*dataset*/, const CartesianDiag
 
     // Convert the data point into coordinates on the coordinate plane
     QRectF candlestick = projectCandlestick(context, bottomCandlestickPoint,
-                                            topCandlestickPoint, attr.candlestickWidth());
+                                            topCandlestickPoint, attr.candlestickWidth() * rowsPerCandle);
 
     // Remember the drawn polygon to add it to the ReverseMapper later
     QPolygonF drawnPolygon;
@@ -413,8 +429,10 @@ void StockDiagram::Private::drawCandlestick(int /*dataset*/, const CartesianDiag
             painter->drawLine(lowerLine);
         if (drawUpperLine)
             painter->drawLine(upperLine);
-        if (drawCandlestick)
+        if (drawCandlestick) {
             painter->drawRect(candlestick);
+            PaintProfiler::count(PaintProfile::RectCounter);
+        }
 
         // The 2D representation is the projected candlestick itself
         drawnPolygon = candlestick;
@@ -480,6 +498,7 @@ void StockDiagram::Private::drawLine(int dataset, int col, const QPointF &point1
         // context->painter()->setBrush( brush );
         reverseMapper.addLine(modelCol, modelRow, transP1, transP2);
         context->painter()->drawLine(line);
+        PaintProfiler::count(PaintProfile::PolylineCounter);
     }
 }
 
@@ -46,6 +46,11 @@ public:
     QPen lowHighLinePen;
     QMap<int, QPen> lowHighLinePens;
 
+    // the number of model rows drawn as one bar or candlestick
+    qreal rowsPerCandle = 1.0;
+
+    void updateAggregationPattern();
+
     void drawOHLCBar(int dataset, const CartesianDiagramDataCompressor::DataPoint &open,
                      const CartesianDiagramDataCompressor::DataPoint &high,
                      const CartesianDiagramDataCompressor::DataPoint &low,
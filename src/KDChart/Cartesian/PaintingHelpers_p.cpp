@@ -18,6 +18,7 @@
 #include "KDChartLineDiagram.h"
 #include "KDChartLineDiagram_p.h"
 #include "KDChartPaintContext.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartPlotter.h"
 #include "KDChartPrintingParameters.h"
@@ -84,6 +85,7 @@ void paintPolyline(PaintContext *ctx, const QBrush &brush, const QPen &pen, cons
     ctx->painter()->setPen(PrintingParameters::scalePen(
         QPen(pen.color(), pen.width(), pen.style(), Qt::FlatCap, Qt::MiterJoin)));
     ctx->painter()->drawPolyline(points);
+    PaintProfiler::count(PaintProfile::PolylineCounter);
 }
 
 void paintSpline(PaintContext *ctx, const QBrush &brush, const QPen &pen, const QPolygonF &points, qreal tension, SplineDirection splineDirection)
@@ -99,6 +101,7 @@ void paintSpline(PaintContext *ctx, const QBrush &brush, const QPen &pen, const
         QPen(pen.color(), pen.width(), pen.style(), Qt::FlatCap, Qt::MiterJoin)));
 
     ctx->painter()->drawPath(fitPoints(points, tension, splineDirection));
+    PaintProfiler::count(PaintProfile::PolylineCounter);
 }
 
 void paintThreeDLines(PaintContext *ctx, AbstractDiagram *diagram, const QModelIndex &index,
@@ -120,6 +123,7 @@ void paintThreeDLines(PaintContext *ctx, AbstractDiagram *diagram, const QModelI
 
     reverseMapper->addPolygon(index.row(), index.column(), segment);
     ctx->painter()->drawPolygon(segment);
+    PaintProfiler::count(PaintProfile::PolylineCounter);
 }
 
 void paintValueTracker(PaintContext *ctx, const ValueTrackerAttributes &vt, const QPointF &at)
@@ -306,35 +310,78 @@ void paintElements(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx,
     diagramPrivate->paintDataValueTextsAndMarkers(ctx, lpc, true);
 }
 
-void paintAreas(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx, const QModelIndex &index,
-                const QList<QPolygonF> &areas, uint opacity)
+// Areas are quads a, b, d, c with the line segment a-b on top, as the line diagrams build
+// them. Adjacent quads share their left corners with the right corners of the previous
+// one and are merged into one polygon, so that no seams show between them.
+static QPainterPath mergedAreas(const QList<QPolygonF> &areas)
 {
-    AbstractDiagram *diagram = diagramPrivate->diagram;
     QPainterPath path;
-    for (int i = 0; i < areas.count(); ++i) {
-        const QPolygonF &p = areas[i];
-        path.addPolygon(p);
-        diagramPrivate->reverseMapper.addPolygon(index.row(), index.column(), p);
+    QPolygonF top;
+    QPolygonF bottom;
+    const auto addRun = [&path, &top, &bottom]() {
+        if (top.isEmpty())
+            return;
+        QPolygonF polygon = top;
+        for (int i = bottom.size() - 1; i >= 0; --i)
+            polygon << bottom.at(i);
+        path.addPolygon(polygon);
         path.closeSubpath();
+        top.clear();
+        bottom.clear();
+    };
+
+    for (const QPolygonF &area : areas) {
+        if (area.size() != 4) {
+            addRun();
+            path.addPolygon(area);
+            path.closeSubpath();
+            continue;
+        }
+        if (top.isEmpty() || area.at(0) != top.last() || area.at(3) != bottom.last()) {
+            addRun();
+            top << area.at(0);
+            bottom << area.at(3);
+        }
+        top << area.at(1);
+        bottom << area.at(2);
     }
+    addRun();
+    return path;
+}
+
+static void fillAreas(AbstractDiagram *diagram, PaintContext *ctx, const QList<QPolygonF> &areas, QBrush brush,
+                      QPen pen, const ThreeDLineAttributes &threeDAttrs, uint opacity)
+{
+    const QPainterPath path = mergedAreas(areas);
 
-    ThreeDLineAttributes threeDAttrs = threeDLineAttributes(diagram, index);
-    QBrush trans = diagram->brush(index);
     if (threeDAttrs.isEnabled()) {
-        trans = threeDAttrs.threeDBrush(trans, path.boundingRect());
+        brush = threeDAttrs.threeDBrush(brush, path.boundingRect());
     }
-    QColor transColor = trans.color();
+    QColor transColor = brush.color();
     transColor.setAlpha(opacity);
-    trans.setColor(transColor);
-    QPen indexPen = diagram->pen(index);
-    indexPen.setBrush(trans);
+    brush.setColor(transColor);
+    pen.setBrush(brush);
     const PainterSaver painterSaver(ctx->painter());
 
     ctx->painter()->setRenderHint(QPainter::Antialiasing, diagram->antiAliasing());
-    ctx->painter()->setPen(PrintingParameters::scalePen(indexPen));
-    ctx->painter()->setBrush(trans);
+    ctx->painter()->setPen(PrintingParameters::scalePen(pen));
+    ctx->painter()->setBrush(brush);
 
     ctx->painter()->drawPath(path);
+    PaintProfiler::count(PaintProfile::PolylineCounter);
+}
+
+void paintAreas(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx, const QModelIndex &index,
+                const QList<QPolygonF> &areas, uint opacity)
+{
+    if (areas.isEmpty())
+        return;
+    AbstractDiagram *diagram = diagramPrivate->diagram;
+    for (const QPolygonF &area : areas) {
+        diagramPrivate->reverseMapper.addPolygon(index.row(), index.column(), area);
+    }
+    fillAreas(diagram, ctx, areas, diagram->brush(index), diagram->pen(index),
+              threeDLineAttributes(diagram, index), opacity);
 }
 
 void paintAreas(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx, const QModelIndex &index,
@@ -360,6 +407,44 @@ void paintAreas(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx, con
     ctx->painter()->setBrush(trans);
 
     ctx->painter()->drawPath(path);
+    PaintProfiler::count(PaintProfile::PolylineCounter);
+}
+
+AreaBatch::AreaBatch(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx)
+    : m_diagramPrivate(diagramPrivate)
+    , m_ctx(ctx)
+{
+}
+
+void AreaBatch::add(const QModelIndex &index, uint opacity, const QPointF &a, const QPointF &b,
+                    const QPointF &d, const QPointF &c)
+{
+    AbstractDiagram *diagram = m_diagramPrivate->diagram;
+    const QBrush brush = diagram->brush(index);
+    const QPen pen = diagram->pen(index);
+    const ThreeDLineAttributes threeDAttrs = threeDLineAttributes(diagram, index);
+    if (!m_areas.isEmpty()
+        && (opacity != m_opacity || brush != m_brush || pen != m_pen || threeDAttrs != m_threeDAttrs)) {
+        flush();
+    }
+    m_brush = brush;
+    m_pen = pen;
+    m_threeDAttrs = threeDAttrs;
+    m_opacity = opacity;
+
+    QPolygonF area;
+    area << a << b << d << c;
+    // hit testing still finds the data point of each segment
+    m_diagramPrivate->reverseMapper.addPolygon(index.row(), index.column(), area);
+    m_areas << area;
+}
+
+void AreaBatch::flush()
+{
+    if (m_areas.isEmpty())
+        return;
+    fillAreas(m_diagramPrivate->diagram, m_ctx, m_areas, m_brush, m_pen, m_threeDAttrs, m_opacity);
+    m_areas.clear();
 }
 
 } // namespace PaintingHelpers
@@ -14,21 +14,20 @@
 #include "KDChartAbstractDiagram_p.h"
 #include <KDABLibFakes>
 
+#include "KDChartThreeDLineAttributes.h"
+
+#include <QBrush>
+#include <QList>
+#include <QModelIndex>
+#include <QPen>
 #include <QPointF>
+#include <QPolygonF>
 #include <QVector>
 
-QT_BEGIN_NAMESPACE
-class QBrush;
-class QModelIndex;
-class QPen;
-class QPolygonF;
-QT_END_NAMESPACE
-
 namespace KDChart {
 
 class LineAttributesInfo;
 typedef QVector<LineAttributesInfo> LineAttributesInfoList;
-class ThreeDLineAttributes;
 class ValueTrackerAttributes;
 
 namespace PaintingHelpers {
@@ -52,6 +51,35 @@ void paintAreas(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx, con
 void paintSpline(PaintContext *ctx, const QBrush &brush, const QPen &pen, const QPolygonF &points);
 void paintAreas(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx, const QModelIndex &index,
                 const QList<QPainterPath> &areas, uint opacity);
+
+/**
+ * Collects the areas below the line segments of one dataset and fills each run of
+ * adjacent areas with the same brush, pen, transparency and 3D attributes as a single
+ * polygon. Call flush() before painting anything that goes on top of the areas.
+ */
+class AreaBatch
+{
+public:
+    AreaBatch(AbstractDiagram::Private *diagramPrivate, PaintContext *ctx);
+
+    /**
+     * Adds the area of the segment from @p a to @p b, reaching down to @p d below b
+     * and @p c below a, with the attributes of @p index.
+     */
+    void add(const QModelIndex &index, uint opacity, const QPointF &a, const QPointF &b,
+             const QPointF &d, const QPointF &c);
+    /** Fills the areas added since the last flush. */
+    void flush();
+
+private:
+    AbstractDiagram::Private *m_diagramPrivate;
+    PaintContext *m_ctx;
+    QList<QPolygonF> m_areas;
+    QBrush m_brush;
+    QPen m_pen;
+    ThreeDLineAttributes m_threeDAttrs;
+    uint m_opacity = 0;
+};
 }
 
 inline qreal euclideanLength(const QPointF &p)
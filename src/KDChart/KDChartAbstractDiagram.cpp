@@ -22,6 +22,7 @@
 #include "KDChartChart.h"
 #include "KDChartDataValueAttributes.h"
 #include "KDChartMarkerAttributes.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartTextAttributes.h"
 #include "KDChartThreeDLineAttributes.h"
@@ -439,6 +440,7 @@ void AbstractDiagram::paintMarker(QPainter *painter,
                                   const QPointF &pos,
                                   const QSizeF &maSize)
 {
+    PaintProfiler::count(PaintProfile::MarkerCounter);
     const QPen oldPen(painter->pen());
     // Pen is used to paint 4Pixels - 1 Pixel - Ring and FastCross types.
     // make sure to use the brush color - see above in those cases.
@@ -23,6 +23,7 @@
 
 #include "KDChartBarDiagram.h"
 #include "KDChartFrameAttributes.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 
 #include <QAbstractTextDocumentLayout>
@@ -110,6 +111,8 @@ void AbstractDiagram::Private::setAttributesModel(AttributesModel *amodel)
                        diagram, &AbstractDiagram::setDataBoundariesDirty);
             disconnect(attributesModel, &AttributesModel::dataChanged,
                        diagram, &AbstractDiagram::modelDataChanged);
+            disconnect(attributesModel, &AttributesModel::attributesChanged,
+                       diagram, &AbstractDiagram::update);
         }
     }
 
@@ -129,6 +132,9 @@ void AbstractDiagram::Private::setAttributesModel(AttributesModel *amodel)
             diagram, &AbstractDiagram::setDataBoundariesDirty);
     connect(amodel, &AttributesModel::dataChanged,
             diagram, &AbstractDiagram::modelDataChanged);
+    // pens and brushes change without dataChanged(), they only need a repaint
+    connect(amodel, &AttributesModel::attributesChanged,
+            diagram, &AbstractDiagram::update);
 
     attributesModel = amodel;
 }
@@ -367,6 +373,7 @@ void AbstractDiagram::Private::paintDataValueTextsAndMarkers(
     if (justCalculateRect && !cumulatedBoundingRect) {
         qWarning() << Q_FUNC_INFO << "Neither painting nor finding the bounding rect, what are we doing?";
     }
+    PaintProfiler::Scope scope(PaintProfile::DataValueTextsPhase);
 
     const PainterSaver painterSaver(ctx->painter());
     ctx->painter()->setClipping(false);
@@ -558,6 +565,7 @@ void AbstractDiagram::Private::paintDataValueText(
                 painter->drawRoundedRect(borderRect, radius, radius);
             }
             layout->draw(painter, context);
+            PaintProfiler::count(PaintProfile::LabelCounter);
         }
     }
 }
@@ -607,9 +615,11 @@ void AbstractDiagram::Private::setDatasetAttrs(int dataset, const QVariant &data
     // Also see KDCH-503 for which this is a workaround.
     int columnSpan = role == DataHiddenRole ? datasetDimension : 1;
 
+    attributesModel->beginAttributesUpdate();
     for (int i = 0; i < columnSpan; i++) {
         attributesModel->setHeaderData(column + i, Qt::Horizontal, data, role);
     }
+    attributesModel->endAttributesUpdate();
 }
 
 QVariant AbstractDiagram::Private::datasetAttrs(int dataset, int role) const
@@ -0,0 +1,482 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartAggregationKernels_p.h"
+
+#include <QAtomicInt>
+#include <QtAlgorithms>
+
+#include <limits>
+
+#include <KDABLibFakes>
+
+// the vectorized kernels work on doubles, which qreal is unless Qt was configured otherwise
+#if !defined(QT_COORD_TYPE) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define KDCHART_AGGREGATION_SSE2
+#include <emmintrin.h>
+#if defined(Q_CC_GNU) || defined(Q_CC_CLANG)
+#define KDCHART_AGGREGATION_AVX2
+#define KDCHART_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(Q_CC_MSVC)
+#define KDCHART_AGGREGATION_AVX2
+#define KDCHART_TARGET_AVX2
+#include <immintrin.h>
+#endif
+#if defined(KDCHART_AGGREGATION_AVX2) && defined(Q_CC_MSVC)
+#include <intrin.h>
+#endif
+#endif
+
+using namespace KDChart;
+
+namespace {
+
+const qreal Infinity = std::numeric_limits<qreal>::infinity();
+
+// not decided yet while negative
+QBasicAtomicInt s_instructionSet = Q_BASIC_ATOMIC_INITIALIZER(-1);
+
+// the scalar kernels, which also do what is left over by the vectorized ones
+
+void addToSum(const qreal *values, int count, AggregationKernels::Sum &sum)
+{
+    for (int i = 0; i < count; ++i) {
+        if (!ISNAN(values[i])) {
+            sum.sum += values[i];
+            ++sum.count;
+        }
+    }
+}
+
+// the largest of maximum and the values that are not NaN
+qreal maximumOf(const qreal *values, int count, qreal maximum)
+{
+    for (int i = 0; i < count; ++i) {
+        if (values[i] > maximum) {
+            maximum = values[i];
+        }
+    }
+    return maximum;
+}
+
+qreal minimumOf(const qreal *values, int count, qreal minimum)
+{
+    for (int i = 0; i < count; ++i) {
+        if (values[i] < minimum) {
+            minimum = values[i];
+        }
+    }
+    return minimum;
+}
+
+int indexOf(const qreal *values, int count, qreal value)
+{
+    for (int i = 0; i < count; ++i) {
+        if (values[i] == value) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// boundaries that grow with every pair added, infinitely small until then
+struct Range
+{
+    qreal minimumKey = Infinity;
+    qreal maximumKey = -Infinity;
+    qreal minimumValue = Infinity;
+    qreal maximumValue = -Infinity;
+    bool empty = true;
+};
+
+void addToRange(const qreal *keys, const qreal *values, int count, Range &range)
+{
+    for (int i = 0; i < count; ++i) {
+        if (ISNAN(keys[i]) || ISNAN(values[i])) {
+            continue;
+        }
+        range.minimumKey = qMin(range.minimumKey, keys[i]);
+        range.maximumKey = qMax(range.maximumKey, keys[i]);
+        range.minimumValue = qMin(range.minimumValue, values[i]);
+        range.maximumValue = qMax(range.maximumValue, values[i]);
+        range.empty = false;
+    }
+}
+
+#ifdef KDCHART_AGGREGATION_SSE2
+// max and min return their second operand if the first one is NaN, which skips NaN values
+// when the running result is the second operand
+
+AggregationKernels::Sum sse2Sum(const qreal *values, int count)
+{
+    const __m128d one = _mm_set1_pd(1.0);
+    __m128d sum = _mm_setzero_pd();
+    __m128d counted = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128d v = _mm_loadu_pd(values + i);
+        const __m128d valid = _mm_cmpord_pd(v, v);
+        sum = _mm_add_pd(sum, _mm_and_pd(v, valid));
+        counted = _mm_add_pd(counted, _mm_and_pd(one, valid));
+    }
+    double sums[2];
+    double counts[2];
+    _mm_storeu_pd(sums, sum);
+    _mm_storeu_pd(counts, counted);
+    AggregationKernels::Sum result = { sums[0] + sums[1], int(counts[0] + counts[1]) };
+    addToSum(values + i, count - i, result);
+    return result;
+}
+
+qreal sse2Maximum(const qreal *values, int count)
+{
+    __m128d maximum = _mm_set1_pd(-Infinity);
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        maximum = _mm_max_pd(_mm_loadu_pd(values + i), maximum);
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, maximum);
+    return maximumOf(values + i, count - i, qMax(lanes[0], lanes[1]));
+}
+
+qreal sse2Minimum(const qreal *values, int count)
+{
+    __m128d minimum = _mm_set1_pd(Infinity);
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        minimum = _mm_min_pd(_mm_loadu_pd(values + i), minimum);
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, minimum);
+    return minimumOf(values + i, count - i, qMin(lanes[0], lanes[1]));
+}
+
+int sse2IndexOf(const qreal *values, int count, qreal value)
+{
+    const __m128d wanted = _mm_set1_pd(value);
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const int found = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(values + i), wanted));
+        if (found) {
+            return i + int(qCountTrailingZeroBits(uint(found)));
+        }
+    }
+    const int index = indexOf(values + i, count - i, value);
+    return index < 0 ? -1 : i + index;
+}
+
+void sse2Boundaries(const qreal *keys, const qreal *values, int count, Range &range)
+{
+    __m128d minimumKey = _mm_set1_pd(Infinity);
+    __m128d maximumKey = _mm_set1_pd(-Infinity);
+    __m128d minimumValue = _mm_set1_pd(Infinity);
+    __m128d maximumValue = _mm_set1_pd(-Infinity);
+    __m128d noneValid = _mm_castsi128_pd(_mm_set1_epi32(-1));
+    int i = 0;
+    for (; i + 2 <= count; i += 2) {
+        const __m128d k = _mm_loadu_pd(keys + i);
+        const __m128d v = _mm_loadu_pd(values + i);
+        // all bits set is NaN, for both members of a pair with a NaN
+        const __m128d invalid = _mm_or_pd(_mm_cmpunord_pd(k, k), _mm_cmpunord_pd(v, v));
+        const __m128d pairKey = _mm_or_pd(k, invalid);
+        const __m128d pairValue = _mm_or_pd(v, invalid);
+        minimumKey = _mm_min_pd(pairKey, minimumKey);
+        maximumKey = _mm_max_pd(pairKey, maximumKey);
+        minimumValue = _mm_min_pd(pairValue, minimumValue);
+        maximumValue = _mm_max_pd(pairValue, maximumValue);
+        noneValid = _mm_and_pd(noneValid, invalid);
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, minimumKey);
+    range.minimumKey = qMin(lanes[0], lanes[1]);
+    _mm_storeu_pd(lanes, maximumKey);
+    range.maximumKey = qMax(lanes[0], lanes[1]);
+    _mm_storeu_pd(lanes, minimumValue);
+    range.minimumValue = qMin(lanes[0], lanes[1]);
+    _mm_storeu_pd(lanes, maximumValue);
+    range.maximumValue = qMax(lanes[0], lanes[1]);
+    range.empty = _mm_movemask_pd(noneValid) == 0x3;
+    addToRange(keys + i, values + i, count - i, range);
+}
+#endif
+
+#ifdef KDCHART_AGGREGATION_AVX2
+KDCHART_TARGET_AVX2 AggregationKernels::Sum avx2Sum(const qreal *values, int count)
+{
+    const __m256d one = _mm256_set1_pd(1.0);
+    __m256d sum = _mm256_setzero_pd();
+    __m256d counted = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d v = _mm256_loadu_pd(values + i);
+        const __m256d valid = _mm256_cmp_pd(v, v, _CMP_ORD_Q);
+        sum = _mm256_add_pd(sum, _mm256_and_pd(v, valid));
+        counted = _mm256_add_pd(counted, _mm256_and_pd(one, valid));
+    }
+    double sums[4];
+    double counts[4];
+    _mm256_storeu_pd(sums, sum);
+    _mm256_storeu_pd(counts, counted);
+    AggregationKernels::Sum result = { (sums[0] + sums[1]) + (sums[2] + sums[3]),
+                                       int((counts[0] + counts[1]) + (counts[2] + counts[3])) };
+    addToSum(values + i, count - i, result);
+    return result;
+}
+
+KDCHART_TARGET_AVX2 qreal avx2Maximum(const qreal *values, int count)
+{
+    __m256d maximum = _mm256_set1_pd(-Infinity);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        maximum = _mm256_max_pd(_mm256_loadu_pd(values + i), maximum);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, maximum);
+    return maximumOf(values + i, count - i, qMax(qMax(lanes[0], lanes[1]), qMax(lanes[2], lanes[3])));
+}
+
+KDCHART_TARGET_AVX2 qreal avx2Minimum(const qreal *values, int count)
+{
+    __m256d minimum = _mm256_set1_pd(Infinity);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        minimum = _mm256_min_pd(_mm256_loadu_pd(values + i), minimum);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, minimum);
+    return minimumOf(values + i, count - i, qMin(qMin(lanes[0], lanes[1]), qMin(lanes[2], lanes[3])));
+}
+
+KDCHART_TARGET_AVX2 int avx2IndexOf(const qreal *values, int count, qreal value)
+{
+    const __m256d wanted = _mm256_set1_pd(value);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const int found = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(values + i), wanted, _CMP_EQ_OQ));
+        if (found) {
+            return i + int(qCountTrailingZeroBits(uint(found)));
+        }
+    }
+    const int index = indexOf(values + i, count - i, value);
+    return index < 0 ? -1 : i + index;
+}
+
+KDCHART_TARGET_AVX2 void avx2Boundaries(const qreal *keys, const qreal *values, int count, Range &range)
+{
+    __m256d minimumKey = _mm256_set1_pd(Infinity);
+    __m256d maximumKey = _mm256_set1_pd(-Infinity);
+    __m256d minimumValue = _mm256_set1_pd(Infinity);
+    __m256d maximumValue = _mm256_set1_pd(-Infinity);
+    __m256d noneValid = _mm256_castsi256_pd(_mm256_set1_epi32(-1));
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d k = _mm256_loadu_pd(keys + i);
+        const __m256d v = _mm256_loadu_pd(values + i);
+        const __m256d invalid = _mm256_or_pd(_mm256_cmp_pd(k, k, _CMP_UNORD_Q), _mm256_cmp_pd(v, v, _CMP_UNORD_Q));
+        const __m256d pairKey = _mm256_or_pd(k, invalid);
+        const __m256d pairValue = _mm256_or_pd(v, invalid);
+        minimumKey = _mm256_min_pd(pairKey, minimumKey);
+        maximumKey = _mm256_max_pd(pairKey, maximumKey);
+        minimumValue = _mm256_min_pd(pairValue, minimumValue);
+        maximumValue = _mm256_max_pd(pairValue, maximumValue);
+        noneValid = _mm256_and_pd(noneValid, invalid);
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, minimumKey);
+    range.minimumKey = qMin(qMin(lanes[0], lanes[1]), qMin(lanes[2], lanes[3]));
+    _mm256_storeu_pd(lanes, maximumKey);
+    range.maximumKey = qMax(qMax(lanes[0], lanes[1]), qMax(lanes[2], lanes[3]));
+    _mm256_storeu_pd(lanes, minimumValue);
+    range.minimumValue = qMin(qMin(lanes[0], lanes[1]), qMin(lanes[2], lanes[3]));
+    _mm256_storeu_pd(lanes, maximumValue);
+    range.maximumValue = qMax(qMax(lanes[0], lanes[1]), qMax(lanes[2], lanes[3]));
+    range.empty = _mm256_movemask_pd(noneValid) == 0xf;
+    addToRange(keys + i, values + i, count - i, range);
+}
+
+bool cpuSupportsAvx2()
+{
+#if defined(Q_CC_MSVC)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    // the operating system must save the AVX registers, too
+    const bool avxEnabled = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    return avxEnabled && (info[1] & (1 << 5));
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+qreal maximum(const qreal *values, int count)
+{
+    switch (AggregationKernels::instructionSet()) {
+#ifdef KDCHART_AGGREGATION_AVX2
+    case AggregationKernels::AVX2:
+        return avx2Maximum(values, count);
+#endif
+#ifdef KDCHART_AGGREGATION_SSE2
+    case AggregationKernels::SSE2:
+        return sse2Maximum(values, count);
+#endif
+    default:
+        return maximumOf(values, count, -Infinity);
+    }
+}
+
+qreal minimum(const qreal *values, int count)
+{
+    switch (AggregationKernels::instructionSet()) {
+#ifdef KDCHART_AGGREGATION_AVX2
+    case AggregationKernels::AVX2:
+        return avx2Minimum(values, count);
+#endif
+#ifdef KDCHART_AGGREGATION_SSE2
+    case AggregationKernels::SSE2:
+        return sse2Minimum(values, count);
+#endif
+    default:
+        return minimumOf(values, count, Infinity);
+    }
+}
+
+int find(const qreal *values, int count, qreal value)
+{
+    switch (AggregationKernels::instructionSet()) {
+#ifdef KDCHART_AGGREGATION_AVX2
+    case AggregationKernels::AVX2:
+        return avx2IndexOf(values, count, value);
+#endif
+#ifdef KDCHART_AGGREGATION_SSE2
+    case AggregationKernels::SSE2:
+        return sse2IndexOf(values, count, value);
+#endif
+    default:
+        return indexOf(values, count, value);
+    }
+}
+}
+
+AggregationKernels::InstructionSet AggregationKernels::supportedInstructionSet()
+{
+#ifdef KDCHART_AGGREGATION_AVX2
+    if (cpuSupportsAvx2()) {
+        return AVX2;
+    }
+#endif
+#ifdef KDCHART_AGGREGATION_SSE2
+    return SSE2;
+#else
+    return Scalar;
+#endif
+}
+
+AggregationKernels::InstructionSet AggregationKernels::instructionSet()
+{
+    int set = s_instructionSet.loadRelaxed();
+    if (Q_UNLIKELY(set < 0)) {
+        set = supportedInstructionSet();
+        s_instructionSet.storeRelaxed(set);
+    }
+    return InstructionSet(set);
+}
+
+AggregationKernels::InstructionSet AggregationKernels::setInstructionSet(InstructionSet set)
+{
+    const InstructionSet used = qMin(set, supportedInstructionSet());
+    s_instructionSet.storeRelaxed(used);
+    return used;
+}
+
+AggregationKernels::Sum AggregationKernels::sum(const qreal *values, int count)
+{
+    switch (instructionSet()) {
+#ifdef KDCHART_AGGREGATION_AVX2
+    case AVX2:
+        return avx2Sum(values, count);
+#endif
+#ifdef KDCHART_AGGREGATION_SSE2
+    case SSE2:
+        return sse2Sum(values, count);
+#endif
+    default:
+        break;
+    }
+    Sum result = { 0.0, 0 };
+    addToSum(values, count, result);
+    return result;
+}
+
+int AggregationKernels::maximumIndex(const qreal *values, int count)
+{
+    // without values that are not NaN, -infinity is not found either
+    return find(values, count, maximum(values, count));
+}
+
+int AggregationKernels::minimumIndex(const qreal *values, int count)
+{
+    return find(values, count, minimum(values, count));
+}
+
+int AggregationKernels::firstIndex(const qreal *values, int count)
+{
+    // usually the very first value, not worth vectorizing
+    for (int i = 0; i < count; ++i) {
+        if (!ISNAN(values[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int AggregationKernels::lastIndex(const qreal *values, int count)
+{
+    for (int i = count - 1; i >= 0; --i) {
+        if (!ISNAN(values[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+AggregationKernels::Boundaries AggregationKernels::boundaries(const qreal *keys, const qreal *values, int count)
+{
+    Range range;
+    switch (instructionSet()) {
+#ifdef KDCHART_AGGREGATION_AVX2
+    case AVX2:
+        avx2Boundaries(keys, values, count, range);
+        break;
+#endif
+#ifdef KDCHART_AGGREGATION_SSE2
+    case SSE2:
+        sse2Boundaries(keys, values, count, range);
+        break;
+#endif
+    default:
+        addToRange(keys, values, count, range);
+        break;
+    }
+    if (range.empty) {
+        const qreal NaN = std::numeric_limits<qreal>::quiet_NaN();
+        const Boundaries none = { NaN, NaN, NaN, NaN };
+        return none;
+    }
+    const Boundaries result = { range.minimumKey, range.maximumKey, range.minimumValue, range.maximumValue };
+    return result;
+}
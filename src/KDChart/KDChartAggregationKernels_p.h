@@ -0,0 +1,91 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTAGGREGATIONKERNELS_P_H
+#define KDCHARTAGGREGATIONKERNELS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGlobal>
+
+#include "kdchart_export.h"
+
+namespace KDChart {
+
+/**
+ * \internal
+ * Reductions of arrays of values, as the data compressors need them to merge many
+ * rows into one data point or to find the boundaries of the data.
+ *
+ * NaN values are empty and skipped. The kernels use SSE2 or AVX2 where the CPU
+ * supports it, picked once at runtime, and plain loops elsewhere. Sums may differ
+ * from adding up the values one by one in the last bits, because the vectorized
+ * kernels add them in another order.
+ */
+class KDCHART_EXPORT AggregationKernels
+{
+public:
+    enum InstructionSet
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    /** Returns the best instruction set supported by both the build and the CPU. */
+    static InstructionSet supportedInstructionSet();
+    /** Returns the instruction set the kernels use. */
+    static InstructionSet instructionSet();
+    /**
+     * Makes the kernels use at most @p set, to compare them with each other.
+     * Returns the instruction set used from now on.
+     */
+    static InstructionSet setInstructionSet(InstructionSet set);
+
+    struct Sum
+    {
+        qreal sum;
+        /// the number of values that are not NaN
+        int count;
+    };
+    static Sum sum(const qreal *values, int count);
+
+    /** Returns the index of the first largest value, or -1 if all values are NaN. */
+    static int maximumIndex(const qreal *values, int count);
+    /** Returns the index of the first smallest value, or -1 if all values are NaN. */
+    static int minimumIndex(const qreal *values, int count);
+    /** Returns the index of the first value that is not NaN, or -1. */
+    static int firstIndex(const qreal *values, int count);
+    /** Returns the index of the last value that is not NaN, or -1. */
+    static int lastIndex(const qreal *values, int count);
+
+    /// the ranges of the keys and values, NaN if there is no pair without NaN
+    struct Boundaries
+    {
+        qreal minimumKey;
+        qreal maximumKey;
+        qreal minimumValue;
+        qreal maximumValue;
+    };
+    /** Returns the ranges of all pairs of @p keys and @p values of which neither is NaN. */
+    static Boundaries boundaries(const qreal *keys, const qreal *values, int count);
+};
+}
+
+#endif
@@ -10,11 +10,14 @@
 
 #include "KDChartAttributesModel.h"
 #include "KDChartGlobal.h"
+#include "KDChartModelDataCache_p.h"
+#include "KDChartNumericDataModel_p.h"
 #include "KDChartPalette.h"
 
 #include <QDebug>
 #include <QPen>
 #include <QPointer>
+#include <QRect>
 
 #include <KDChartAbstractThreeDAttributes.h>
 #include <KDChartBackgroundAttributes.h>
@@ -49,6 +52,27 @@ public:
     int dataDimension = 1;
     AttributesModel::PaletteType paletteType = AttributesModel::PaletteTypeDefault;
     Palette palette;
+    SharedModelDataCache *sharedModelCache = nullptr;
+
+    // attribute changes not announced yet, see beginAttributesUpdate()
+    struct Changes
+    {
+        QRect cells; // x is the column, y the row
+        QVector<int> roles;
+        QRect dataCells;
+        QVector<int> dataRoles;
+        QMap<int, QPair<int, int>> headerSections; // first and last section per orientation
+        bool reset = false;
+    };
+    Changes changes;
+    int updateDepth = 0;
+
+    static void addRole(QVector<int> *roles, int role)
+    {
+        if (!roles->contains(role)) {
+            roles->append(role);
+        }
+    }
 };
 
 AttributesModel::Private::Private()
@@ -69,13 +93,23 @@ AttributesModel::AttributesModel(QAbstractItemModel *model, QObject *parent /* =
 
 AttributesModel::~AttributesModel()
 {
+    if (d->sharedModelCache) {
+        d->sharedModelCache->release();
+    }
     delete _d;
     _d = nullptr;
 }
 
 void AttributesModel::initFrom(const AttributesModel *other)
 {
+    // the shared cache belongs to the source model, which is not copied
+    SharedModelDataCache *const sharedModelCache = d->sharedModelCache;
+    const Private::Changes changes = d->changes;
+    const int updateDepth = d->updateDepth;
     *d = *other->d;
+    d->sharedModelCache = sharedModelCache;
+    d->changes = changes;
+    d->updateDepth = updateDepth;
 }
 
 bool AttributesModel::compareHeaderDataMaps(const QMap<int, QMap<int, QVariant>> &mapA,
@@ -292,6 +326,20 @@ QVariant AttributesModel::data(int column, int role) const
     return QVariant();
 }
 
+bool AttributesModel::hasCellData(int column, int role) const
+{
+    const QMap<int, QMap<int, QMap<int, QVariant>>>::const_iterator colIt = d->dataMap.constFind(column);
+    if (colIt == d->dataMap.constEnd()) {
+        return false;
+    }
+    for (const QMap<int, QVariant> &dataMap : *colIt) {
+        if (dataMap.value(role).isValid()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 QVariant AttributesModel::data(const QModelIndex &index, int role) const
 {
     if (index.isValid()) {
@@ -366,7 +414,11 @@ bool AttributesModel::setData(const QModelIndex &index, const QVariant &value, i
         QMap<int, QMap<int, QVariant>> &colDataMap = d->dataMap[index.column()];
         QMap<int, QVariant> &dataMap = colDataMap[index.row()];
         dataMap.insert(role, value);
-        Q_EMIT attributesChanged(index, index);
+        d->changes.cells |= QRect(index.column(), index.row(), 1, 1);
+        Private::addRole(&d->changes.roles, role);
+        if (!d->updateDepth) {
+            emitAttributeChanges();
+        }
         return true;
     }
 }
@@ -393,19 +445,30 @@ bool AttributesModel::setHeaderData(int section, Qt::Orientation orientation,
         if (sourceModel()) {
             int numRows = rowCount(QModelIndex());
             int numCols = columnCount(QModelIndex());
-            if (orientation == Qt::Horizontal && numRows > 0)
-                Q_EMIT attributesChanged(index(0, section, QModelIndex()),
-                                         index(numRows - 1, section, QModelIndex()));
-            else if (orientation == Qt::Vertical && numCols > 0)
-                Q_EMIT attributesChanged(index(section, 0, QModelIndex()),
-                                         index(section, numCols - 1, QModelIndex()));
-            Q_EMIT headerDataChanged(orientation, section, section);
+            Private::Changes &changes = d->changes;
+            if (orientation == Qt::Horizontal) {
+                changes.cells |= QRect(section, 0, 1, numRows);
+            } else {
+                changes.cells |= QRect(0, section, numCols, 1);
+            }
+            Private::addRole(&changes.roles, role);
+            if (changes.headerSections.contains(orientation)) {
+                QPair<int, int> &sections = changes.headerSections[orientation];
+                sections.first = qMin(sections.first, section);
+                sections.second = qMax(sections.second, section);
+            } else {
+                changes.headerSections.insert(orientation, qMakePair(section, section));
+            }
 
             // FIXME: This only makes sense for orientation == Qt::Horizontal,
             // but what if orientation == Qt::Vertical?
-            if (section != -1 && numRows > 0)
-                Q_EMIT dataChanged(index(0, section, QModelIndex()),
-                                   index(numRows - 1, section, QModelIndex()));
+            if (section != -1 && numRows > 0 && !isAppearanceRole(role)) {
+                changes.dataCells |= QRect(section, 0, 1, numRows);
+                Private::addRole(&changes.dataRoles, role);
+            }
+            if (!d->updateDepth) {
+                emitAttributeChanges();
+            }
         }
         return true;
     }
@@ -448,12 +511,68 @@ bool KDChart::AttributesModel::setModelData(const QVariant value, int role)
     int numRows = rowCount(QModelIndex());
     int numCols = columnCount(QModelIndex());
     if (sourceModel() && numRows > 0 && numCols > 0) {
-        Q_EMIT attributesChanged(index(0, 0, QModelIndex()),
-                                 index(numRows - 1, numCols - 1, QModelIndex()));
+        d->changes.cells |= QRect(0, 0, numCols, numRows);
+        Private::addRole(&d->changes.roles, role);
+        d->changes.reset = d->changes.reset || !isAppearanceRole(role);
+        if (!d->updateDepth) {
+            emitAttributeChanges();
+        }
+    }
+    return true;
+}
+
+void AttributesModel::beginAttributesUpdate()
+{
+    ++d->updateDepth;
+}
+
+void AttributesModel::endAttributesUpdate()
+{
+    Q_ASSERT(d->updateDepth > 0);
+    if (--d->updateDepth == 0) {
+        emitAttributeChanges();
+    }
+}
+
+bool AttributesModel::isUpdatingAttributes() const
+{
+    return d->updateDepth > 0;
+}
+
+bool AttributesModel::isAppearanceRole(int role)
+{
+    switch (role) {
+    case DatasetBrushRole:
+    case DatasetPenRole:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void AttributesModel::emitAttributeChanges()
+{
+    // take the changes first, receivers may change attributes again
+    const Private::Changes changes = d->changes;
+    d->changes = Private::Changes();
+
+    if (!changes.cells.isEmpty()) {
+        const QModelIndex topLeft = index(changes.cells.top(), changes.cells.left(), QModelIndex());
+        const QModelIndex bottomRight = index(changes.cells.bottom(), changes.cells.right(), QModelIndex());
+        Q_EMIT attributesChanged(topLeft, bottomRight);
+        Q_EMIT attributeRolesChanged(topLeft, bottomRight, changes.roles);
+    }
+    for (auto it = changes.headerSections.constBegin(); it != changes.headerSections.constEnd(); ++it) {
+        Q_EMIT headerDataChanged(Qt::Orientation(it.key()), it->first, it->second);
+    }
+    if (changes.reset) {
         beginResetModel();
         endResetModel();
+    } else if (!changes.dataCells.isEmpty()) {
+        Q_EMIT dataChanged(index(changes.dataCells.top(), changes.dataCells.left(), QModelIndex()),
+                           index(changes.dataCells.bottom(), changes.dataCells.right(), QModelIndex()),
+                           changes.dataRoles);
     }
-    return true;
 }
 
 QVariant KDChart::AttributesModel::modelData(int role) const
@@ -508,6 +627,17 @@ void AttributesModel::setSourceModel(QAbstractItemModel *newModel)
         disconnect(oldModel, &QAbstractItemModel::layoutChanged,
                    this, &AttributesModel::layoutChanged);
     }
+    // The cartesian diagrams read the values of the source model from a cache they share.
+    // Holding on to it from here connects the cache to the model before this proxy, so it
+    // is up to date when the diagrams are told about changes. A NumericDataModel is read
+    // directly and needs no cache.
+    SharedModelDataCache *const oldCache = d->sharedModelCache;
+    d->sharedModelCache = newModel && !qobject_cast<NumericDataModel *>(newModel)
+        ? SharedModelDataCache::acquire(newModel)
+        : nullptr;
+    if (oldCache) {
+        oldCache->release();
+    }
     QAbstractProxyModel::setSourceModel(newModel);
     if (newModel != nullptr) {
         connect(newModel, &QAbstractItemModel::dataChanged,
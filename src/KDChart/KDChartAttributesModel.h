@@ -14,6 +14,7 @@
 #include "KDChartAbstractProxyModel.h"
 #include <QMap>
 #include <QVariant>
+#include <QVector>
 
 #include "KDChartGlobal.h"
 
@@ -80,6 +81,12 @@ public:
      */
     QVariant data(int column, int role) const;
 
+    /** Returns whether data for @p role was specified for any single cell of @p column.
+     * If not, all cells of the column without a value in the source model fall back
+     * to data(column, role).
+     */
+    bool hasCellData(int column, int role) const;
+
     /** \reimp */
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
     /** \reimp */
@@ -110,8 +117,37 @@ public:
     void setDatasetDimension(int dimension);
     int datasetDimension() const;
 
+    /**
+     * Starts a batch of attribute changes.
+     *
+     * Until the matching endAttributesUpdate(), changes made through setData(), setHeaderData()
+     * and setModelData() are stored but not announced. Diagrams and legends then update once for
+     * the whole batch instead of once per change, e.g. when setting the pens of many datasets.
+     * Batches can be nested, the changes are announced at the end of the outermost one.
+     */
+    void beginAttributesUpdate();
+    /**
+     * Ends a batch of attribute changes started with beginAttributesUpdate() and emits
+     * attributesChanged(), attributeRolesChanged(), headerDataChanged() and dataChanged() once
+     * for everything that changed in it.
+     */
+    void endAttributesUpdate();
+    /** Returns whether a batch of attribute changes is in progress. */
+    bool isUpdatingAttributes() const;
+
+    /**
+     * Returns whether changing the attribute @p role only changes how the data is painted,
+     * not the data boundaries or the layout. Such changes do not emit dataChanged().
+     */
+    static bool isAppearanceRole(int role);
+
 Q_SIGNALS:
     void attributesChanged(const QModelIndex &, const QModelIndex &);
+    /**
+     * Emitted right after attributesChanged(), with the attribute @p roles that changed
+     * between @p topLeft and @p bottomRight.
+     */
+    void attributeRolesChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles);
 
 private Q_SLOTS:
     void slotRowsAboutToBeInserted(const QModelIndex &parent, int start, int end);
@@ -132,6 +168,8 @@ private:
     bool compareHeaderDataMaps(const QMap<int, QMap<int, QVariant>> &mapA,
                                const QMap<int, QMap<int, QVariant>> &mapB) const;
 
+    void emitAttributeChanges();
+
     void removeEntriesFromDataMap(int start, int end);
     void removeEntriesFromDirectionDataMaps(Qt::Orientation dir, int start, int end);
 };
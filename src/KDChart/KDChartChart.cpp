@@ -30,6 +30,7 @@
 #include "KDChartHeaderFooter.h"
 #include "KDChartLayoutItems.h"
 #include "KDChartLegend.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartPrintingParameters.h"
 #include <KDChartMarkerAttributes.h>
@@ -1057,8 +1058,48 @@ void Chart::Private::slotResizePlanes()
     }
 }
 
+void Chart::Private::recordAxisSizeHints()
+{
+    axisSizeHints.clear();
+    for (AbstractCoordinatePlane *plane : qAsConst(coordinatePlanes)) {
+        const auto constDiagrams = plane->diagrams();
+        for (AbstractDiagram *diagram : constDiagrams) {
+            if (auto *cartesianDiagram = qobject_cast<AbstractCartesianDiagram *>(diagram)) {
+                const auto constAxes = cartesianDiagram->axes();
+                for (const CartesianAxis *axis : constAxes) {
+                    axisSizeHints.insert(axis, axis->sizeHint());
+                }
+            }
+        }
+    }
+}
+
+bool Chart::Private::axisSizeHintsChanged() const
+{
+    // added and removed axes lay out the planes anyway
+    for (AbstractCoordinatePlane *plane : qAsConst(coordinatePlanes)) {
+        const auto constDiagrams = plane->diagrams();
+        for (AbstractDiagram *diagram : constDiagrams) {
+            if (auto *cartesianDiagram = qobject_cast<AbstractCartesianDiagram *>(diagram)) {
+                const auto constAxes = cartesianDiagram->axes();
+                for (const CartesianAxis *axis : constAxes) {
+                    const auto it = axisSizeHints.constFind(axis);
+                    if (it == axisSizeHints.constEnd() || it.value() != axis->sizeHint()) {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
 void Chart::Private::updateDirtyLayouts()
 {
+    if (!isPlanesLayoutDirty && axisSizeHintsChanged()) {
+        // new data changed the size of an axis, e.g. with longer tick labels
+        slotLayoutPlanes();
+    }
     if (isPlanesLayoutDirty) {
         for (AbstractCoordinatePlane *p : qAsConst(coordinatePlanes)) {
             p->setGridNeedsRecalculate();
@@ -1069,6 +1110,9 @@ void Chart::Private::updateDirtyLayouts()
     if (isPlanesLayoutDirty || isFloatingLegendsLayoutDirty) {
         chart->reLayoutFloatingLegends();
     }
+    if (isPlanesLayoutDirty) {
+        recordAxisSizeHints();
+    }
     isPlanesLayoutDirty = false;
     isFloatingLegendsLayoutDirty = false;
 }
@@ -1084,25 +1128,44 @@ void Chart::Private::reapplyInternalLayouts()
 
 void Chart::Private::paintAll(QPainter *painter)
 {
-    updateDirtyLayouts();
+    QScopedPointer<PaintProfiler> profiler;
+    if (paintProfilingEnabled) {
+        profiler.reset(new PaintProfiler(&lastPaintProfile));
+    }
+
+    {
+        PaintProfiler::Scope scope(PaintProfile::LayoutPhase);
+        updateDirtyLayouts();
+    }
 
     QRect rect(QPoint(0, 0), overrideSize.isValid() ? overrideSize : chart->size());
 
     // qDebug() << this<<"::paintAll() uses layout size" << currentLayoutSize;
 
-    // Paint the background (if any)
-    AbstractAreaBase::paintBackgroundAttributes(*painter, rect, backgroundAttributes);
-    // Paint the frame (if any)
-    AbstractAreaBase::paintFrameAttributes(*painter, rect, frameAttributes);
+    {
+        PaintProfiler::Scope scope(PaintProfile::BackgroundPhase);
+        // Paint the background (if any)
+        AbstractAreaBase::paintBackgroundAttributes(*painter, rect, backgroundAttributes);
+        // Paint the frame (if any)
+        AbstractAreaBase::paintFrameAttributes(*painter, rect, frameAttributes);
+    }
 
-    chart->reLayoutFloatingLegends();
+    {
+        PaintProfiler::Scope scope(PaintProfile::LayoutPhase);
+        chart->reLayoutFloatingLegends();
+    }
 
+    // the planes and axes record their own phases
     for (AbstractLayoutItem *planeLayoutItem : qAsConst(planeLayoutItems)) {
         planeLayoutItem->paintAll(*painter);
     }
-    for (TextArea *textLayoutItem : qAsConst(textLayoutItems)) {
-        textLayoutItem->paintAll(*painter);
+    {
+        PaintProfiler::Scope scope(PaintProfile::HeaderFooterPhase);
+        for (TextArea *textLayoutItem : qAsConst(textLayoutItems)) {
+            textLayoutItem->paintAll(*painter);
+        }
     }
+    PaintProfiler::Scope scope(PaintProfile::LegendPhase);
     for (Legend *legend : qAsConst(legends)) {
         const bool hidden = legend->isHidden() && legend->testAttribute(Qt::WA_WState_ExplicitShowHide);
         if (!hidden) {
@@ -1381,6 +1444,21 @@ void Chart::resizeEvent(QResizeEvent *event)
     QWidget::resizeEvent(event);
 }
 
+void Chart::setPaintProfilingEnabled(bool enabled)
+{
+    d->paintProfilingEnabled = enabled;
+}
+
+bool Chart::isPaintProfilingEnabled() const
+{
+    return d->paintProfilingEnabled;
+}
+
+PaintProfile Chart::lastPaintProfile() const
+{
+    return d->lastPaintProfile;
+}
+
 void Chart::reLayoutFloatingLegends()
 {
     for (Legend *legend : qAsConst(d->legends)) {
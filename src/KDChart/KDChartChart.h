@@ -58,6 +58,7 @@ class AbstractDiagram;
 class AbstractCoordinatePlane;
 class HeaderFooter;
 class Legend;
+struct PaintProfile;
 
 typedef QList<AbstractCoordinatePlane *> CoordinatePlaneList;
 typedef QList<HeaderFooter *> HeaderFooterList;
@@ -428,6 +429,33 @@ public:
      */
     void paint(QPainter *painter, const QRect &target);
 
+    /**
+     * Enables or disables recording where the time goes when the chart is painted.
+     *
+     * While enabled, every paint records the wall time of its phases, the number of
+     * primitives painted, model fetches and cache lookups in a PaintProfile. Recording
+     * is disabled by default; while disabled, it costs next to nothing.
+     *
+     * \sa lastPaintProfile()
+     */
+    void setPaintProfilingEnabled(bool enabled);
+
+    /**
+     * \return Whether a PaintProfile is recorded for every paint.
+     *
+     * \sa setPaintProfilingEnabled()
+     */
+    bool isPaintProfilingEnabled() const;
+
+    /**
+     * \return The profile of the most recent paint with profiling enabled, or an invalid
+     * profile if there was none. It is up to date when finishedDrawing() is emitted, or
+     * when paint() returns.
+     *
+     * \sa setPaintProfilingEnabled(), PaintProfile::toChromeTrace()
+     */
+    PaintProfile lastPaintProfile() const;
+
     void reLayoutFloatingLegends();
 
 Q_SIGNALS:
@@ -31,6 +31,7 @@
 #include "KDChartChart.h"
 #include "KDChartFrameAttributes.h"
 #include "KDChartLayoutItems.h"
+#include "KDChartPaintProfile.h"
 #include "KDChartTextArea.h"
 
 #include <KDABLibFakes>
@@ -128,6 +129,9 @@ public:
     QSize overrideSize;
     bool isFloatingLegendsLayoutDirty;
     bool isPlanesLayoutDirty;
+    // the size hints of the axes as the planes were last laid out with, so that data
+    // changes only cause a new layout if they change the size of an axis
+    QHash<const CartesianAxis *, QSize> axisSizeHints;
 
     // since we do not want to derive Chart from AbstractAreaBase, we store the attributes
     // here and call two static painting methods to draw the background and frame.
@@ -141,12 +145,17 @@ public:
 
     Qt::LayoutDirection layoutDirection;
 
+    bool paintProfilingEnabled = false;
+    PaintProfile lastPaintProfile;
+
     Private(Chart *);
 
     ~Private() override;
 
     void createLayouts();
     void updateDirtyLayouts();
+    void recordAxisSizeHints();
+    bool axisSizeHintsChanged() const;
     void reapplyInternalLayouts(); // TODO: see if this can be merged with updateDirtyLayouts()
     void paintAll(QPainter *painter);
 
@@ -0,0 +1,71 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartDiagramDataCache_p.h"
+
+#include "KDChartAbstractDiagram.h"
+
+#include <KDABLibFakes>
+
+using namespace KDChart;
+
+void DiagramDataCache::update(const AbstractDiagram *diagram)
+{
+    QAbstractItemModel *model = diagram->model();
+    if (m_cache.model() != model) {
+        // the root index belongs to the old model, drop it before resetting to the new one
+        m_cache.setRootIndex(QModelIndex());
+        m_cache.setModel(model);
+    }
+    if (m_cache.rootIndex() != diagram->rootIndex())
+        m_cache.setRootIndex(diagram->rootIndex());
+}
+
+qreal DiagramDataCache::value(int row, int column) const
+{
+    const QAbstractItemModel *model = m_cache.model();
+    if (model == nullptr)
+        return std::numeric_limits<qreal>::quiet_NaN();
+    return m_cache.data(model->index(row, column, m_cache.rootIndex()));
+}
+
+qreal DiagramDataCache::valueOrZero(int row, int column) const
+{
+    const qreal v = value(row, column);
+    return ISNAN(v) ? 0.0 : v;
+}
+
+PolylineCompressor::PolylineCompressor(qreal tolerance)
+    : m_tolerance(tolerance)
+{
+}
+
+void PolylineCompressor::append(const QPointF &point)
+{
+    if (!m_polygon.isEmpty()) {
+        const QPointF &last = m_polygon.last();
+        if (qAbs(point.x() - last.x()) < m_tolerance && qAbs(point.y() - last.y()) < m_tolerance) {
+            m_pending = point;
+            m_hasPending = true;
+            return;
+        }
+    }
+    m_polygon.append(point);
+    m_hasPending = false;
+}
+
+QPolygonF PolylineCompressor::polygon() const
+{
+    if (!m_hasPending)
+        return m_polygon;
+    QPolygonF result = m_polygon;
+    result.append(m_pending);
+    return result;
+}
@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTDIAGRAMDATACACHE_P_H
+#define KDCHARTDIAGRAMDATACACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QPolygonF>
+
+#include "KDChartModelDataCache_p.h"
+
+namespace KDChart {
+
+class AbstractDiagram;
+
+/**
+ * \internal
+ * The values of the model of a polar, radar or ternary diagram.
+ *
+ * Each value is converted from QVariant once and kept until the model signals
+ * a change, so calculating the data boundaries and painting, and painting again,
+ * do not go through QVariant for every cell.
+ */
+class KDCHART_EXPORT DiagramDataCache
+{
+public:
+    /**
+     * Makes the cache follow the model and root index of @p diagram. Call this
+     * before reading values, the diagram's model may have been replaced.
+     */
+    void update(const AbstractDiagram *diagram);
+
+    /** Returns the value at @p row and @p column, NaN if the cell is empty. */
+    qreal value(int row, int column) const;
+
+    /** Returns the value at @p row and @p column, 0 if the cell is empty, like QVariant::toReal(). */
+    qreal valueOrZero(int row, int column) const;
+
+private:
+    ModelDataCache<qreal, Qt::DisplayRole> m_cache;
+};
+
+/**
+ * \internal
+ * Builds a polyline at the resolution of the paint device.
+ *
+ * A point that is closer than the tolerance, in both directions, to the last point
+ * kept is dropped, so datasets with many more values than there are pixels along
+ * the line only keep the points that make a visible difference. The last point
+ * appended is always kept.
+ */
+class KDCHART_EXPORT PolylineCompressor
+{
+public:
+    explicit PolylineCompressor(qreal tolerance = 0.5);
+
+    void append(const QPointF &point);
+    /** Returns the polyline built so far. */
+    QPolygonF polygon() const;
+
+private:
+    QPolygonF m_polygon;
+    QPointF m_pending;
+    bool m_hasPending = false;
+    qreal m_tolerance;
+};
+}
+
+#endif
@@ -13,9 +13,12 @@
 #include "KDChartAbstractDiagram.h"
 #include "KDChartBackgroundAttributes.h"
 #include "KDChartFrameAttributes.h"
+#include "KDChartLegendSymbolCache_p.h"
 #include "KDChartPaintContext.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartPrintingParameters.h"
+#include "KDChartTextMetricsCache_p.h"
 #include "KDTextDocument.h"
 #include <QAbstractTextDocumentLayout>
 #include <QApplication>
@@ -322,30 +325,47 @@ qreal KDChart::TextLayoutItem::fitFontSizeToGeometry() const
 {
     QFont f = realFont();
     const qreal origResult = f.pointSizeF();
-    qreal result = origResult;
     const qreal minSize = mAttributes.minimalFontSize().value();
     const QSize mySize = geometry().size();
     if (mySize.isNull()) {
-        return result;
+        return origResult;
     }
 
-    QFontMetrics fm(f);
-    while (true) {
-        const QSizeF textSize = rotatedRect(fm.boundingRect(mText), mAttributes.rotation()).normalized().size();
-
-        if (textSize.height() <= mySize.height() && textSize.width() <= mySize.width()) {
-            return result;
+    const auto fits = [&](qreal size) {
+        if (size != origResult) {
+            f.setPointSizeF(size);
         }
+        const QRectF rect = TextMetricsCache::boundingRect(f, mText, TextMetricsCache::SingleLine);
+        const QSizeF textSize = rotatedRect(rect, mAttributes.rotation()).normalized().size();
+        return textSize.height() <= mySize.height() && textSize.width() <= mySize.width();
+    };
+    if (fits(origResult)) {
+        return origResult;
+    }
 
-        result -= 0.5;
-        if (minSize > 0 && result < minSize) {
-            return result + 0.5;
-        } else if (result <= 0.0) {
-            return origResult;
+    // the candidates are the sizes in steps of 0.5pt below the original size, down to the
+    // minimal font size, or else down to 0.5pt; the largest one that fits wins
+    const int steps = minSize > 0 ? int(floor((origResult - minSize) / 0.5))
+                                  : int(ceil(origResult / 0.5)) - 1;
+    if (steps < 1) {
+        return origResult;
+    }
+    if (!fits(origResult - 0.5 * steps)) {
+        // nothing fits: use the minimal font size, or give up
+        return minSize > 0 ? origResult - 0.5 * steps : origResult;
+    }
+    // bisect for the fewest steps that fit; low never fits, high always does
+    int low = 0;
+    int high = steps;
+    while (high - low > 1) {
+        const int middle = low + (high - low) / 2;
+        if (fits(origResult - 0.5 * middle)) {
+            high = middle;
+        } else {
+            low = middle;
         }
-        f.setPointSizeF(result);
-        fm = QFontMetrics(f);
     }
+    return origResult - 0.5 * high;
 }
 
 qreal KDChart::TextLayoutItem::realFontSize() const
@@ -418,10 +438,10 @@ QSize KDChart::TextLayoutItem::unrotatedTextSize(QFont fnt) const
         fnt = realFont(); // this is the cached font in most cases
     }
 
-    const QFontMetricsF fm(fnt, GlobalMeasureScaling::paintDevice());
-    QRect veryLarge(0, 0, 100000, 100000);
-    // this overload of boundingRect() interprets \n as line breaks, not as regular characters.
-    return fm.boundingRect(veryLarge, Qt::AlignLeft | Qt::AlignTop, mText).size().toSize();
+    return TextMetricsCache::boundingRect(fnt, mText, TextMetricsCache::MultipleLines,
+                                          GlobalMeasureScaling::paintDevice())
+        .size()
+        .toSize();
 }
 
 int KDChart::TextLayoutItem::marginWidth() const
@@ -472,6 +492,7 @@ void KDChart::TextLayoutItem::paint(QPainter *painter)
     if (!mRect.isValid()) {
         return;
     }
+    PaintProfiler::count(PaintProfile::LabelCounter);
     const PainterSaver painterSaver(painter);
     QFont f = realFont();
     if (mAttributes.autoShrink()) {
@@ -651,7 +672,9 @@ QSize KDChart::MarkerLayoutItem::sizeHint() const
 
 void KDChart::MarkerLayoutItem::paint(QPainter *painter)
 {
-    paintIntoRect(painter, mRect, mDiagram, mMarker, mBrush, mPen);
+    LegendSymbolCache::paint(painter, mRect, &mSymbolImage, [this](QPainter *p, const QRect &rect) {
+        paintIntoRect(p, rect, mDiagram, mMarker, mBrush, mPen);
+    });
 }
 
 void KDChart::MarkerLayoutItem::paintIntoRect(
@@ -748,6 +771,7 @@ void KDChart::LineLayoutItem::setLegendLineSymbolAlignment(Qt::Alignment legendL
         return;
 
     mLegendLineSymbolAlignment = legendLineSymbolAlignment;
+    mSymbolImage = QImage();
 }
 
 Qt::Alignment KDChart::LineLayoutItem::legendLineSymbolAlignment() const
@@ -757,7 +781,9 @@ Qt::Alignment KDChart::LineLayoutItem::legendLineSymbolAlignment() const
 
 void KDChart::LineLayoutItem::paint(QPainter *painter)
 {
-    paintIntoRect(painter, mRect, mPen, mLegendLineSymbolAlignment);
+    LegendSymbolCache::paint(painter, mRect, &mSymbolImage, [this](QPainter *p, const QRect &rect) {
+        paintIntoRect(p, rect, mPen, mLegendLineSymbolAlignment);
+    });
 }
 
 void KDChart::LineLayoutItem::paintIntoRect(
@@ -842,15 +868,17 @@ QSize KDChart::LineWithMarkerLayoutItem::sizeHint() const
 
 void KDChart::LineWithMarkerLayoutItem::paint(QPainter *painter)
 {
-    // paint the line over the full width, into the vertical middle of the rect
-    LineLayoutItem::paintIntoRect(painter, mRect, mLinePen, Qt::AlignCenter);
-
-    // paint the marker with the given offset from the left side of the line
-    const QRect r(
-        QPoint(mRect.x() + mMarkerOffs, mRect.y()),
-        QSize(mMarker.markerSize().toSize().width(), mRect.height()));
-    MarkerLayoutItem::paintIntoRect(
-        painter, r, mDiagram, mMarker, mMarkerBrush, mMarkerPen);
+    LegendSymbolCache::paint(painter, mRect, &mSymbolImage, [this](QPainter *p, const QRect &rect) {
+        // paint the line over the full width, into the vertical middle of the rect
+        LineLayoutItem::paintIntoRect(p, rect, mLinePen, Qt::AlignCenter);
+
+        // paint the marker with the given offset from the left side of the line
+        const QRect r(
+            QPoint(rect.x() + mMarkerOffs, rect.y()),
+            QSize(mMarker.markerSize().toSize().width(), rect.height()));
+        MarkerLayoutItem::paintIntoRect(
+            p, r, mDiagram, mMarker, mMarkerBrush, mMarkerPen);
+    });
 }
 
 KDChart::AutoSpacerLayoutItem::AutoSpacerLayoutItem(
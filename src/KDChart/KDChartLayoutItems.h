@@ -14,6 +14,7 @@
 #include <QBrush>
 #include <QFont>
 #include <QFontMetricsF>
+#include <QImage>
 #include <QLayout>
 #include <QLayoutItem>
 #include <QPen>
@@ -239,6 +240,7 @@ private:
     MarkerAttributes mMarker;
     QBrush mBrush;
     QPen mPen;
+    QImage mSymbolImage;
 };
 
 /**
@@ -279,6 +281,7 @@ private:
     QPen mPen;
     QRect mRect;
     Qt::Alignment mLegendLineSymbolAlignment;
+    QImage mSymbolImage;
 };
 
 /**
@@ -316,6 +319,7 @@ private:
     MarkerAttributes mMarker;
     QBrush mMarkerBrush;
     QPen mMarkerPen;
+    QImage mSymbolImage;
 };
 
 /**
@@ -11,6 +11,10 @@
 #include "KDChartLegend.h"
 #include "KDChartLayoutItems.h"
 #include "KDChartLegend_p.h"
+#include "KDChartLegendSymbolCache_p.h"
+#include "KDChartPainterSaver_p.h"
+#include "KDChartPrintingParameters.h"
+#include "KDChartTextMetricsCache_p.h"
 #include "KDTextDocument.h"
 #include <KDChartAbstractDiagram.h>
 #include <KDChartDiagramObserver.h>
@@ -19,19 +23,25 @@
 #include <KDChartTextAttributes.h>
 
 #include <QAbstractTextDocumentLayout>
+#include <QApplication>
 #include <QFont>
 #include <QGridLayout>
 #include <QLabel>
+#include <QPaintEngine>
 #include <QPainter>
+#include <QStyle>
 #include <QTextCharFormat>
 #include <QTextCursor>
 #include <QTextDocumentFragment>
 #include <QTextTableCell>
 #include <QTimer>
 #include <QtDebug>
+#include <QtMath>
 
 #include <KDABLibFakes>
 
+#include <algorithm>
+
 using namespace KDChart;
 
 Legend::Private::Private()
@@ -186,6 +196,7 @@ Legend *Legend::clone() const
     legend->setAlignment(alignment());
     legend->setTextAlignment(textAlignment());
     legend->setLegendStyle(legendStyle());
+    legend->setVirtualized(isVirtualized());
     return legend;
 }
 
@@ -198,7 +209,7 @@ bool Legend::compare(const Legend *other) const
         return false;
     }
 
-    return (AbstractAreaBase::compare(other)) && (isVisible() == other->isVisible()) && (position() == other->position()) && (alignment() == other->alignment()) && (textAlignment() == other->textAlignment()) && (floatingPosition() == other->floatingPosition()) && (orientation() == other->orientation()) && (showLines() == other->showLines()) && (texts() == other->texts()) && (brushes() == other->brushes()) && (pens() == other->pens()) && (markerAttributes() == other->markerAttributes()) && (useAutomaticMarkerSize() == other->useAutomaticMarkerSize()) && (textAttributes() == other->textAttributes()) && (titleText() == other->titleText()) && (titleTextAttributes() == other->titleTextAttributes()) && (spacing() == other->spacing()) && (legendStyle() == other->legendStyle());
+    return (AbstractAreaBase::compare(other)) && (isVisible() == other->isVisible()) && (position() == other->position()) && (alignment() == other->alignment()) && (textAlignment() == other->textAlignment()) && (floatingPosition() == other->floatingPosition()) && (orientation() == other->orientation()) && (showLines() == other->showLines()) && (texts() == other->texts()) && (brushes() == other->brushes()) && (pens() == other->pens()) && (markerAttributes() == other->markerAttributes()) && (useAutomaticMarkerSize() == other->useAutomaticMarkerSize()) && (textAttributes() == other->textAttributes()) && (titleText() == other->titleText()) && (titleTextAttributes() == other->titleTextAttributes()) && (spacing() == other->spacing()) && (legendStyle() == other->legendStyle()) && (isVirtualized() == other->isVirtualized());
 }
 
 void Legend::paint(QPainter *painter)
@@ -529,6 +540,21 @@ bool Legend::useAutomaticMarkerSize() const
     return d->useAutomaticMarkerSize;
 }
 
+void Legend::setVirtualized(bool virtualized)
+{
+    if (d->virtualized == virtualized) {
+        return;
+    }
+    d->virtualized = virtualized;
+    setNeedRebuild();
+    emitPositionChanged();
+}
+
+bool Legend::isVirtualized() const
+{
+    return d->virtualized;
+}
+
 /**
     \brief Removes all legend texts that might have been set by setText.
 
@@ -549,6 +575,11 @@ void Legend::setText(uint dataset, const QString &text)
         return;
     }
     d->texts[dataset] = text;
+    if (d->entries) {
+        d->entries->updateText(dataset);
+        Q_EMIT propertiesChanged();
+        return;
+    }
     setNeedRebuild();
 }
 
@@ -570,7 +601,9 @@ void Legend::setColor(uint dataset, const QColor &color)
 {
     if (d->brushes[dataset] != color) {
         d->brushes[dataset] = color;
-        setNeedRebuild();
+        if (!d->entries) {
+            setNeedRebuild();
+        }
         update();
     }
 }
@@ -579,7 +612,9 @@ void Legend::setBrush(uint dataset, const QBrush &brush)
 {
     if (d->brushes[dataset] != brush) {
         d->brushes[dataset] = brush;
-        setNeedRebuild();
+        if (!d->entries) {
+            setNeedRebuild();
+        }
         update();
     }
 }
@@ -609,7 +644,9 @@ void Legend::setBrushesFromDiagram(AbstractDiagram *diagram)
         }
     }
     if (changed) {
-        setNeedRebuild();
+        if (!d->entries) {
+            setNeedRebuild();
+        }
         update();
     }
 }
@@ -620,7 +657,11 @@ void Legend::setPen(uint dataset, const QPen &pen)
         return;
     }
     d->pens[dataset] = pen;
-    setNeedRebuild();
+    if (d->entries) {
+        d->entries->updateSymbols();
+    } else {
+        setNeedRebuild();
+    }
     update();
 }
 
@@ -644,7 +685,11 @@ void Legend::setMarkerAttributes(uint dataset, const MarkerAttributes &markerAtt
         return;
     }
     d->markerAttributes[dataset] = markerAttributes;
-    setNeedRebuild();
+    if (d->entries) {
+        d->entries->updateSymbols();
+    } else {
+        setNeedRebuild();
+    }
     update();
 }
 
@@ -812,7 +857,7 @@ void Legend::Private::fetchPaintOptions(Legend *q)
     Q_ASSERT(modelLabels.count() == modelBrushes.count());
 }
 
-QSizeF Legend::Private::markerSize(Legend *q, int dataset, qreal fontHeight) const
+static QSizeF legendMarkerSize(const Legend *q, int dataset, qreal fontHeight)
 {
     QSizeF suppliedSize = q->markerAttributes(dataset).markerSize();
     if (q->useAutomaticMarkerSize() || !suppliedSize.isValid()) {
@@ -822,6 +867,11 @@ QSizeF Legend::Private::markerSize(Legend *q, int dataset, qreal fontHeight) con
     }
 }
 
+QSizeF Legend::Private::markerSize(Legend *q, int dataset, qreal fontHeight) const
+{
+    return legendMarkerSize(q, dataset, fontHeight);
+}
+
 QSizeF Legend::Private::maxMarkerSize(Legend *q, qreal fontHeight) const
 {
     QSizeF ret(1.0, 1.0);
@@ -833,6 +883,33 @@ QSizeF Legend::Private::maxMarkerSize(Legend *q, qreal fontHeight) const
     return ret;
 }
 
+// If we show a marker on a line, we paint it after 8 pixels
+// of the line have been painted. This allows to see the line style
+// at the right side of the marker without the line needing to
+// be too long.
+// (having the marker in the middle of the line would require longer lines)
+static const int s_lineLengthLeftOfMarker = 8;
+
+static int legendMaxLineLength(const Legend *q, int datasetCount, const QSizeF &maxMarkerSize)
+{
+    int ret = 18;
+    bool hasComplexPenStyle = false;
+    for (int dataset = 0; dataset < datasetCount; ++dataset) {
+        const QPen pn = q->pen(dataset);
+        const Qt::PenStyle ps = pn.style();
+        if (ps != Qt::NoPen) {
+            ret = qMax(pn.width() * 18, ret);
+            if (ps != Qt::SolidLine) {
+                hasComplexPenStyle = true;
+            }
+        }
+    }
+    if (hasComplexPenStyle && q->legendStyle() != Legend::LinesOnly) {
+        ret += s_lineLengthLeftOfMarker + int(maxMarkerSize.width());
+    }
+    return ret;
+}
+
 HDatasetItem::HDatasetItem()
 {
 }
@@ -892,6 +969,19 @@ void Legend::buildLegend()
         }
     }
 
+    if (isVirtualized() && orientation() == Qt::Vertical) {
+        // one item for all datasets, it knows the geometry of each entry
+        if (d->modelLabels.count()) {
+            d->entries = new LegendEntriesLayoutItem(this, d->modelLabels.count());
+            d->entries->setParentWidget(this);
+            d->paintItems << d->entries;
+            d->layout->addItem(d->entries, 2, 0, 1, 5, Qt::AlignLeft | Qt::AlignTop);
+        }
+        updateToplevelLayout(this);
+        Q_EMIT propertiesChanged();
+        return;
+    }
+
     qreal fontHeight = textAttributes().calculatedFontSize(referenceArea(), measureOrientation);
     {
         QFont tmpFont = textAttributes().font();
@@ -904,31 +994,8 @@ void Legend::buildLegend()
     }
 
     const QSizeF maxMarkerSize = d->maxMarkerSize(this, fontHeight);
-
-    // If we show a marker on a line, we paint it after 8 pixels
-    // of the line have been painted. This allows to see the line style
-    // at the right side of the marker without the line needing to
-    // be too long.
-    // (having the marker in the middle of the line would require longer lines)
-    const int lineLengthLeftOfMarker = 8;
-
-    int maxLineLength = 18;
-    {
-        bool hasComplexPenStyle = false;
-        for (int dataset = 0; dataset < d->modelLabels.count(); ++dataset) {
-            const QPen pn = pen(dataset);
-            const Qt::PenStyle ps = pn.style();
-            if (ps != Qt::NoPen) {
-                maxLineLength = qMax(pn.width() * 18, maxLineLength);
-                if (ps != Qt::SolidLine) {
-                    hasComplexPenStyle = true;
-                }
-            }
-        }
-        if (hasComplexPenStyle && legendStyle() != LinesOnly) {
-            maxLineLength += lineLengthLeftOfMarker + int(maxMarkerSize.width());
-        }
-    }
+    const int lineLengthLeftOfMarker = s_lineLengthLeftOfMarker;
+    const int maxLineLength = legendMaxLineLength(this, d->modelLabels.count(), maxMarkerSize);
 
     // for all datasets: add (line)marker items and text items to the layout;
     // actual layout happens in flowHDatasetItems() for horizontal layout, here for vertical
@@ -1170,6 +1237,310 @@ void Legend::Private::destroyOldLayout()
     Q_ASSERT(!layout->count());
     hLayoutDatasets.clear();
     paintItems.clear();
+    entries = nullptr;
+}
+
+static int labelWidth(const QString &text, const QFont &font)
+{
+    return qCeil(TextMetricsCache::horizontalAdvance(font, text, GlobalMeasureScaling::paintDevice()));
+}
+
+LegendEntriesLayoutItem::LegendEntriesLayoutItem(Legend *legend, int count)
+    : AbstractLayoutItem(Qt::AlignLeft | Qt::AlignTop)
+    , mLegend(legend)
+    , mCount(count)
+{
+}
+
+Qt::Orientations LegendEntriesLayoutItem::expandingDirections() const
+{
+    return {}; // Grow neither vertically nor horizontally
+}
+
+QRect LegendEntriesLayoutItem::geometry() const
+{
+    return mRect;
+}
+
+bool LegendEntriesLayoutItem::isEmpty() const
+{
+    return false; // never empty, otherwise the layout item would not exist
+}
+
+QSize LegendEntriesLayoutItem::maximumSize() const
+{
+    return sizeHint();
+}
+
+QSize LegendEntriesLayoutItem::minimumSize() const
+{
+    return sizeHint();
+}
+
+void LegendEntriesLayoutItem::setGeometry(const QRect &r)
+{
+    mRect = r;
+}
+
+QSize LegendEntriesLayoutItem::sizeHint() const
+{
+    ensureSymbolMetrics();
+    return QSize(textColumnLeft() + mMaxTextWidth + mTextMargin,
+                 mCount * rowPitch() - rowPitch() + rowHeight());
+}
+
+int LegendEntriesLayoutItem::count() const
+{
+    return mCount;
+}
+
+QRect LegendEntriesLayoutItem::rowRect(int row) const
+{
+    return QRect(mRect.left(), mRect.top() + row * rowPitch(), mRect.width(), rowHeight());
+}
+
+/**
+ * Re-measures the label of \a row only. The layout is only invalidated if
+ * that changes the width of the widest label.
+ */
+void LegendEntriesLayoutItem::updateText(int row)
+{
+    if (row < 0 || row >= mCount || !mTextMetricsValid) {
+        changed(false);
+        return;
+    }
+    const int oldWidth = mTextWidths.at(row);
+    const int newWidth = labelWidth(mLegend->text(row), mFont);
+    mTextWidths[row] = newWidth;
+
+    bool geometryChanged = false;
+    if (newWidth > mMaxTextWidth) {
+        mMaxTextWidth = newWidth;
+        geometryChanged = true;
+    } else if (oldWidth == mMaxTextWidth && newWidth < oldWidth) {
+        mMaxTextWidth = *std::max_element(mTextWidths.constBegin(), mTextWidths.constEnd());
+        geometryChanged = mMaxTextWidth != oldWidth;
+    }
+    changed(geometryChanged);
+}
+
+/**
+ * Recalculates the size of the marker and line column after a pen or the
+ * marker attributes of a dataset changed. Labels are not measured again,
+ * the images of the symbols are painted again.
+ */
+void LegendEntriesLayoutItem::updateSymbols()
+{
+    mSymbols.clear();
+    if (!mSymbolMetricsValid) {
+        changed(false);
+        return;
+    }
+    const QSize oldSize = sizeHint();
+    mSymbolMetricsValid = false;
+    changed(sizeHint() != oldSize);
+}
+
+void LegendEntriesLayoutItem::changed(bool geometryChanged)
+{
+    if (geometryChanged) {
+        sizeHintChanged();
+        updateToplevelLayout(mParent);
+    }
+    if (mParent) {
+        mParent->update();
+    }
+}
+
+void LegendEntriesLayoutItem::ensureTextMetrics() const
+{
+    if (mTextMetricsValid) {
+        return;
+    }
+    const TextAttributes attrs = mLegend->textAttributes();
+    mFont = attrs.font();
+    const qreal fontSize = attrs.calculatedFontSize(mLegend->referenceArea(),
+                                                    KDChartEnums::MeasureOrientationMinimum);
+    if (fontSize > 0.0) {
+        mFont.setPointSizeF(fontSize);
+    }
+    const QFontMetricsF fm(mFont, GlobalMeasureScaling::paintDevice());
+    mFontHeight = qCeil(fm.height());
+    // same as TextLayoutItem::marginWidth()
+    mTextMargin = qMin(QApplication::style()->pixelMetric(QStyle::PM_ButtonMargin, nullptr, nullptr),
+                       mFontHeight * 2 / 3);
+
+    mTextWidths.resize(mCount);
+    mMaxTextWidth = 0;
+    for (int row = 0; row < mCount; ++row) {
+        mTextWidths[row] = labelWidth(mLegend->text(row), mFont);
+        mMaxTextWidth = qMax(mMaxTextWidth, mTextWidths.at(row));
+    }
+    mTextMetricsValid = true;
+}
+
+void LegendEntriesLayoutItem::ensureSymbolMetrics() const
+{
+    if (mSymbolMetricsValid) {
+        return;
+    }
+    ensureTextMetrics();
+    const Legend::LegendStyle style = mLegend->legendStyle();
+
+    mMaxMarkerSize = QSize(1, 1);
+    if (style != Legend::LinesOnly) {
+        for (int row = 0; row < mCount; ++row) {
+            mMaxMarkerSize = mMaxMarkerSize.expandedTo(legendMarkerSize(mLegend, row, mFontHeight).toSize());
+        }
+    }
+    mLineLength = 0;
+    mLineHeight = 0;
+    if (style != Legend::MarkersOnly) {
+        mLineLength = legendMaxLineLength(mLegend, mCount, mMaxMarkerSize);
+        for (int row = 0; row < mCount; ++row) {
+            mLineHeight = qMax(mLineHeight, qMax(mLegend->pen(row).width(), 2) + 2);
+        }
+    }
+    mSymbolMetricsValid = true;
+}
+
+int LegendEntriesLayoutItem::rowHeight() const
+{
+    ensureSymbolMetrics();
+    const int symbolHeight = mLegend->legendStyle() == Legend::LinesOnly
+        ? mLineHeight
+        : qMax(mLineHeight, mMaxMarkerSize.height());
+    return qMax(mFontHeight + mTextMargin, symbolHeight);
+}
+
+int LegendEntriesLayoutItem::rowPitch() const
+{
+    // the separator line takes 3 pixels, like HorizontalLineLayoutItem
+    const int spacing = int(mLegend->spacing());
+    return rowHeight() + spacing + (mLegend->showLines() ? 3 + spacing : 0);
+}
+
+int LegendEntriesLayoutItem::symbolColumnWidth() const
+{
+    ensureSymbolMetrics();
+    return mLegend->legendStyle() == Legend::MarkersOnly ? mMaxMarkerSize.width() : mLineLength;
+}
+
+int LegendEntriesLayoutItem::textColumnLeft() const
+{
+    // the separator line takes 3 pixels, like VerticalLineLayoutItem
+    const int spacing = int(mLegend->spacing());
+    return symbolColumnWidth() + spacing + (mLegend->showLines() ? 3 + spacing : 0);
+}
+
+void LegendEntriesLayoutItem::paint(QPainter *painter)
+{
+    if (!mRect.isValid() || !mCount) {
+        return;
+    }
+
+    // only paint the rows inside the clip region
+    QRect visible = mRect;
+    if (painter->hasClipping()) {
+        visible &= painter->clipBoundingRect().toAlignedRect();
+    } else if (QPaintEngine *engine = painter->paintEngine()) {
+        const QRegion systemClip = engine->systemClip();
+        if (!systemClip.isEmpty()) {
+            visible &= painter->deviceTransform().inverted().mapRect(systemClip.boundingRect());
+        }
+    }
+    if (visible.isEmpty()) {
+        return;
+    }
+    const int pitch = rowPitch();
+    const int firstRow = qMax(0, (visible.top() - mRect.top()) / pitch);
+    const int lastRow = qMin(mCount - 1, (visible.bottom() - mRect.top()) / pitch);
+
+    const PainterSaver painterSaver(painter);
+    if (mLegend->showLines()) {
+        const int spacing = int(mLegend->spacing());
+        const qreal x = mRect.left() + symbolColumnWidth() + spacing + 1;
+        painter->drawLine(QPointF(x, visible.top()), QPointF(x, visible.bottom()));
+        for (int row = firstRow; row <= lastRow && row < mCount - 1; ++row) {
+            const qreal y = rowRect(row).bottom() + spacing + 2;
+            painter->drawLine(QPointF(mRect.left(), y), QPointF(mRect.right(), y));
+        }
+    }
+
+    painter->setFont(mFont);
+    const QPen textPen = PrintingParameters::scalePen(mLegend->textAttributes().pen());
+    for (int row = firstRow; row <= lastRow; ++row) {
+        paintRow(painter, row, rowRect(row), textPen);
+    }
+}
+
+void LegendEntriesLayoutItem::paintRow(QPainter *painter, int row, const QRect &rect, const QPen &textPen) const
+{
+    const QRect symbolRect(rect.left(), rect.top(), symbolColumnWidth(), rect.height());
+
+    // It is possible to set the marker brush through markerAttributes as well as
+    // the dataset brush set in the diagram - the markerAttributes have higher precedence.
+    MarkerAttributes markerAttrs = mLegend->markerAttributes(row);
+    markerAttrs.setMarkerSize(legendMarkerSize(mLegend, row, mFontHeight));
+    const QBrush markerBrush = markerAttrs.markerColor().isValid() ? QBrush(markerAttrs.markerColor()) : mLegend->brush(row);
+    const QPen linePen = mLegend->pen(row);
+    const Qt::Alignment lineAlignment = mLegend->legendSymbolAlignment();
+
+    // brushes and the symbol alignment change without rebuilding the legend
+    if (mSymbols.size() != mCount) {
+        mSymbols.resize(mCount);
+    }
+    Symbol &symbol = mSymbols[row];
+    if (symbol.markerAttrs != markerAttrs || symbol.markerBrush != markerBrush
+        || symbol.linePen != linePen || symbol.lineAlignment != lineAlignment) {
+        symbol.markerAttrs = markerAttrs;
+        symbol.markerBrush = markerBrush;
+        symbol.linePen = linePen;
+        symbol.lineAlignment = lineAlignment;
+        symbol.image = QImage();
+    }
+    LegendSymbolCache::paint(painter, symbolRect, &symbol.image, [&](QPainter *p, const QRect &r) {
+        paintSymbol(p, r, markerAttrs, markerBrush, linePen, lineAlignment);
+    });
+
+    Qt::Alignment textAlignment = mLegend->textAlignment();
+    if (!(textAlignment & Qt::AlignVertical_Mask)) {
+        textAlignment |= Qt::AlignVCenter;
+    }
+    const QRect textRect(rect.left() + textColumnLeft(), rect.top(),
+                         mTextWidths.at(row) + mTextMargin, rect.height());
+    painter->setPen(textPen);
+    painter->drawText(textRect, textAlignment, mLegend->text(row));
+}
+
+void LegendEntriesLayoutItem::paintSymbol(QPainter *painter, const QRect &symbolRect, const MarkerAttributes &markerAttrs,
+                                          const QBrush &markerBrush, const QPen &linePen, Qt::Alignment lineAlignment) const
+{
+    switch (mLegend->legendStyle()) {
+    case Legend::MarkersOnly:
+        MarkerLayoutItem::paintIntoRect(painter, symbolRect, mLegend->diagram(), markerAttrs,
+                                        markerBrush, markerAttrs.pen());
+        break;
+    case Legend::LinesOnly: {
+        // enforce a minimum pen width, like LineLayoutItem
+        QPen pen = linePen;
+        if (pen.width() < 2) {
+            pen.setWidth(2);
+        }
+        LineLayoutItem::paintIntoRect(painter, symbolRect, pen, lineAlignment);
+        break;
+    }
+    case Legend::MarkersAndLines: {
+        LineLayoutItem::paintIntoRect(painter, symbolRect, linePen, Qt::AlignCenter);
+        const QRect markerRect(symbolRect.x() + s_lineLengthLeftOfMarker, symbolRect.y(),
+                               markerAttrs.markerSize().toSize().width(), symbolRect.height());
+        MarkerLayoutItem::paintIntoRect(painter, markerRect, mLegend->diagram(), markerAttrs,
+                                        markerBrush, markerAttrs.pen());
+        break;
+    }
+    default:
+        Q_ASSERT(false);
+    }
 }
 
 void Legend::setHiddenDatasets(const QList<uint> &hiddenDatasets)
@@ -357,6 +357,22 @@ m_legend->setFloatingPosition( relativePosition );
     void setUseAutomaticMarkerSize(bool useAutomaticMarkerSize);
     bool useAutomaticMarkerSize() const;
 
+    /**
+     * \brief Lays out the dataset entries of a vertical legend in rows of the same height.
+     *
+     * Meant for legends showing thousands of datasets: no layout items are created
+     * per dataset, label widths are measured once and cached, only the entries
+     * inside the visible area are painted, and changing the text, brush, pen or
+     * marker attributes of a single dataset does not rebuild the legend.
+     *
+     * Labels are painted as plain, single-line text. Horizontal legends are
+     * not affected by this setting.
+     *
+     * This option is off by default.
+     */
+    void setVirtualized(bool virtualized);
+    bool isVirtualized() const;
+
     void setTextAttributes(const TextAttributes &a);
     TextAttributes textAttributes() const;
 
@@ -0,0 +1,94 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartLegendSymbolCache_p.h"
+
+#include "KDChartPaintProfiler_p.h"
+
+#include <QPaintDevice>
+#include <QTransform>
+
+#include <math.h>
+
+using namespace KDChart;
+
+// the area of the image of a symbol: strokes of lines and markers reach a bit out of their rectangle
+static QRect imageRect(const QRect &rect)
+{
+    const int margin = rect.height() / 2 + 2;
+    return rect.adjusted(-margin, -margin, margin, margin);
+}
+
+static QSize imageSize(const QRect &rect, qreal devicePixelRatio)
+{
+    return (QSizeF(imageRect(rect).size()) * devicePixelRatio).toSize();
+}
+
+static bool isWhole(qreal value)
+{
+    return value == floor(value);
+}
+
+bool LegendSymbolCache::canCache(QPainter *painter, const QRect &rect)
+{
+    const QPaintDevice *device = painter->device();
+    if (!rect.isValid() || !device) {
+        return false;
+    }
+    switch (device->devType()) {
+    case QInternal::Widget:
+    case QInternal::Image:
+    case QInternal::Pixmap:
+        break;
+    default:
+        return false;
+    }
+    if (painter->compositionMode() != QPainter::CompositionMode_SourceOver) {
+        return false;
+    }
+    // images are only drawn pixel for pixel
+    const QTransform transform = painter->worldTransform();
+    if (transform.type() > QTransform::TxTranslate) {
+        return false;
+    }
+    const qreal devicePixelRatio = device->devicePixelRatioF();
+    const QPointF devicePosition = (QPointF(imageRect(rect).topLeft()) + QPointF(transform.dx(), transform.dy()))
+        * devicePixelRatio;
+    return isWhole(devicePosition.x()) && isWhole(devicePosition.y());
+}
+
+bool LegendSymbolCache::isCached(QPainter *painter, const QRect &rect, const QImage &image)
+{
+    const qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+    const bool cached = !image.isNull() && image.devicePixelRatio() == devicePixelRatio
+        && image.size() == imageSize(rect, devicePixelRatio);
+    PaintProfiler::countCacheLookup(cached);
+    return cached;
+}
+
+void LegendSymbolCache::beginImage(QPainter *imagePainter, QPainter *painter, const QRect &rect, QImage *image)
+{
+    const qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+    *image = QImage(imageSize(rect, devicePixelRatio), QImage::Format_ARGB32_Premultiplied);
+    image->setDevicePixelRatio(devicePixelRatio);
+    image->fill(Qt::transparent);
+
+    imagePainter->begin(image);
+    imagePainter->setRenderHints(painter->renderHints());
+    imagePainter->setPen(painter->pen());
+    imagePainter->setBrush(painter->brush());
+    // the symbol is painted at the same coordinates as it would be on the painter
+    imagePainter->translate(-imageRect(rect).topLeft());
+}
+
+void LegendSymbolCache::drawImage(QPainter *painter, const QRect &rect, const QImage &image)
+{
+    painter->drawImage(imageRect(rect).topLeft(), image);
+}
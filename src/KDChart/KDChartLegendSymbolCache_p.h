@@ -0,0 +1,74 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTLEGENDSYMBOLCACHE_P_H
+#define KDCHARTLEGENDSYMBOLCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QImage>
+#include <QPainter>
+#include <QRect>
+
+#include "kdchart_export.h"
+
+namespace KDChart {
+
+/**
+ * \internal
+ * Paints legend symbols once into an image and draws them from there.
+ *
+ * Markers and lines in the legend hardly ever change, but are painted again with
+ * every repaint of the chart. The image of a symbol is reused as long as it is
+ * painted in the same size, at the same device pixel ratio, at whole device pixels
+ * and without scaling. Printers, SVG and other vector output get the symbols
+ * painted directly.
+ */
+class KDCHART_EXPORT LegendSymbolCache
+{
+public:
+    /**
+     * Paints a symbol into @p rect by calling @p paintSymbol(QPainter *, const QRect &),
+     * either on @p painter or once into @p image, which is then drawn instead.
+     * The owner of @p image resets it when the symbol changes.
+     */
+    template<typename Paint>
+    static void paint(QPainter *painter, const QRect &rect, QImage *image, Paint paintSymbol)
+    {
+        if (!canCache(painter, rect)) {
+            paintSymbol(painter, rect);
+            return;
+        }
+        if (!isCached(painter, rect, *image)) {
+            QPainter imagePainter;
+            beginImage(&imagePainter, painter, rect, image);
+            paintSymbol(&imagePainter, rect);
+        }
+        drawImage(painter, rect, *image);
+    }
+
+private:
+    static bool canCache(QPainter *painter, const QRect &rect);
+    static bool isCached(QPainter *painter, const QRect &rect, const QImage &image);
+    static void beginImage(QPainter *imagePainter, QPainter *painter, const QRect &rect, QImage *image);
+    static void drawImage(QPainter *painter, const QRect &rect, const QImage &image);
+};
+}
+
+#endif
@@ -23,11 +23,13 @@
 //
 
 #include "KDChartAbstractAreaWidget_p.h"
+#include "KDChartLayoutItems.h"
 #include "KDChartLegend.h"
 #include <KDChartDiagramObserver.h>
 #include <KDChartMarkerAttributes.h>
 #include <KDChartTextAttributes.h>
 #include <QAbstractTextDocumentLayout>
+#include <QImage>
 #include <QList>
 #include <QPainter>
 #include <QVector>
@@ -61,6 +63,78 @@ class DiagramsObserversList : public QList<DiagramObserver *>
 {
 };
 
+/**
+ * \internal
+ *
+ * Layout item showing all dataset entries of a virtualized legend.
+ *
+ * The entries are laid out in rows of the same height, so the geometry of
+ * any entry is known without creating a layout item for it. Label widths
+ * are measured through TextMetricsCache, and only the rows that intersect
+ * the painter's clip region are painted.
+ */
+class LegendEntriesLayoutItem : public AbstractLayoutItem
+{
+public:
+    LegendEntriesLayoutItem(Legend *legend, int count);
+
+    Qt::Orientations expandingDirections() const override;
+    QRect geometry() const override;
+    bool isEmpty() const override;
+    QSize maximumSize() const override;
+    QSize minimumSize() const override;
+    void setGeometry(const QRect &r) override;
+    QSize sizeHint() const override;
+
+    void paint(QPainter *painter) override;
+
+    int count() const;
+    QRect rowRect(int row) const;
+
+    void updateText(int row);
+    void updateSymbols();
+
+private:
+    void ensureTextMetrics() const;
+    void ensureSymbolMetrics() const;
+    int rowHeight() const;
+    int rowPitch() const;
+    int symbolColumnWidth() const;
+    int textColumnLeft() const;
+    void paintRow(QPainter *painter, int row, const QRect &rect, const QPen &textPen) const;
+    void paintSymbol(QPainter *painter, const QRect &symbolRect, const MarkerAttributes &markerAttrs,
+                     const QBrush &markerBrush, const QPen &linePen, Qt::Alignment lineAlignment) const;
+    void changed(bool geometryChanged);
+
+    // the symbol of a row as painted last, and what it was painted from
+    struct Symbol
+    {
+        MarkerAttributes markerAttrs;
+        QBrush markerBrush;
+        QPen linePen;
+        Qt::Alignment lineAlignment;
+        QImage image;
+    };
+
+    Legend *const mLegend;
+    const int mCount;
+    QRect mRect;
+
+    mutable bool mTextMetricsValid = false;
+    mutable QFont mFont;
+    mutable int mFontHeight = 0;
+    mutable int mTextMargin = 0;
+    mutable QVector<int> mTextWidths;
+    mutable int mMaxTextWidth = 0;
+
+    mutable bool mSymbolMetricsValid = false;
+    mutable QSize mMaxMarkerSize;
+    mutable int mLineLength = 0;
+    mutable int mLineHeight = 0;
+
+    mutable QVector<Symbol> mSymbols;
+};
+
 /**
  * \internal
  */
@@ -111,6 +185,7 @@ private:
     uint spacing = 1;
     bool useAutomaticMarkerSize = true;
     LegendStyle legendStyle = MarkersOnly;
+    bool virtualized = false;
 
     // internal
     mutable QStringList modelLabels;
@@ -121,6 +196,7 @@ private:
     QVector<AbstractLayoutItem *> paintItems;
     QGridLayout *layout;
     QList<HDatasetItem> hLayoutDatasets;
+    LegendEntriesLayoutItem *entries = nullptr;
     DiagramsObserversList observers;
 };
 
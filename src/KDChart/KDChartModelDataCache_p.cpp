@@ -10,8 +10,11 @@
 
 #include "KDChartModelDataCache_p.h"
 
+#include <QAbstractItemModel>
+
 #include <limits>
 
+using namespace KDChart;
 using namespace KDChart::ModelDataCachePrivate;
 
 ModelSignalMapperConnector::ModelSignalMapperConnector(ModelSignalMapper &mapper)
@@ -87,3 +90,47 @@ void ModelSignalMapperConnector::rowsRemoved(const QModelIndex &parent, int star
 {
     m_mapper.rowsRemoved(parent, start, end);
 }
+
+// the registry of shared caches; there are only ever a few models shown by diagrams
+static QVector<SharedModelDataCache *> &sharedCaches()
+{
+    static QVector<SharedModelDataCache *> caches;
+    return caches;
+}
+
+SharedModelDataCache::SharedModelDataCache()
+{
+}
+
+SharedModelDataCache::~SharedModelDataCache()
+{
+}
+
+SharedModelDataCache *SharedModelDataCache::acquire(QAbstractItemModel *model)
+{
+    Q_ASSERT(model != nullptr);
+    SharedModelDataCache *cache = nullptr;
+    // the cache of a destroyed model has no model anymore, so it never matches a new one
+    for (SharedModelDataCache *candidate : qAsConst(sharedCaches())) {
+        if (candidate->model() == model) {
+            cache = candidate;
+            break;
+        }
+    }
+    if (!cache) {
+        cache = new SharedModelDataCache;
+        cache->setModel(model);
+        sharedCaches().append(cache);
+    }
+    ++cache->m_refCount;
+    return cache;
+}
+
+void SharedModelDataCache::release()
+{
+    Q_ASSERT(m_refCount > 0);
+    if (--m_refCount == 0) {
+        sharedCaches().removeOne(this);
+        delete this;
+    }
+}
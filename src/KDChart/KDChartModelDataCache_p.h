@@ -333,6 +333,39 @@ private:
     mutable QVector<QVector<T>> m_data;
     mutable QVector<QVector<bool>> m_cacheValid;
 };
+
+/**
+ * \internal
+ * A cache of the top level values of one model that is shared by everyone who
+ * acquires it for that model.
+ *
+ * Diagrams usually look at their data through their own AttributesModel; if several
+ * of them show the same source model, they can read the values from one shared cache
+ * instead of fetching and converting every value once per diagram.
+ *
+ * Every call of acquire() has to be balanced by a call of release(). Shared caches
+ * are not thread safe and must only be used from the GUI thread.
+ */
+class KDCHART_EXPORT SharedModelDataCache : public ModelDataCache<qreal, Qt::DisplayRole>
+{
+public:
+    /** Returns the shared cache of @p model, creating it if there is none yet. */
+    static SharedModelDataCache *acquire(QAbstractItemModel *model);
+    /** Gives up this reference; the cache is deleted when the last one is released. */
+    void release();
+
+    /** Returns the number of references to this cache. */
+    int refCount() const
+    {
+        return m_refCount;
+    }
+
+private:
+    SharedModelDataCache();
+    ~SharedModelDataCache() override;
+
+    int m_refCount = 0;
+};
 }
 
 #endif
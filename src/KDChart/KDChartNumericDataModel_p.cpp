@@ -0,0 +1,157 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartNumericDataModel_p.h"
+
+#include <algorithm>
+
+#include <KDABLibFakes>
+
+using namespace KDChart;
+
+NumericDataModel::NumericDataModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+NumericDataModel::~NumericDataModel()
+{
+}
+
+int NumericDataModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rowCount;
+}
+
+int NumericDataModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_columns.size();
+}
+
+QVariant NumericDataModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole)) {
+        return QVariant();
+    }
+    const qreal v = value(index.row(), index.column());
+    return ISNAN(v) ? QVariant() : QVariant(v);
+}
+
+bool NumericDataModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole)) {
+        return false;
+    }
+    // only an invalid or null value clears the cell
+    qreal v = std::numeric_limits<qreal>::quiet_NaN();
+    if (!value.isNull()) {
+        bool ok = false;
+        v = value.toReal(&ok);
+        if (!ok) {
+            return false;
+        }
+    }
+    setValue(index.row(), index.column(), v);
+    return true;
+}
+
+Qt::ItemFlags NumericDataModel::flags(const QModelIndex &index) const
+{
+    return QAbstractTableModel::flags(index) | Qt::ItemIsEditable;
+}
+
+QVariant NumericDataModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && (role == Qt::DisplayRole || role == Qt::EditRole)
+        && section >= 0 && section < m_headers.size() && m_headers.at(section).isValid()) {
+        return m_headers.at(section);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+bool NumericDataModel::setHeaderData(int section, Qt::Orientation orientation, const QVariant &value, int role)
+{
+    if (orientation != Qt::Horizontal || (role != Qt::DisplayRole && role != Qt::EditRole)
+        || section < 0 || section >= m_columns.size()) {
+        return false;
+    }
+    m_headers[section] = value;
+    Q_EMIT headerDataChanged(orientation, section, section);
+    return true;
+}
+
+bool NumericDataModel::insertRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || row < 0 || row > m_rowCount || count < 1) {
+        return false;
+    }
+    beginInsertRows(parent, row, row + count - 1);
+    for (QVector<qreal> &values : m_columns) {
+        // values at the end of a column that is shorter than the model are empty anyway
+        if (row < values.size()) {
+            values.insert(row, count, std::numeric_limits<qreal>::quiet_NaN());
+        }
+    }
+    m_rowCount += count;
+    endInsertRows();
+    return true;
+}
+
+bool NumericDataModel::insertColumns(int column, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || column < 0 || column > m_columns.size() || count < 1) {
+        return false;
+    }
+    beginInsertColumns(parent, column, column + count - 1);
+    m_columns.insert(column, count, QVector<qreal>());
+    m_headers.insert(column, count, QVariant());
+    endInsertColumns();
+    return true;
+}
+
+void NumericDataModel::clear()
+{
+    beginResetModel();
+    m_columns.clear();
+    m_headers.clear();
+    m_rowCount = 0;
+    endResetModel();
+}
+
+void NumericDataModel::setColumn(int column, const QVector<qreal> &values)
+{
+    Q_ASSERT(column >= 0 && column < m_columns.size());
+    Q_ASSERT(values.size() <= m_rowCount);
+    if (values.isEmpty()) {
+        return;
+    }
+    QVector<qreal> &target = m_columns[column];
+    if (values.size() >= target.size()) {
+        target = values;
+    } else {
+        std::copy(values.constBegin(), values.constEnd(), target.begin());
+    }
+    Q_EMIT dataChanged(index(0, column), index(values.size() - 1, column));
+}
+
+void NumericDataModel::setValue(int row, int column, qreal value)
+{
+    Q_ASSERT(column >= 0 && column < m_columns.size());
+    Q_ASSERT(row >= 0 && row < m_rowCount);
+    QVector<qreal> &target = m_columns[column];
+    if (row >= target.size()) {
+        const int oldSize = target.size();
+        target.resize(row + 1);
+        std::fill(target.begin() + oldSize, target.end(), std::numeric_limits<qreal>::quiet_NaN());
+    }
+    target[row] = value;
+    const QModelIndex changed = index(row, column);
+    Q_EMIT dataChanged(changed, changed);
+}
@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTNUMERICDATAMODEL_P_H
+#define KDCHARTNUMERICDATAMODEL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QAbstractTableModel>
+#include <QVector>
+
+#include <limits>
+
+#include "kdchart_export.h"
+
+namespace KDChart {
+
+/**
+ * \internal
+ * A table model that keeps each column as one contiguous array of qreal values.
+ *
+ * KDChart::Widget stores its data in this model. Columns are assigned as a whole by
+ * sharing the caller's QVector, and the data compressor of cartesian diagrams reads
+ * the values with value() instead of going through QModelIndex and QVariant.
+ *
+ * A column may be shorter than rowCount(); the missing values, and NaN values, are
+ * empty cells.
+ */
+class KDCHART_EXPORT NumericDataModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit NumericDataModel(QObject *parent = nullptr);
+    ~NumericDataModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool setHeaderData(int section, Qt::Orientation orientation, const QVariant &value,
+                       int role = Qt::EditRole) override;
+    bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool insertColumns(int column, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    /** Removes all rows, columns and header data. */
+    void clear();
+
+    /**
+     * Replaces the first values.size() values of the existing @p column by @p values.
+     * If that is the whole column, the column shares the data of @p values
+     * instead of copying it.
+     */
+    void setColumn(int column, const QVector<qreal> &values);
+
+    /** Sets the value of an existing cell. */
+    void setValue(int row, int column, qreal value);
+
+    /**
+     * Returns the values of an existing @p column, sharing its data. The vector may be
+     * shorter than rowCount(). It is not affected by later changes to the model and can
+     * be read from any thread.
+     */
+    QVector<qreal> column(int column) const
+    {
+        return m_columns.at(column);
+    }
+
+    /** Returns the value of an existing cell, NaN if it is empty. */
+    qreal value(int row, int column) const
+    {
+        const QVector<qreal> &values = m_columns.at(column);
+        return row < values.size() ? values.at(row) : std::numeric_limits<qreal>::quiet_NaN();
+    }
+
+private:
+    QVector<QVector<qreal>> m_columns;
+    QVector<QVariant> m_headers;
+    int m_rowCount = 0;
+};
+}
+
+#endif
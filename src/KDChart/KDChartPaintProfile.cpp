@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartPaintProfile.h"
+#include "KDChartPaintProfiler_p.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <KDABLibFakes>
+
+using namespace KDChart;
+
+bool PaintProfile::isValid() const
+{
+    return totalTime >= 0;
+}
+
+qreal PaintProfile::cacheHitRate() const
+{
+    const quint64 lookups = counters[CacheHitCounter] + counters[CacheMissCounter];
+    return lookups ? qreal(counters[CacheHitCounter]) / qreal(lookups) : 0.0;
+}
+
+static QJsonObject traceEvent(const QString &name, qint64 start, qint64 duration)
+{
+    QJsonObject event;
+    event.insert(QLatin1String("name"), name);
+    event.insert(QLatin1String("cat"), QLatin1String("KDChart"));
+    event.insert(QLatin1String("ph"), QLatin1String("X"));
+    // the trace event format uses microseconds
+    event.insert(QLatin1String("ts"), start / 1000.0);
+    event.insert(QLatin1String("dur"), duration / 1000.0);
+    event.insert(QLatin1String("pid"), 0);
+    event.insert(QLatin1String("tid"), 0);
+    return event;
+}
+
+QByteArray PaintProfile::toChromeTrace() const
+{
+    QJsonArray traceEvents;
+    if (isValid()) {
+        QJsonObject paint = traceEvent(QLatin1String("paint"), 0, totalTime);
+        QJsonObject args;
+        for (int i = 0; i < CounterCount; ++i) {
+            args.insert(counterName(Counter(i)), double(counters[i]));
+        }
+        paint.insert(QLatin1String("args"), args);
+        traceEvents.append(paint);
+
+        for (const Event &event : events) {
+            traceEvents.append(traceEvent(phaseName(event.phase), event.start, event.duration));
+        }
+    }
+
+    QJsonObject trace;
+    trace.insert(QLatin1String("traceEvents"), traceEvents);
+    trace.insert(QLatin1String("displayTimeUnit"), QLatin1String("ns"));
+    return QJsonDocument(trace).toJson(QJsonDocument::Compact);
+}
+
+QString PaintProfile::phaseName(Phase phase)
+{
+    switch (phase) {
+    case LayoutPhase:
+        return QString::fromLatin1("layout");
+    case BackgroundPhase:
+        return QString::fromLatin1("background");
+    case GridPhase:
+        return QString::fromLatin1("grid");
+    case AxisPhase:
+        return QString::fromLatin1("axis");
+    case DiagramPhase:
+        return QString::fromLatin1("diagram");
+    case DataValueTextsPhase:
+        return QString::fromLatin1("dataValueTexts");
+    case HeaderFooterPhase:
+        return QString::fromLatin1("headerFooter");
+    case LegendPhase:
+        return QString::fromLatin1("legend");
+    case PhaseCount:
+        break;
+    }
+    Q_ASSERT(false);
+    return QString();
+}
+
+QString PaintProfile::counterName(Counter counter)
+{
+    switch (counter) {
+    case PolylineCounter:
+        return QString::fromLatin1("polylines");
+    case RectCounter:
+        return QString::fromLatin1("rects");
+    case MarkerCounter:
+        return QString::fromLatin1("markers");
+    case LabelCounter:
+        return QString::fromLatin1("labels");
+    case ModelFetchCounter:
+        return QString::fromLatin1("modelFetches");
+    case CacheHitCounter:
+        return QString::fromLatin1("cacheHits");
+    case CacheMissCounter:
+        return QString::fromLatin1("cacheMisses");
+    case CounterCount:
+        break;
+    }
+    Q_ASSERT(false);
+    return QString();
+}
+
+thread_local PaintProfiler *PaintProfiler::s_current = nullptr;
+
+PaintProfiler::PaintProfiler(PaintProfile *profile)
+    : m_profile(profile)
+    , m_previous(s_current)
+{
+    *m_profile = PaintProfile();
+    m_profile->totalTime = 0;
+    s_current = this;
+    m_timer.start();
+}
+
+PaintProfiler::~PaintProfiler()
+{
+    while (!m_openPhases.isEmpty()) {
+        leavePhase();
+    }
+    m_profile->totalTime = m_timer.nsecsElapsed();
+    s_current = m_previous;
+}
+
+void PaintProfiler::enterPhase(PaintProfile::Phase phase)
+{
+    const PaintProfile::Event event = {phase, m_timer.nsecsElapsed(), 0, int(m_openPhases.size())};
+    m_profile->events.append(event);
+    const OpenPhase open = {int(m_profile->events.size()) - 1, 0};
+    m_openPhases.append(open);
+}
+
+void PaintProfiler::leavePhase()
+{
+    Q_ASSERT(!m_openPhases.isEmpty());
+    const OpenPhase open = m_openPhases.takeLast();
+    PaintProfile::Event &event = m_profile->events[open.event];
+    event.duration = m_timer.nsecsElapsed() - event.start;
+    m_profile->phaseTimes[event.phase] += event.duration - open.nestedTime;
+    if (!m_openPhases.isEmpty()) {
+        m_openPhases.last().nestedTime += event.duration;
+    }
+}
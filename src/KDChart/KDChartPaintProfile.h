@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTPAINTPROFILE_H
+#define KDCHARTPAINTPROFILE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "kdchart_export.h"
+
+namespace KDChart {
+
+/**
+ * @class PaintProfile KDChartPaintProfile.h KDChartPaintProfile
+ * @brief Timings and counters recorded while painting a Chart.
+ *
+ * Recording is switched on with Chart::setPaintProfilingEnabled(). The profile of
+ * the most recent paint is returned by Chart::lastPaintProfile(); it is complete when
+ * Chart::finishedDrawing() is emitted, or when Chart::paint() returns.
+ *
+ * Phase times are exclusive: time spent in a nested phase, like painting the data
+ * value texts of a diagram, only counts for the nested phase. All times are wall
+ * clock times in nanoseconds, relative to the start of the paint.
+ */
+struct KDCHART_EXPORT PaintProfile
+{
+    enum Phase
+    {
+        LayoutPhase, ///< updating dirty layouts and positioning floating legends
+        BackgroundPhase, ///< the chart's background and frame
+        GridPhase, ///< the grids of the coordinate planes
+        AxisPhase, ///< axes, including their tick labels
+        DiagramPhase, ///< diagram geometry and painting
+        DataValueTextsPhase, ///< the data value texts and markers of diagrams
+        HeaderFooterPhase, ///< headers, footers and other text areas
+        LegendPhase, ///< legends
+        PhaseCount
+    };
+
+    enum Counter
+    {
+        PolylineCounter, ///< lines, polylines, polygons and paths painted by diagrams
+        RectCounter, ///< bars and candlestick bodies
+        MarkerCounter, ///< markers of data points and legend entries
+        LabelCounter, ///< data value texts and text layout items like axis labels
+        ModelFetchCounter, ///< model indexes read into the data caches of diagrams
+        CacheHitCounter, ///< lookups answered by a data or layout cache
+        CacheMissCounter, ///< lookups that had to fill a data or layout cache
+        CounterCount
+    };
+
+    /// One phase as it was entered and left while painting
+    struct Event
+    {
+        Phase phase;
+        qint64 start; ///< in nanoseconds since the start of the paint
+        qint64 duration; ///< in nanoseconds, including nested phases
+        int depth; ///< the nesting level, 0 for the outermost phases
+    };
+
+    /// Returns true if this profile has been recorded by a paint
+    bool isValid() const;
+
+    /// Returns the ratio of cache hits to all cache lookups, or 0 if there were none
+    qreal cacheHitRate() const;
+
+    /**
+     * Returns the profile as a JSON document in the Chrome trace event format, which can
+     * be loaded into chrome://tracing, Perfetto or similar tools. Each phase is a
+     * complete event; the counters are attached to the event of the whole paint.
+     */
+    QByteArray toChromeTrace() const;
+
+    /// Returns a short name for @p phase, as used in the Chrome trace
+    static QString phaseName(Phase phase);
+    /// Returns a short name for @p counter, as used in the Chrome trace
+    static QString counterName(Counter counter);
+
+    qint64 totalTime = -1; ///< the wall time of the whole paint, or -1 if not recorded
+    qint64 phaseTimes[PhaseCount] = {}; ///< the exclusive wall time per phase
+    quint64 counters[CounterCount] = {};
+    QVector<Event> events; ///< the phases in the order they were entered
+};
+}
+
+#endif
@@ -0,0 +1,106 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTPAINTPROFILER_P_H
+#define KDCHARTPAINTPROFILER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "KDChartPaintProfile.h"
+
+#include <QElapsedTimer>
+#include <QVector>
+
+namespace KDChart {
+
+/**
+ * \internal
+ * Records a PaintProfile for as long as it exists. The profiler of the paint in progress
+ * is found through current(), so that the instrumented code deep down in the painting
+ * call tree does not need to know about it. When no profile is being recorded, current()
+ * is null and the instrumentation costs a load and a branch.
+ */
+class PaintProfiler
+{
+public:
+    explicit PaintProfiler(PaintProfile *profile);
+    ~PaintProfiler();
+
+    static PaintProfiler *current()
+    {
+        return s_current;
+    }
+
+    static void count(PaintProfile::Counter counter, quint64 amount = 1)
+    {
+        if (Q_UNLIKELY(s_current)) {
+            s_current->m_profile->counters[counter] += amount;
+        }
+    }
+
+    static void countCacheLookup(bool hit)
+    {
+        count(hit ? PaintProfile::CacheHitCounter : PaintProfile::CacheMissCounter);
+    }
+
+    /// Attributes the time of its own lifetime to a phase of the current paint
+    class Scope
+    {
+    public:
+        explicit Scope(PaintProfile::Phase phase)
+            : m_profiler(s_current)
+        {
+            if (Q_UNLIKELY(m_profiler)) {
+                m_profiler->enterPhase(phase);
+            }
+        }
+        ~Scope()
+        {
+            if (Q_UNLIKELY(m_profiler)) {
+                m_profiler->leavePhase();
+            }
+        }
+
+    private:
+        Q_DISABLE_COPY(Scope)
+        PaintProfiler *const m_profiler;
+    };
+
+private:
+    Q_DISABLE_COPY(PaintProfiler)
+
+    void enterPhase(PaintProfile::Phase phase);
+    void leavePhase();
+
+    struct OpenPhase
+    {
+        int event;
+        qint64 nestedTime;
+    };
+
+    PaintProfile *const m_profile;
+    PaintProfiler *const m_previous;
+    QElapsedTimer m_timer;
+    QVector<OpenPhase> m_openPhases;
+
+    static thread_local PaintProfiler *s_current;
+};
+}
+
+#endif
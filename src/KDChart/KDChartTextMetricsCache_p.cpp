@@ -0,0 +1,112 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartTextMetricsCache_p.h"
+
+#include "KDChartPaintProfiler_p.h"
+
+#include <QCache>
+#include <QFontMetrics>
+#include <QFontMetricsF>
+#include <QMutex>
+#include <QPaintDevice>
+
+using namespace KDChart;
+
+namespace {
+
+// enough for the texts of a few large charts, including the labels
+// of a legend with thousands of datasets
+const int MaximumCount = 65536;
+
+struct Key
+{
+    QFont font;
+    QString text;
+    TextMetricsCache::Layout layout;
+    // 0 for the screen
+    int dpiX;
+    int dpiY;
+
+    bool operator==(const Key &other) const
+    {
+        return layout == other.layout && dpiX == other.dpiX && dpiY == other.dpiY
+            && text == other.text && font == other.font;
+    }
+};
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+size_t qHash(const Key &key, size_t seed = 0)
+#else
+uint qHash(const Key &key, uint seed = 0)
+#endif
+{
+    return ::qHash(key.text, seed) ^ ::qHash(key.font, seed)
+        ^ ::qHash((key.dpiX << 16) ^ (key.dpiY << 1) ^ int(key.layout), seed);
+}
+
+struct Cache
+{
+    QMutex mutex;
+    QCache<Key, QRectF> rects { MaximumCount };
+};
+
+Q_GLOBAL_STATIC(Cache, s_cache)
+}
+
+QRectF TextMetricsCache::boundingRect(const QFont &font, const QString &text, Layout layout,
+                                      QPaintDevice *device)
+{
+    const Key key = { font, text, layout, device ? device->logicalDpiX() : 0, device ? device->logicalDpiY() : 0 };
+    Cache *const cache = s_cache();
+    {
+        QMutexLocker locker(&cache->mutex);
+        const QRectF *rect = cache->rects.object(key);
+        PaintProfiler::countCacheLookup(rect != nullptr);
+        if (rect) {
+            return *rect;
+        }
+    }
+
+    QRectF rect;
+    if (layout == SingleLine) {
+        rect = device ? QFontMetrics(font, device).boundingRect(text) : QFontMetrics(font).boundingRect(text);
+    } else if (layout == Advance) {
+        const QFontMetricsF fm(font, device);
+        rect = QRectF(0, 0, fm.horizontalAdvance(text), fm.height());
+    } else {
+        const QFontMetricsF fm(font, device);
+        const QRectF veryLarge(0, 0, 100000, 100000);
+        rect = fm.boundingRect(veryLarge, Qt::AlignLeft | Qt::AlignTop, text);
+    }
+
+    QMutexLocker locker(&cache->mutex);
+    cache->rects.insert(key, new QRectF(rect));
+    return rect;
+}
+
+qreal TextMetricsCache::horizontalAdvance(const QFont &font, const QString &text, QPaintDevice *device)
+{
+    return boundingRect(font, text, Advance, device).width();
+}
+
+void TextMetricsCache::clear()
+{
+    Cache *const cache = s_cache();
+    QMutexLocker locker(&cache->mutex);
+    cache->rects.clear();
+}
+
+int TextMetricsCache::count()
+{
+    Cache *const cache = s_cache();
+    QMutexLocker locker(&cache->mutex);
+    return int(cache->rects.count());
+}
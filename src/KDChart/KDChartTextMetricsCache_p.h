@@ -0,0 +1,83 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTTEXTMETRICSCACHE_P_H
+#define KDCHARTTEXTMETRICSCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QFont>
+#include <QRectF>
+#include <QString>
+
+#include "kdchart_export.h"
+
+QT_BEGIN_NAMESPACE
+class QPaintDevice;
+QT_END_NAMESPACE
+
+namespace KDChart {
+
+/**
+ * \internal
+ * The bounding rectangles of texts, shared by all charts of the process.
+ *
+ * Headers, footers, legends and axis titles measure the same texts in the same
+ * fonts on every relayout and resize, and shrinking a text to its geometry measures
+ * it in many sizes. Virtualized legends keep the labels of all their datasets here
+ * across rebuilds. Each measurement is done once with QFontMetrics and kept,
+ * keyed by font, text, layout and the resolution of the paint device.
+ *
+ * Rotation is not part of the key: rotating a cached rectangle is cheap.
+ */
+class KDCHART_EXPORT TextMetricsCache
+{
+public:
+    enum Layout
+    {
+        /// one line, like QFontMetrics::boundingRect(const QString &)
+        SingleLine,
+        /// \\n breaks lines, like QFontMetricsF::boundingRect() with a large rectangle
+        MultipleLines,
+        /// one line, with its horizontal advance as the width, see horizontalAdvance()
+        Advance
+    };
+
+    /**
+     * Returns the bounding rectangle of @p text in @p font, measured for @p device,
+     * or for the screen if @p device is null.
+     */
+    static QRectF boundingRect(const QFont &font, const QString &text, Layout layout,
+                               QPaintDevice *device = nullptr);
+
+    /**
+     * Returns the horizontal advance of @p text in @p font, like
+     * QFontMetricsF::horizontalAdvance(), measured for @p device.
+     */
+    static qreal horizontalAdvance(const QFont &font, const QString &text, QPaintDevice *device = nullptr);
+
+    /** Forgets all measurements, e.g. after fonts were added to the application. */
+    static void clear();
+
+    /** Returns the number of measurements kept. */
+    static int count();
+};
+}
+
+#endif
@@ -89,14 +89,11 @@ void Widget::setDataset(int column, const QVector<qreal> &data, const QString &t
     if (!checkDatasetWidth(1))
         return;
 
-    QStandardItemModel &model = d->m_model;
+    NumericDataModel &model = d->m_model;
 
     justifyModelSize(data.size(), column + 1);
 
-    for (int i = 0; i < data.size(); ++i) {
-        const QModelIndex index = model.index(i, column);
-        model.setData(index, QVariant(data[i]), Qt::DisplayRole);
-    }
+    model.setColumn(column, data);
     if (!title.isEmpty())
         model.setHeaderData(column, Qt::Horizontal, QVariant(title));
 }
@@ -106,17 +103,18 @@ void Widget::setDataset(int column, const QVector<QPair<qreal, qreal>> &data, co
     if (!checkDatasetWidth(2))
         return;
 
-    QStandardItemModel &model = d->m_model;
+    NumericDataModel &model = d->m_model;
 
     justifyModelSize(data.size(), (column + 1) * 2);
 
+    QVector<qreal> xValues(data.size());
+    QVector<qreal> yValues(data.size());
     for (int i = 0; i < data.size(); ++i) {
-        QModelIndex index = model.index(i, column * 2);
-        model.setData(index, QVariant(data[i].first), Qt::DisplayRole);
-
-        index = model.index(i, column * 2 + 1);
-        model.setData(index, QVariant(data[i].second), Qt::DisplayRole);
+        xValues[i] = data[i].first;
+        yValues[i] = data[i].second;
     }
+    model.setColumn(column * 2, xValues);
+    model.setColumn(column * 2 + 1, yValues);
     if (!title.isEmpty()) {
         model.setHeaderData(column, Qt::Horizontal, QVariant(title));
     }
@@ -127,12 +125,9 @@ void Widget::setDataCell(int row, int column, qreal data)
     if (!checkDatasetWidth(1))
         return;
 
-    QStandardItemModel &model = d->m_model;
-
     justifyModelSize(row + 1, column + 1);
 
-    const QModelIndex index = model.index(row, column);
-    model.setData(index, QVariant(data), Qt::DisplayRole);
+    d->m_model.setValue(row, column, data);
 }
 
 void Widget::setDataCell(int row, int column, QPair<qreal, qreal> data)
@@ -140,15 +135,10 @@ void Widget::setDataCell(int row, int column, QPair<qreal, qreal> data)
     if (!checkDatasetWidth(2))
         return;
 
-    QStandardItemModel &model = d->m_model;
-
     justifyModelSize(row + 1, (column + 1) * 2);
 
-    QModelIndex index = model.index(row, column * 2);
-    model.setData(index, QVariant(data.first), Qt::DisplayRole);
-
-    index = model.index(row, column * 2 + 1);
-    model.setData(index, QVariant(data.second), Qt::DisplayRole);
+    d->m_model.setValue(row, column * 2, data.first);
+    d->m_model.setValue(row, column * 2 + 1, data.second);
 }
 
 /*
@@ -60,7 +60,9 @@ public:
 
     /** Destructor. */
     ~Widget() override;
-    /** Sets the data in the given column using a QVector of qreal for the Y values. */
+    /** Sets the data in the given column using a QVector of qreal for the Y values.
+     *  The widget shares the data of the vector instead of copying it, as long as
+     *  neither the caller nor the widget modifies it. */
     void setDataset(int column, const QVector<qreal> &data, const QString &title = QString());
     /** Sets the data in the given column using a QVector of QPairs
      *  of qreal for the (X, Y) values. */
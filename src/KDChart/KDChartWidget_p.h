@@ -24,13 +24,13 @@
 
 #include <KDChartCartesianCoordinatePlane.h>
 #include <KDChartChart.h>
+#include <KDChartNumericDataModel_p.h>
 #include <KDChartPolarCoordinatePlane.h>
 #include <KDChartWidget.h>
 
 #include <KDABLibFakes>
 
 #include <QGridLayout>
-#include <QStandardItemModel>
 
 /**
  * \internal
@@ -46,7 +46,7 @@ public:
 
 protected:
     QGridLayout layout;
-    QStandardItemModel m_model;
+    NumericDataModel m_model;
     Chart m_chart;
     CartesianCoordinatePlane m_cartPlane;
     PolarCoordinatePlane m_polPlane;
@@ -23,6 +23,7 @@
 //
 
 #include "KDChartAbstractDiagram_p.h"
+#include "KDChartDiagramDataCache_p.h"
 #include <KDChartGridAttributes.h>
 
 #include <KDABLibFakes>
@@ -62,6 +63,8 @@ public:
         return attributesModel->data(attributesModel->mapFromSource(index)).toReal() / sum * 100.0;
     }
 
+    mutable DiagramDataCache dataCache;
+
 private:
     qreal granularity;
 };
@@ -16,8 +16,10 @@
 #include "KDChartPieDiagram_p.h"
 
 #include "KDChartPaintContext.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartPieAttributes.h"
+#include "KDChartPieLabelLayout_p.h"
 #include "KDChartPolarCoordinatePlane_p.h"
 #include "KDChartThreeDPieAttributes.h"
 
@@ -289,66 +291,27 @@ static int wraparound(int i, int size)
     return i;
 }
 
-// #define SHUFFLE_DEBUG
-
 void PieDiagram::shuffleLabels(QRectF *textBoundingRect)
 {
-    // things that could be improved here:
-    // - use a variable number (chosen using angle information) of neighbors to check
-    // - try harder to arrange the labels to look nice
-
-    // ideas:
-    // - leave labels that don't collide alone (only if they their offset is zero)
-    // - use a graphics view for collision detection
-
     LabelPaintCache &lpc = d->labelPaintCache;
     const int n = lpc.paintReplay.size();
-    bool modified = false;
-    qreal direction = 5.0;
-    QVector<qreal> offsets;
-    offsets.fill(0.0, n);
-
-    for (bool lastRoundModified = true; lastRoundModified;) {
-        lastRoundModified = false;
-
-        for (int i = 0; i < n; i++) {
-            const int neighborsToCheck = qMax(10, lpc.paintReplay.size() - 1);
-            const int minComp = wraparound(i - neighborsToCheck / 2, n);
-            const int maxComp = wraparound(i + (neighborsToCheck + 1) / 2, n);
-
-            QPainterPath &path = lpc.paintReplay[i].labelArea;
-
-            for (int j = minComp; j != maxComp; j = wraparound(j + 1, n)) {
-                if (i == j) {
-                    continue;
-                }
-                QPainterPath &otherPath = lpc.paintReplay[j].labelArea;
-
-                while ((offsets[i] + direction > 0) && otherPath.intersects(path)) {
-#ifdef SHUFFLE_DEBUG
-                    qDebug() << "collision involving" << j << "and" << i << " -- n =" << n;
-                    TextAttributes ta = lpc.paintReplay[i].attrs.textAttributes();
-                    ta.setPen(QPen(Qt::white));
-                    lpc.paintReplay[i].attrs.setTextAttributes(ta);
-#endif
-                    uint slice = lpc.paintReplay[i].index.column();
-                    qreal angle = DEGTORAD(d->startAngles[slice] + d->angleLens[slice] / 2.0);
-                    qreal dx = cos(angle) * direction;
-                    qreal dy = -sin(angle) * direction;
-                    offsets[i] += direction;
-                    path.translate(dx, dy);
-                    lastRoundModified = true;
-                }
-            }
-        }
-        direction *= -1.07; // this can "overshoot", but avoids getting trapped in local minimums
-        modified = modified || lastRoundModified;
+
+    QVector<QPainterPath> labelAreas(n);
+    QVector<qreal> angles(n);
+    for (int i = 0; i < n; i++) {
+        const LabelPaintInfo &pi = lpc.paintReplay.at(i);
+        const uint slice = pi.index.column();
+        labelAreas[i] = pi.labelArea;
+        angles[i] = d->startAngles[slice] + d->angleLens[slice] / 2.0;
     }
 
-    if (modified) {
-        for (int i = 0; i < lpc.paintReplay.size(); i++) {
-            *textBoundingRect |= lpc.paintReplay[i].labelArea.boundingRect();
-        }
+    if (!PieLabelLayout::resolveCollisions(&labelAreas, angles)) {
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        lpc.paintReplay[i].labelArea = labelAreas.at(i);
+        *textBoundingRect |= labelAreas.at(i).boundingRect();
     }
 }
 
@@ -618,6 +581,7 @@ void PieDiagram::drawSliceSurface(QPainter *painter, const QRectF &drawPosition,
         d->reverseMapper.addPolygon(index.row(), index.column(), poly);
 
         painter->drawPolygon(poly);
+        PaintProfiler::count(PaintProfile::PolylineCounter);
     }
 }
 
@@ -0,0 +1,165 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "KDChartPieLabelLayout_p.h"
+
+#include <QHash>
+#include <QPointF>
+#include <QRectF>
+
+#include <KDABLibFakes>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace KDChart;
+
+namespace {
+
+// Placing a label takes at most this many jumps. It is never reached in practice,
+// it only guarantees that a label is placed in bounded time.
+const int s_maxJumps = 64;
+// Distance kept between a label that had to be moved and the label it was moved past
+const qreal s_labelSpacing = 1.0;
+
+/*
+ * Spatial hash of the labels that have already been placed. The cells are at
+ * least as large as the largest label, so a label covers at most four cells.
+ */
+class LabelGrid
+{
+public:
+    LabelGrid(qreal cellWidth, qreal cellHeight)
+        : m_cellWidth(cellWidth)
+        , m_cellHeight(cellHeight)
+    {
+    }
+
+    void insert(int label, const QRectF &rect)
+    {
+        for (int column = this->column(rect.left()); column <= this->column(rect.right()); ++column) {
+            for (int row = this->row(rect.top()); row <= this->row(rect.bottom()); ++row) {
+                m_cells[key(column, row)].append(label);
+            }
+        }
+    }
+
+    template<typename Visitor>
+    void visit(const QRectF &rect, Visitor visitor) const
+    {
+        for (int column = this->column(rect.left()); column <= this->column(rect.right()); ++column) {
+            for (int row = this->row(rect.top()); row <= this->row(rect.bottom()); ++row) {
+                const auto it = m_cells.constFind(key(column, row));
+                if (it == m_cells.constEnd()) {
+                    continue;
+                }
+                for (int label : *it) {
+                    visitor(label);
+                }
+            }
+        }
+    }
+
+private:
+    int column(qreal x) const
+    {
+        return int(std::floor(x / m_cellWidth));
+    }
+    int row(qreal y) const
+    {
+        return int(std::floor(y / m_cellHeight));
+    }
+    static quint64 key(int column, int row)
+    {
+        return (quint64(quint32(column)) << 32) | quint32(row);
+    }
+
+    const qreal m_cellWidth;
+    const qreal m_cellHeight;
+    QHash<quint64, QVector<int>> m_cells;
+};
+
+// The shortest distance along dir that moves rect past obstacle, either horizontally or vertically
+qreal jumpDistance(const QRectF &rect, const QPointF &dir, const QRectF &obstacle)
+{
+    const qreal epsilon = 1e-9;
+    qreal ret = std::numeric_limits<qreal>::max();
+    if (dir.x() > epsilon) {
+        ret = qMin(ret, (obstacle.right() + s_labelSpacing - rect.left()) / dir.x());
+    } else if (dir.x() < -epsilon) {
+        ret = qMin(ret, (rect.right() - obstacle.left() + s_labelSpacing) / -dir.x());
+    }
+    if (dir.y() > epsilon) {
+        ret = qMin(ret, (obstacle.bottom() + s_labelSpacing - rect.top()) / dir.y());
+    } else if (dir.y() < -epsilon) {
+        ret = qMin(ret, (rect.bottom() - obstacle.top() + s_labelSpacing) / -dir.y());
+    }
+    return ret;
+}
+}
+
+bool PieLabelLayout::resolveCollisions(QVector<QPainterPath> *labelAreas, const QVector<qreal> &angles)
+{
+    const int n = labelAreas->size();
+    Q_ASSERT(angles.size() == n);
+    if (n < 2) {
+        return false;
+    }
+
+    QVector<QRectF> rects(n);
+    QVector<QPointF> directions(n);
+    QVector<int> order(n);
+    qreal cellWidth = 1.0;
+    qreal cellHeight = 1.0;
+    for (int i = 0; i < n; ++i) {
+        rects[i] = labelAreas->at(i).boundingRect();
+        const qreal angle = DEGTORAD(angles.at(i));
+        // y coordinates in Qt are inverted compared to the convention in maths
+        directions[i] = QPointF(cos(angle), -sin(angle));
+        order[i] = i;
+        cellWidth = qMax(cellWidth, rects.at(i).width());
+        cellHeight = qMax(cellHeight, rects.at(i).height());
+    }
+
+    // labels close to the horizontal axis first, they stay where they are
+    std::stable_sort(order.begin(), order.end(), [&directions](int a, int b) {
+        return qAbs(directions.at(a).y()) < qAbs(directions.at(b).y());
+    });
+
+    LabelGrid grid(cellWidth, cellHeight);
+    bool modified = false;
+    for (int label : qAsConst(order)) {
+        const QPointF dir = directions.at(label);
+        QRectF rect = rects.at(label);
+        qreal offset = 0.0;
+        for (int jump = 0; jump < s_maxJumps; ++jump) {
+            qreal step = std::numeric_limits<qreal>::max();
+            grid.visit(rect, [&](int other) {
+                const QRectF &obstacle = rects.at(other);
+                if (rect.intersects(obstacle)) {
+                    step = qMin(step, jumpDistance(rect, dir, obstacle));
+                }
+            });
+            if (step == std::numeric_limits<qreal>::max()) {
+                break;
+            }
+            offset += step;
+            rect = rects.at(label).translated(dir * offset);
+        }
+        if (offset > 0.0) {
+            rects[label] = rect;
+            (*labelAreas)[label].translate(dir * offset);
+            modified = true;
+        }
+        grid.insert(label, rects.at(label));
+    }
+    return modified;
+}
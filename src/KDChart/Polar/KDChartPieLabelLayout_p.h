@@ -0,0 +1,62 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDCHARTPIELABELLAYOUT_P_H
+#define KDCHARTPIELABELLAYOUT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QPainterPath>
+#include <QVector>
+
+#include "kdchart_export.h"
+
+namespace KDChart {
+
+/**
+ * \internal
+ *
+ * Resolves overlaps between the data value labels of a pie.
+ *
+ * A label is only ever moved outwards along the bisector of its slice, and
+ * only if it overlaps a label that has already been placed. Labels are placed
+ * in order of their angular distance from the horizontal axis, so the labels
+ * at the left and right of the pie stay where they are and the ones further up
+ * and down fan out.
+ *
+ * Sorting the labels is O(n log n). Collision candidates are looked up in a
+ * uniform grid of label sized cells, and a label jumps past a whole obstacle
+ * per step, so placing one label only costs a bounded number of lookups
+ * instead of a test against every other label.
+ */
+class KDCHART_EXPORT PieLabelLayout
+{
+public:
+    /**
+     * Moves the labels in \a labelAreas so that their bounding rectangles do not
+     * overlap. \a angles holds the bisector angle of each label's slice, in
+     * degrees, counter-clockwise starting at three o'clock.
+     *
+     * \return true if any label was moved
+     */
+    static bool resolveCollisions(QVector<QPainterPath> *labelAreas, const QVector<qreal> &angles);
+};
+}
+
+#endif /* KDCHARTPIELABELLAYOUT_P_H */
@@ -15,6 +15,7 @@
 #include "KDChartAbstractPolarDiagram.h"
 #include "KDChartChart.h"
 #include "KDChartPaintContext.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartPolarDiagram.h"
 
@@ -84,6 +85,7 @@ void PolarCoordinatePlane::paint(QPainter *painter)
         qreal zoomY;
         auto *polarDia = dynamic_cast<PolarDiagram *>(diags[i]);
         if (polarDia) {
+            PaintProfiler::Scope scope(PaintProfile::DiagramPhase);
             polarDia->paint(&ctx, true, zoomX, zoomY);
             d->newZoomX = qMin(d->newZoomX, zoomX);
             d->newZoomY = qMin(d->newZoomY, zoomY);
@@ -101,11 +103,15 @@ void PolarCoordinatePlane::paint(QPainter *painter)
 
     // paint the coordinate system rulers:
     d->currentTransformation = &d->coordinateTransformations.first();
-    d->grid->drawGrid(&ctx);
+    {
+        PaintProfiler::Scope scope(PaintProfile::GridPhase);
+        d->grid->drawGrid(&ctx);
+    }
 
     // paint the diagrams which will re-use their DataValueTextInfoList(s) filled in step 1:
     for (int i = 0; i < diags.size(); i++) {
         d->currentTransformation = &(d->coordinateTransformations[i]);
+        PaintProfiler::Scope scope(PaintProfile::DiagramPhase);
         PainterSaver painterSaver(painter);
         auto *polarDia = dynamic_cast<PolarDiagram *>(diags[i]);
         if (polarDia) {
@@ -12,6 +12,7 @@
 #include "KDChartPolarDiagram_p.h"
 
 #include "KDChartPaintContext.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 #include <QPainter>
 
@@ -89,9 +90,10 @@ const QPair<QPointF, QPointF> PolarDiagram::calculateDataBoundaries() const
     qreal xMin = 0.0;
     qreal xMax = colCount;
     qreal yMin = 0, yMax = 0;
+    d->dataCache.update(this);
     for (int iCol = 0; iCol < colCount; ++iCol) {
         for (int iRow = 0; iRow < rowCount; ++iRow) {
-            qreal value = model()->data(model()->index(iRow, iCol, rootIndex())).toReal(); // checked
+            const qreal value = d->dataCache.valueOrZero(iRow, iCol);
             yMax = qMax(yMax, value);
             yMin = qMin(yMin, value);
         }
@@ -137,6 +139,7 @@ void PolarDiagram::paint(PaintContext *ctx,
     if (!checkInvariants(true))
         return;
     d->reverseMapper.clear();
+    d->dataCache.update(this);
 
     const int rowCount = model()->rowCount(rootIndex());
     const int colCount = model()->columnCount(rootIndex());
@@ -148,7 +151,7 @@ void PolarDiagram::paint(PaintContext *ctx,
         for (int iCol = 0; iCol < colCount; ++iCol) {
             for (int iRow = 0; iRow < rowCount; ++iRow) {
                 QModelIndex index = model()->index(iRow, iCol, rootIndex()); // checked
-                const qreal value = model()->data(index).toReal();
+                const qreal value = d->dataCache.valueOrZero(iRow, iCol);
                 QPointF point = coordinatePlane()->translate(
                                     QPointF(value, iRow))
                     + ctx->rectangle().topLeft();
@@ -187,15 +190,15 @@ void PolarDiagram::paint(PaintContext *ctx,
             //            This needs to be enhanced to allow for cell-specific settings
             //            in the same way as LineDiagram does it.
             QBrush brush = d->datasetAttrs(iCol, KDChart::DatasetBrushRole).value<QBrush>();
-            QPolygonF polygon;
+            PolylineCompressor polyline;
             for (int iRow = 0; iRow < rowCount; ++iRow) {
-                QModelIndex index = model()->index(iRow, iCol, rootIndex()); // checked
-                const qreal value = model()->data(index).toReal();
+                const qreal value = d->dataCache.valueOrZero(iRow, iCol);
                 QPointF point = coordinatePlane()->translate(QPointF(value, iRow))
                     + ctx->rectangle().topLeft();
-                polygon.append(point);
+                polyline.append(point);
                 // qDebug() << point;
             }
+            QPolygonF polygon = polyline.polygon();
             if (closeDatasets() && !polygon.isEmpty()) {
                 // close the circle by connecting the last data point to the first
                 polygon.append(polygon.first());
@@ -208,6 +211,7 @@ void PolarDiagram::paint(PaintContext *ctx,
             if (p.style() != Qt::NoPen) {
                 ctx->painter()->setPen(PrintingParameters::scalePen(p));
                 ctx->painter()->drawPolyline(polygon);
+                PaintProfiler::count(PaintProfile::PolylineCounter);
             }
         }
         d->paintDataValueTextsAndMarkers(ctx, d->labelPaintCache, true);
@@ -12,6 +12,7 @@
 #include "KDChartRadarDiagram_p.h"
 
 #include "KDChartPaintContext.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 #include <QPainter>
 
@@ -63,9 +64,10 @@ const QPair<QPointF, QPointF> RadarDiagram::calculateDataBoundaries() const
     qreal xMin = 0.0;
     qreal xMax = colCount;
     qreal yMin = 0, yMax = 0;
+    d->dataCache.update(this);
     for (int iCol = 0; iCol < colCount; ++iCol) {
         for (int iRow = 0; iRow < rowCount; ++iRow) {
-            qreal value = model()->data(model()->index(iRow, iCol, rootIndex())).toReal(); // checked
+            const qreal value = d->dataCache.valueOrZero(iRow, iCol);
             yMax = qMax(yMax, value);
             yMin = qMin(yMin, value);
         }
@@ -158,6 +160,7 @@ void RadarDiagram::paint(PaintContext *ctx,
     if (!checkInvariants(true))
         return;
     d->reverseMapper.clear();
+    d->dataCache.update(this);
 
     const int rowCount = model()->rowCount(rootIndex());
     const int colCount = model()->columnCount(rootIndex());
@@ -193,7 +196,7 @@ void RadarDiagram::paint(PaintContext *ctx,
         for (iCol = 0; iCol < colCount; ++iCol) {
             for (iRow = 0; iRow < rowCount; ++iRow) {
                 QModelIndex index = model()->index(iRow, iCol, rootIndex()); // checked
-                const qreal value = model()->data(index).toReal();
+                const qreal value = d->dataCache.valueOrZero(iRow, iCol);
                 QPointF point = scaleToRealPosition(QPointF(value, iRow), ctx->rectangle(), destRect, *ctx->coordinatePlane());
                 d->addLabel(&d->labelPaintCache, index, nullptr, PositionPoints(point),
                             Position::Center, Position::Center, value);
@@ -228,16 +231,16 @@ void RadarDiagram::paint(PaintContext *ctx,
             //            but it draws every polyline in one go - using one color.
             //            This needs to be enhanced to allow for cell-specific settings
             //            in the same way as LineDiagram does it.
-            QPolygonF polygon;
+            PolylineCompressor polyline;
             QPointF point0;
             for (iRow = 0; iRow < rowCount; ++iRow) {
-                QModelIndex index = model()->index(iRow, iCol, rootIndex()); // checked
-                const qreal value = model()->data(index).toReal();
+                const qreal value = d->dataCache.valueOrZero(iRow, iCol);
                 QPointF point = scaleToRealPosition(QPointF(value, d->reverseData ? (rowCount - iRow) : iRow), ctx->rectangle(), destRect, *ctx->coordinatePlane());
-                polygon.append(point);
+                polyline.append(point);
                 if (!iRow)
                     point0 = point;
             }
+            QPolygonF polygon = polyline.polygon();
             if (closeDatasets() && rowCount)
                 polygon.append(point0);
 
@@ -260,6 +263,7 @@ void RadarDiagram::paint(PaintContext *ctx,
                 ctx->painter()->setBrush(br);
                 ctx->painter()->setPen(p.pen);
                 ctx->painter()->drawPolygon(p.polygon);
+                PaintProfiler::count(PaintProfile::PolylineCounter);
             }
         }
 
@@ -270,6 +274,7 @@ void RadarDiagram::paint(PaintContext *ctx,
             ctx->painter()->setBrush(p.brush);
             ctx->painter()->setPen(p.pen);
             ctx->painter()->drawPolyline(p.polygon);
+            PaintProfiler::count(PaintProfile::PolylineCounter);
         }
 
         d->paintDataValueTextsAndMarkers(ctx, d->labelPaintCache, true);
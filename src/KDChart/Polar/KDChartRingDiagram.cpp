@@ -14,6 +14,7 @@
 #include "KDChartAttributesModel.h"
 #include "KDChartDataValueAttributes.h"
 #include "KDChartPaintContext.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartPieAttributes.h"
 #include "KDChartPolarCoordinatePlane_p.h"
@@ -381,6 +382,7 @@ void RingDiagram::drawPieSurface(QPainter *painter, uint dataset, uint slice, qr
             // fix value position
             const qreal sum = valueTotals(dataset);
             painter->drawPolygon(poly);
+            PaintProfiler::count(PaintProfile::PolylineCounter);
 
             d->reverseMapper.addPolygon(index.row(), index.column(), poly);
 
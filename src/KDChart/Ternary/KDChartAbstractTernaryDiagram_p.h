@@ -24,6 +24,7 @@
 
 #include "KDChartAbstractTernaryDiagram.h"
 
+#include "KDChartDiagramDataCache_p.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartTernaryCoordinatePlane.h"
 #include <KDChartAbstractDiagram_p.h>
@@ -64,6 +65,8 @@ public:
     AbstractTernaryDiagram *referenceDiagram;
     QPointF referenceDiagramOffset;
 
+    DiagramDataCache dataCache;
+
     void drawPoint(QPainter *p, int row, int column,
                    const QPointF &widgetLocation)
     {
@@ -16,6 +16,7 @@
 
 #include "KDChartAbstractTernaryDiagram.h"
 #include "KDChartPaintContext.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 #include "KDChartTernaryAxis.h"
 
@@ -155,10 +156,14 @@ void TernaryCoordinatePlane::paint(QPainter *painter)
 
         // paint the coordinate system rulers:
         Q_ASSERT(d->grid != nullptr);
-        d->grid->drawGrid(&ctx);
+        {
+            PaintProfiler::Scope scope(PaintProfile::GridPhase);
+            d->grid->drawGrid(&ctx);
+        }
 
         // paint the diagrams:
         for (int i = 0; i < diags.size(); i++) {
+            PaintProfiler::Scope scope(PaintProfile::DiagramPhase);
             PainterSaver diagramPainterSaver(painter);
             diags[i]->paint(&ctx);
         }
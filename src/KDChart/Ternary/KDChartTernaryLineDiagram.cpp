@@ -20,6 +20,7 @@
 #include "KDChartDataValueAttributes.h"
 #include "KDChartLineAttributes.h"
 #include "KDChartMarkerAttributes.h"
+#include "KDChartPaintProfiler_p.h"
 #include "KDChartPainterSaver_p.h"
 #include "TernaryConstants.h"
 #include "TernaryPoint.h"
@@ -86,6 +87,7 @@ void TernaryLineDiagram::paint(PaintContext *paintContext)
     const DataValueAttributes attrs(dataValueAttributes());
 
     d->forgetAlreadyPaintedDataValues();
+    d->dataCache.update(this);
 
     int columnCount = model()->columnCount(rootIndex());
     QPointF start;
@@ -94,17 +96,14 @@ void TernaryLineDiagram::paint(PaintContext *paintContext)
         for (int row = 0; row < numrows; row++) {
             // see if there is data otherwise skip
             QModelIndex base = model()->index(row, column); // checked
-            if (!model()->data(base).isNull()) {
+            if (!ISNAN(d->dataCache.value(row, column))) {
                 p->setPen(PrintingParameters::scalePen(pen(base)));
                 p->setBrush(brush(base));
 
                 // retrieve data
-                x = qMax(model()->data(model()->index(row, column, rootIndex())).toReal(), // checked
-                         ( qreal )0.0);
-                y = qMax(model()->data(model()->index(row, column + 1, rootIndex())).toReal(), // checked
-                         ( qreal )0.0);
-                z = qMax(model()->data(model()->index(row, column + 2, rootIndex())).toReal(), // checked
-                         ( qreal )0.0);
+                x = qMax(d->dataCache.valueOrZero(row, column), ( qreal )0.0);
+                y = qMax(d->dataCache.valueOrZero(row, column + 1), ( qreal )0.0);
+                z = qMax(d->dataCache.valueOrZero(row, column + 2), ( qreal )0.0);
 
                 qreal total = x + y + z;
                 if (fabs(total) > 3 * std::numeric_limits<qreal>::epsilon()) {
@@ -114,6 +113,7 @@ void TernaryLineDiagram::paint(PaintContext *paintContext)
 
                     if (row > 0) {
                         p->drawLine(start, widgetLocation);
+                        PaintProfiler::count(PaintProfile::PolylineCounter);
                     }
                     paintMarker(p, model()->index(row, column, rootIndex()), widgetLocation); // checked
                     start = widgetLocation;
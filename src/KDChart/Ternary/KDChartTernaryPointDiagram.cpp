@@ -74,6 +74,7 @@ void TernaryPointDiagram::paint(PaintContext *paintContext)
     const DataValueAttributes attrs(dataValueAttributes());
 
     d->forgetAlreadyPaintedDataValues();
+    d->dataCache.update(this);
 
     int columnCount = model()->columnCount(rootIndex());
     for (int column = 0; column < columnCount; column += datasetDimension()) {
@@ -81,17 +82,14 @@ void TernaryPointDiagram::paint(PaintContext *paintContext)
         for (int row = 0; row < numrows; row++) {
             QModelIndex base = model()->index(row, column, rootIndex()); // checked
             // see if there is data otherwise skip
-            if (!model()->data(base).isNull()) {
+            if (!ISNAN(d->dataCache.value(row, column))) {
                 p->setPen(PrintingParameters::scalePen(pen(base)));
                 p->setBrush(brush(base));
 
                 // retrieve data
-                x = qMax(model()->data(model()->index(row, column + 0, rootIndex())).toReal(), // checked
-                         ( qreal )0.0);
-                y = qMax(model()->data(model()->index(row, column + 1, rootIndex())).toReal(), // checked
-                         ( qreal )0.0);
-                z = qMax(model()->data(model()->index(row, column + 2, rootIndex())).toReal(), // checked
-                         ( qreal )0.0);
+                x = qMax(d->dataCache.valueOrZero(row, column), ( qreal )0.0);
+                y = qMax(d->dataCache.valueOrZero(row, column + 1), ( qreal )0.0);
+                z = qMax(d->dataCache.valueOrZero(row, column + 2), ( qreal )0.0);
 
                 // fix messed up data values (paint as much as possible)
                 qreal total = x + y + z;
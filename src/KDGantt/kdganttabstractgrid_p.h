@@ -16,6 +16,7 @@
 #include <QPointer>
 
 #include "kdganttabstractgrid.h"
+#include "kdganttconstraintchecker_p.h"
 
 namespace KDGantt {
 class AbstractGrid::Private
@@ -23,6 +24,8 @@ class AbstractGrid::Private
 public:
     QPointer<QAbstractItemModel> model;
     QPersistentModelIndex root;
+    /* set by the scene the grid is used in */
+    QPointer<ConstraintChecker> constraintChecker;
 };
 
 inline AbstractGrid::AbstractGrid(Private *d)
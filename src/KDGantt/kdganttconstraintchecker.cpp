@@ -0,0 +1,529 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#include "kdganttconstraintchecker_p.h"
+#include "kdganttconstraint.h"
+#include "kdganttconstraintmodel.h"
+#include "kdganttglobal.h"
+
+#include <QAbstractProxyModel>
+
+#include <algorithm>
+
+using namespace KDGantt;
+
+/*!\class KDGantt::ConstraintChecker
+ * \internal
+ */
+
+ConstraintChecker::ConstraintChecker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ConstraintChecker::~ConstraintChecker()
+{
+}
+
+/*! Sets the model the items' start and end times are read from.
+ * Constraints are mapped from the constraint model into this model
+ * with QAbstractProxyModel::mapFromSource().
+ */
+void ConstraintChecker::setModel(QAbstractProxyModel *model)
+{
+    if (m_model == model)
+        return;
+    if (m_model)
+        m_model->disconnect(this);
+    m_model = model;
+    if (m_model) {
+        connect(m_model, &QAbstractItemModel::dataChanged,
+                this, &ConstraintChecker::slotDataChanged);
+        connect(m_model, &QAbstractItemModel::rowsInserted,
+                this, &ConstraintChecker::invalidate);
+        connect(m_model, &QAbstractItemModel::rowsRemoved,
+                this, &ConstraintChecker::invalidate);
+        connect(m_model, &QAbstractItemModel::rowsMoved,
+                this, &ConstraintChecker::invalidate);
+        connect(m_model, &QAbstractItemModel::layoutChanged,
+                this, &ConstraintChecker::invalidate);
+        connect(m_model, &QAbstractItemModel::modelReset,
+                this, &ConstraintChecker::invalidate);
+    }
+    invalidate();
+}
+
+/*! \returns the model the items' times are read from */
+QAbstractProxyModel *ConstraintChecker::model() const
+{
+    return m_model;
+}
+
+void ConstraintChecker::setConstraintModel(ConstraintModel *cmodel)
+{
+    if (m_constraintModel == cmodel)
+        return;
+    if (m_constraintModel)
+        m_constraintModel->disconnect(this);
+    m_constraintModel = cmodel;
+    if (m_constraintModel) {
+        connect(m_constraintModel, &ConstraintModel::constraintAdded,
+                this, &ConstraintChecker::invalidate);
+        connect(m_constraintModel, &ConstraintModel::constraintsAdded,
+                this, &ConstraintChecker::invalidate);
+        connect(m_constraintModel, &ConstraintModel::constraintRemoved,
+                this, &ConstraintChecker::invalidate);
+    }
+    invalidate();
+}
+
+/*! Discards the dependency graph, it is rebuilt on the next query. */
+void ConstraintChecker::invalidate()
+{
+    m_dirty = true;
+}
+
+/*! \returns true if the item at \a idx can be moved to the interval
+ * [\a start, \a end] without violating a hard constraint that is
+ * satisfied by its current position. Items without hard constraints
+ * can be moved anywhere.
+ */
+bool ConstraintChecker::isAllowed(const QModelIndex &idx, const QDateTime &start, const QDateTime &end) const
+{
+    ensureBuilt();
+    const int id = m_ids.value(idx, -1);
+    if (id < 0)
+        return true;
+    const Node &node = m_nodes.at(id);
+    if (start.isValid() && start.toMSecsSinceEpoch() < node.earliestStart)
+        return false;
+    if (end.isValid() && end.toMSecsSinceEpoch() > node.latestEnd)
+        return false;
+    return true;
+}
+
+/*! \returns the earliest start time the item at \a idx can be moved to,
+ * or an invalid QDateTime if it is not bounded by any hard constraint.
+ */
+QDateTime ConstraintChecker::earliestStart(const QModelIndex &idx) const
+{
+    ensureBuilt();
+    const int id = m_ids.value(idx, -1);
+    if (id < 0 || m_nodes.at(id).earliestStart == std::numeric_limits<qint64>::min())
+        return QDateTime();
+    return QDateTime::fromMSecsSinceEpoch(m_nodes.at(id).earliestStart);
+}
+
+/*! \returns the latest end time the item at \a idx can be moved to,
+ * or an invalid QDateTime if it is not bounded by any hard constraint.
+ */
+QDateTime ConstraintChecker::latestEnd(const QModelIndex &idx) const
+{
+    ensureBuilt();
+    const int id = m_ids.value(idx, -1);
+    if (id < 0 || m_nodes.at(id).latestEnd == std::numeric_limits<qint64>::max())
+        return QDateTime();
+    return QDateTime::fromMSecsSinceEpoch(m_nodes.at(id).latestEnd);
+}
+
+/*! \returns true if the hard constraints contain a cycle. The items
+ * on such a cycle can never satisfy all of their constraints.
+ */
+bool ConstraintChecker::hasCycles() const
+{
+    ensureBuilt();
+    return m_hasCycles;
+}
+
+/*! \returns true if the hard constraints in \a constraints, given in
+ * the coordinates of model(), are all the hard constraints of the item
+ * at \a idx. Only then do the bounds of the item match the constraints.
+ */
+bool ConstraintChecker::hasAllConstraints(const QModelIndex &idx, const QList<Constraint> &constraints) const
+{
+    ensureBuilt();
+    const int id = m_ids.value(idx, -1);
+    int count = 0;
+    for (const Constraint &c : constraints) {
+        if (c.type() != Constraint::TypeHard)
+            continue;
+        if (id < 0)
+            return false;
+        const Node &node = m_nodes.at(id);
+        if (c.startIndex() == idx) {
+            if (!node.successors.contains(m_ids.value(c.endIndex(), -1)))
+                return false;
+        } else if (c.endIndex() == idx) {
+            if (!node.predecessors.contains(m_ids.value(c.startIndex(), -1)))
+                return false;
+        } else {
+            return false;
+        }
+        ++count;
+    }
+    if (id < 0)
+        return true;
+    return count == m_nodes.at(id).predecessors.count() + m_nodes.at(id).successors.count();
+}
+
+/*! Re-reads the times of the item at \a idx and carries them to the
+ * items that depend on it, directly or transitively. Only the items
+ * whose bounds actually change are visited.
+ */
+void ConstraintChecker::updateItem(const QModelIndex &idx)
+{
+    if (m_dirty)
+        return; // will be rebuilt from scratch anyway
+    const int id = m_ids.value(idx, -1);
+    if (id < 0)
+        return;
+    if (m_hasCycles) {
+        // propagating along a cycle would never settle
+        invalidate();
+        return;
+    }
+    readTimes(m_nodes[id], idx);
+    QVector<int> changed;
+    changed.push_back(id);
+    propagate(id, changed);
+    for (int c : qAsConst(changed)) {
+        updateBounds(c);
+        for (int p : qAsConst(m_nodes.at(c).predecessors))
+            updateBounds(p);
+        for (int s : qAsConst(m_nodes.at(c).successors))
+            updateBounds(s);
+    }
+}
+
+void ConstraintChecker::slotDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (m_dirty || m_nodes.isEmpty() || !topLeft.isValid() || !bottomRight.isValid())
+        return;
+    const QModelIndex parent = topLeft.parent();
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        for (int col = topLeft.column(); col <= bottomRight.column(); ++col) {
+            updateItem(m_model->index(row, col, parent));
+        }
+    }
+}
+
+void ConstraintChecker::ensureBuilt() const
+{
+    if (m_dirty)
+        rebuild();
+}
+
+int ConstraintChecker::nodeId(const QModelIndex &idx) const
+{
+    QHash<QPersistentModelIndex, int>::const_iterator it = m_ids.constFind(idx);
+    if (it != m_ids.constEnd())
+        return *it;
+    const int id = m_nodes.count();
+    m_nodes.push_back(Node());
+    readTimes(m_nodes.last(), idx);
+    m_ids.insert(idx, id);
+    return id;
+}
+
+void ConstraintChecker::readTimes(Node &node, const QModelIndex &idx) const
+{
+    const QDateTime st = m_model->data(idx, StartTimeRole).toDateTime();
+    const QDateTime et = m_model->data(idx, EndTimeRole).toDateTime();
+    node.valid = st.isValid() && et.isValid();
+    node.start = node.valid ? st.toMSecsSinceEpoch() : 0;
+    node.end = node.valid ? et.toMSecsSinceEpoch() : 0;
+}
+
+qint64 ConstraintChecker::computeReachEnd(int id) const
+{
+    const Node &node = m_nodes.at(id);
+    qint64 reach = node.valid ? node.end : std::numeric_limits<qint64>::min();
+    for (int p : qAsConst(node.predecessors))
+        reach = qMax(reach, m_nodes.at(p).reachEnd);
+    return reach;
+}
+
+qint64 ConstraintChecker::computeReachStart(int id) const
+{
+    const Node &node = m_nodes.at(id);
+    qint64 reach = node.valid ? node.start : std::numeric_limits<qint64>::max();
+    for (int s : qAsConst(node.successors))
+        reach = qMin(reach, m_nodes.at(s).reachStart);
+    return reach;
+}
+
+/* Carries the times of item \a id forward to its transitive successors
+ * and backward to its transitive predecessors, appending every node
+ * whose reach changed to \a changed. Requires an acyclic graph.
+ */
+void ConstraintChecker::propagate(int id, QVector<int> &changed) const
+{
+    QVector<int> work;
+    m_nodes[id].reachEnd = computeReachEnd(id);
+    work.push_back(id);
+    while (!work.isEmpty()) {
+        const int n = work.takeLast();
+        for (int s : qAsConst(m_nodes.at(n).successors)) {
+            const qint64 reach = computeReachEnd(s);
+            if (reach != m_nodes.at(s).reachEnd) {
+                m_nodes[s].reachEnd = reach;
+                work.push_back(s);
+                changed.push_back(s);
+            }
+        }
+    }
+
+    m_nodes[id].reachStart = computeReachStart(id);
+    work.push_back(id);
+    while (!work.isEmpty()) {
+        const int n = work.takeLast();
+        for (int p : qAsConst(m_nodes.at(n).predecessors)) {
+            const qint64 reach = computeReachStart(p);
+            if (reach != m_nodes.at(p).reachStart) {
+                m_nodes[p].reachStart = reach;
+                work.push_back(p);
+                changed.push_back(p);
+            }
+        }
+    }
+}
+
+/* A predecessor, and everything it depends on, bounds the start of an
+ * item; a successor, and everything depending on it, bounds its end.
+ * Constraints that are already violated are not enforced, the user must
+ * be able to move items out of an invalid state. Whether a constraint
+ * is satisfied is decided per edge, the transitive bound is only added
+ * on top of a satisfied edge and only as far as the current position
+ * satisfies it too.
+ */
+void ConstraintChecker::updateBounds(int id) const
+{
+    Node &node = m_nodes[id];
+    node.earliestStart = std::numeric_limits<qint64>::min();
+    node.latestEnd = std::numeric_limits<qint64>::max();
+    if (!node.valid)
+        return;
+    for (int p : qAsConst(node.predecessors)) {
+        const Node &pred = m_nodes.at(p);
+        if (!pred.valid || pred.end > node.start)
+            continue;
+        qint64 bound = pred.end;
+        if (pred.reachEnd <= node.start)
+            bound = qMax(bound, pred.reachEnd);
+        node.earliestStart = qMax(node.earliestStart, bound);
+    }
+    for (int s : qAsConst(node.successors)) {
+        const Node &succ = m_nodes.at(s);
+        if (!succ.valid || node.end > succ.start)
+            continue;
+        qint64 bound = succ.start;
+        if (node.end <= succ.reachStart)
+            bound = qMin(bound, succ.reachStart);
+        node.latestEnd = qMin(node.latestEnd, bound);
+    }
+}
+
+/* Builds the graph of hard constraints, carries the reach forward and
+ * backward in topological order and computes all bounds from it,
+ * O(items + constraints). Items on a cycle are visited last, their
+ * bounds only take the part of the graph outside the cycle into account.
+ */
+void ConstraintChecker::rebuild() const
+{
+    m_dirty = false;
+    m_hasCycles = false;
+    m_ids.clear();
+    m_nodes.clear();
+    if (!m_model || !m_constraintModel)
+        return;
+
+    const QList<Constraint> clst = m_constraintModel->constraints();
+    for (const Constraint &c : clst) {
+        if (c.type() != Constraint::TypeHard)
+            continue;
+        const QModelIndex start = m_model->mapFromSource(c.startIndex());
+        const QModelIndex end = m_model->mapFromSource(c.endIndex());
+        if (!start.isValid() || !end.isValid() || start == end)
+            continue;
+        const int s = nodeId(start);
+        const int e = nodeId(end);
+        m_nodes[s].successors.push_back(e);
+        m_nodes[e].predecessors.push_back(s);
+    }
+
+    // Kahn's algorithm
+    const int count = m_nodes.count();
+    QVector<int> inDegree(count);
+    QVector<int> order;
+    order.reserve(count);
+    for (int id = 0; id < count; ++id) {
+        inDegree[id] = m_nodes.at(id).predecessors.count();
+        if (inDegree.at(id) == 0)
+            order.push_back(id);
+    }
+    for (int i = 0; i < order.count(); ++i) {
+        for (int s : qAsConst(m_nodes.at(order.at(i)).successors)) {
+            if (--inDegree[s] == 0)
+                order.push_back(s);
+        }
+    }
+    if (order.count() < count) {
+        m_hasCycles = true;
+        for (int id = 0; id < count; ++id) {
+            if (inDegree.at(id) > 0)
+                order.push_back(id);
+        }
+    }
+
+    for (int id : qAsConst(order))
+        m_nodes[id].reachEnd = computeReachEnd(id);
+    for (int i = order.count() - 1; i >= 0; --i)
+        m_nodes[order.at(i)].reachStart = computeReachStart(order.at(i));
+    for (int id : qAsConst(order))
+        updateBounds(id);
+}
+
+#ifndef KDAB_NO_UNIT_TESTS
+
+#include <QStandardItemModel>
+
+#include "kdganttsummaryhandlingproxymodel.h"
+#include "unittest/test.h"
+
+static std::ostream &operator<<(std::ostream &os, const QDateTime &dt)
+{
+#ifdef QT_NO_STL
+    os << dt.toString().toLatin1().constData();
+#else
+    os << dt.toString().toStdString();
+#endif
+    return os;
+}
+
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, ConstraintChecker, "test")
+{
+    QStandardItemModel model(3, 1);
+    const QDateTime base(QDate(2024, 1, 1), QTime(0, 0));
+    for (int row = 0; row < 3; ++row) {
+        auto *item = new QStandardItem;
+        item->setData(KDGantt::TypeTask, KDGantt::ItemTypeRole);
+        item->setData(base.addDays(3 * row), KDGantt::StartTimeRole);
+        item->setData(base.addDays(3 * row + 2), KDGantt::EndTimeRole);
+        model.setItem(row, 0, item);
+    }
+    SummaryHandlingProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    ConstraintModel cmodel;
+    cmodel.addConstraint(Constraint(model.index(0, 0), model.index(1, 0), Constraint::TypeHard));
+    cmodel.addConstraint(Constraint(model.index(1, 0), model.index(2, 0), Constraint::TypeSoft));
+
+    ConstraintChecker checker;
+    checker.setModel(&proxy);
+    checker.setConstraintModel(&cmodel);
+
+    const QModelIndex first = proxy.index(0, 0);
+    const QModelIndex second = proxy.index(1, 0);
+    const QModelIndex third = proxy.index(2, 0);
+
+    assertFalse(checker.hasCycles());
+    assertEqual(checker.earliestStart(second), base.addDays(2));
+    assertEqual(checker.latestEnd(first), base.addDays(3));
+    assertFalse(checker.latestEnd(second).isValid()); // soft constraint only
+
+    assertTrue(checker.isAllowed(second, base.addDays(2), base.addDays(4)));
+    assertFalse(checker.isAllowed(second, base.addDays(1), base.addDays(3)));
+    assertFalse(checker.isAllowed(first, base.addDays(2), base.addDays(4)));
+    assertTrue(checker.isAllowed(third, base, base.addDays(1)));
+
+    // Moving the predecessor updates the bound incrementally
+    model.setData(model.index(0, 0), base.addDays(-2), KDGantt::StartTimeRole);
+    model.setData(model.index(0, 0), base.addDays(1), KDGantt::EndTimeRole);
+    assertEqual(checker.earliestStart(second), base.addDays(1));
+    assertTrue(checker.isAllowed(second, base.addDays(1), base.addDays(3)));
+
+    QList<Constraint> clst;
+    clst << Constraint(first, second, Constraint::TypeHard);
+    assertTrue(checker.hasAllConstraints(second, clst));
+    clst << Constraint(second, third, Constraint::TypeSoft);
+    assertTrue(checker.hasAllConstraints(second, clst));
+    assertFalse(checker.hasAllConstraints(second, QList<Constraint>() << Constraint(second, third, Constraint::TypeHard)));
+    assertTrue(checker.hasAllConstraints(third, QList<Constraint>()));
+
+    cmodel.addConstraint(Constraint(model.index(1, 0), model.index(0, 0), Constraint::TypeHard));
+    assertTrue(checker.hasCycles());
+}
+
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, ConstraintCheckerChain, "test")
+{
+    // A -> B -> C, each task two days long with a day in between
+    QStandardItemModel model(3, 1);
+    const QDateTime base(QDate(2024, 1, 1), QTime(0, 0));
+    for (int row = 0; row < 3; ++row) {
+        auto *item = new QStandardItem;
+        item->setData(KDGantt::TypeTask, KDGantt::ItemTypeRole);
+        item->setData(base.addDays(3 * row), KDGantt::StartTimeRole);
+        item->setData(base.addDays(3 * row + 2), KDGantt::EndTimeRole);
+        model.setItem(row, 0, item);
+    }
+    SummaryHandlingProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    ConstraintModel cmodel;
+    cmodel.addConstraint(Constraint(model.index(0, 0), model.index(1, 0), Constraint::TypeHard));
+    cmodel.addConstraint(Constraint(model.index(1, 0), model.index(2, 0), Constraint::TypeHard));
+
+    ConstraintChecker checker;
+    checker.setModel(&proxy);
+    checker.setConstraintModel(&cmodel);
+
+    const QModelIndex a = proxy.index(0, 0);
+    const QModelIndex b = proxy.index(1, 0);
+    const QModelIndex c = proxy.index(2, 0);
+
+    assertFalse(checker.hasCycles());
+    assertFalse(checker.earliestStart(a).isValid());
+    assertEqual(checker.latestEnd(a), base.addDays(3));
+    assertEqual(checker.earliestStart(b), base.addDays(2));
+    assertEqual(checker.latestEnd(b), base.addDays(6));
+    assertEqual(checker.earliestStart(c), base.addDays(5));
+    assertFalse(checker.latestEnd(c).isValid());
+
+    // A now ends after B starts: A -> B is violated and not enforced,
+    // B -> C still is, C starts before A ends so only B bounds it
+    model.setData(model.index(0, 0), base.addDays(7), KDGantt::EndTimeRole);
+    assertFalse(checker.earliestStart(b).isValid());
+    assertFalse(checker.latestEnd(a).isValid());
+    assertEqual(checker.earliestStart(c), base.addDays(5));
+    assertEqual(checker.latestEnd(b), base.addDays(6));
+    assertTrue(checker.isAllowed(c, base.addDays(5), base.addDays(7)));
+    assertFalse(checker.isAllowed(c, base.addDays(4), base.addDays(6)));
+
+    // Once C starts after A ends, C must not start before A ends
+    model.setData(model.index(2, 0), base.addDays(10), KDGantt::EndTimeRole);
+    model.setData(model.index(2, 0), base.addDays(8), KDGantt::StartTimeRole);
+    assertEqual(checker.earliestStart(c), base.addDays(7));
+    assertFalse(checker.isAllowed(c, base.addDays(6), base.addDays(8)));
+    assertTrue(checker.isAllowed(c, base.addDays(7), base.addDays(9)));
+    assertEqual(checker.latestEnd(b), base.addDays(8));
+
+    // The incremental update agrees with a rebuild from scratch
+    checker.invalidate();
+    assertEqual(checker.earliestStart(c), base.addDays(7));
+    assertFalse(checker.earliestStart(b).isValid());
+    assertEqual(checker.latestEnd(b), base.addDays(8));
+
+    // Moving A back carries the bound through B again
+    model.setData(model.index(0, 0), base.addDays(2), KDGantt::EndTimeRole);
+    assertEqual(checker.earliestStart(b), base.addDays(2));
+    assertEqual(checker.earliestStart(c), base.addDays(5));
+}
+
+#endif /* KDAB_NO_UNIT_TESTS */
@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** This file is part of the KD Chart library.
+**
+** SPDX-FileCopyrightText: 2001 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#ifndef KDGANTTCONSTRAINTCHECKER_P_H
+#define KDGANTTCONSTRAINTCHECKER_P_H
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPersistentModelIndex>
+#include <QPointer>
+#include <QVector>
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+class QAbstractProxyModel;
+QT_END_NAMESPACE
+
+namespace KDGantt {
+class Constraint;
+class ConstraintModel;
+
+/* Keeps, for every item taking part in a hard constraint, the earliest
+ * start and the latest end it can be moved to without violating one of
+ * its hard constraints that is currently satisfied.
+ * Hard constraints are transitive: if A must end before B starts and B
+ * before C, then C may not start before A ends either. The bounds are
+ * carried along the dependency graph in topological order once, and
+ * then kept up to date incrementally when items change, so checking a
+ * proposed position while dragging is a single hash lookup.
+ */
+class ConstraintChecker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ConstraintChecker(QObject *parent = nullptr);
+    ~ConstraintChecker() override;
+
+    void setModel(QAbstractProxyModel *model);
+    QAbstractProxyModel *model() const;
+    void setConstraintModel(ConstraintModel *cmodel);
+
+    bool isAllowed(const QModelIndex &idx, const QDateTime &start, const QDateTime &end) const;
+    QDateTime earliestStart(const QModelIndex &idx) const;
+    QDateTime latestEnd(const QModelIndex &idx) const;
+    bool hasCycles() const;
+    bool hasAllConstraints(const QModelIndex &idx, const QList<Constraint> &constraints) const;
+
+public Q_SLOTS:
+    void invalidate();
+    void updateItem(const QModelIndex &idx);
+
+private Q_SLOTS:
+    void slotDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+
+private:
+    struct Node
+    {
+        qint64 start = 0;
+        qint64 end = 0;
+        bool valid = false;
+        qint64 earliestStart = std::numeric_limits<qint64>::min();
+        qint64 latestEnd = std::numeric_limits<qint64>::max();
+        /* latest end of the item and all of its transitive predecessors */
+        qint64 reachEnd = std::numeric_limits<qint64>::min();
+        /* earliest start of the item and all of its transitive successors */
+        qint64 reachStart = std::numeric_limits<qint64>::max();
+        QVector<int> predecessors;
+        QVector<int> successors;
+    };
+
+    void ensureBuilt() const;
+    void rebuild() const;
+    int nodeId(const QModelIndex &idx) const;
+    void readTimes(Node &node, const QModelIndex &idx) const;
+    qint64 computeReachEnd(int id) const;
+    qint64 computeReachStart(int id) const;
+    void propagate(int id, QVector<int> &changed) const;
+    void updateBounds(int id) const;
+
+    QPointer<QAbstractProxyModel> m_model;
+    QPointer<ConstraintModel> m_constraintModel;
+
+    mutable QHash<QPersistentModelIndex, int> m_ids;
+    mutable QVector<Node> m_nodes;
+    mutable bool m_dirty = true;
+    mutable bool m_hasCycles = false;
+};
+}
+
+#endif /* KDGANTTCONSTRAINTCHECKER_P_H */
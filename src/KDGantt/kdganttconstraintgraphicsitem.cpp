@@ -16,6 +16,7 @@
 
 #include <QDebug>
 #include <QPainter>
+#include <QStyleOptionGraphicsItem>
 
 using namespace KDGantt;
 
@@ -65,6 +66,12 @@ void ConstraintGraphicsItem::paint(QPainter *painter, const QStyleOptionGraphics
 {
     Q_UNUSED(widget);
     // qDebug() << "ConstraintGraphicsItem::paint(...), c=" << m_constraint;
+    if (scene()->levelOfDetailThreshold() > 0.) {
+        // No arrows from or to items that are only painted as part of a merged span
+        const qreal lod = option->levelOfDetailFromTransform(painter->worldTransform());
+        if ((m_startItem && scene()->isAggregated(m_startItem, lod)) || (m_endItem && scene()->isAggregated(m_endItem, lod)))
+            return;
+    }
     scene()->itemDelegate()->paintConstraintItem(painter, *option, m_start, m_end, m_constraint);
 }
 
@@ -16,6 +16,7 @@
 #include "kdganttconstraint.h"
 
 namespace KDGantt {
+class GraphicsItem;
 class GraphicsScene;
 
 class KDGANTT_EXPORT ConstraintGraphicsItem : public QGraphicsItem
@@ -59,9 +60,13 @@ public:
     void updateItem(const QPointF &start, const QPointF &end);
 
 private:
+    friend class GraphicsItem;
+
     Constraint m_constraint;
     QPointF m_start;
     QPointF m_end;
+    GraphicsItem *m_startItem = nullptr;
+    GraphicsItem *m_endItem = nullptr;
 };
 }
 
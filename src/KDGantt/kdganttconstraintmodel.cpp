@@ -31,30 +31,163 @@ ConstraintModel::Private::Private()
 {
 }
 
-void ConstraintModel::Private::addConstraintToIndex(const QModelIndex &idx, const Constraint &c)
+void ConstraintModel::Private::insertConstraint(const Constraint &c)
 {
-    IndexType::iterator it = indexMap.find(idx);
-    while (it != indexMap.end() && it.key() == idx) {
-        // Check if we already have this
-        if (*it == c)
+    watchModel(c.startIndex().model());
+    watchModel(c.endIndex().model());
+    const int position = constraints.count();
+    constraints.push_back(c);
+    if (!adjacencyDirty) {
+        outEdges[c.startIndex()].push_back(position);
+        inEdges[c.endIndex()].push_back(position);
+    }
+}
+
+/* Marks the adjacency lists as outdated whenever the indexes of \a model
+ * may move. This is done before and after each change, as other slots
+ * may look up constraints before ours is called.
+ */
+void ConstraintModel::Private::watchModel(const QAbstractItemModel *model)
+{
+    if (!model)
+        return;
+    for (const QPointer<QAbstractItemModel> &watched : qAsConst(watchedModels)) {
+        if (watched == model)
             return;
-        ++it;
     }
+    auto *m = const_cast<QAbstractItemModel *>(model);
+    watchedModels.push_back(m);
+    auto invalidate = [this]() {
+        adjacencyDirty = true;
+    };
+    QObject::connect(m, &QAbstractItemModel::rowsAboutToBeInserted, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::rowsInserted, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::rowsAboutToBeRemoved, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::rowsRemoved, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::rowsAboutToBeMoved, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::rowsMoved, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::columnsAboutToBeInserted, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::columnsInserted, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::columnsAboutToBeRemoved, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::columnsRemoved, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::columnsAboutToBeMoved, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::columnsMoved, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::layoutAboutToBeChanged, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::layoutChanged, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::modelAboutToBeReset, q, invalidate);
+    QObject::connect(m, &QAbstractItemModel::modelReset, q, invalidate);
+}
+
+/* Rebuilds the adjacency lists if the indexes have moved since they
+ * were built, O(constraints). */
+void ConstraintModel::Private::ensureAdjacency() const
+{
+    if (!adjacencyDirty)
+        return;
+    adjacencyDirty = false;
+    outEdges.clear();
+    inEdges.clear();
+    for (int position = 0; position < constraints.count(); ++position) {
+        const Constraint &c = constraints.at(position);
+        outEdges[c.startIndex()].push_back(position);
+        inEdges[c.endIndex()].push_back(position);
+    }
+}
 
-    indexMap.insert(idx, c);
+namespace {
+bool replaceInList(QList<int> &lst, int from, int to)
+{
+    const int i = lst.indexOf(from);
+    if (i < 0)
+        return false;
+    if (to < 0)
+        lst.removeAt(i);
+    else
+        lst[i] = to;
+    return true;
 }
 
-void ConstraintModel::Private::removeConstraintFromIndex(const QModelIndex &idx, const Constraint &c)
+/* Replaces the position \a from by \a to in the adjacency list of \a idx,
+ * or removes it if \a to is negative. */
+void replaceInAdjacency(ConstraintModel::Private::AdjacencyType &adjacency,
+                        const QModelIndex &idx, int from, int to)
 {
-    IndexType::iterator it = indexMap.find(idx);
-    while (it != indexMap.end() && it.key() == idx) {
-        if (c.compareIndexes(*it)) {
-            it = indexMap.erase(it);
-        } else {
-            ++it;
+    if (idx.isValid()) {
+        ConstraintModel::Private::AdjacencyType::iterator it = adjacency.find(idx);
+        if (it != adjacency.end() && replaceInList(*it, from, to)) {
+            if (it->isEmpty())
+                adjacency.erase(it);
+            return;
+        }
+    }
+    // Because of a Qt bug, indexes that became invalid can not be
+    // looked up by key, so we have to search all adjacency lists
+    for (ConstraintModel::Private::AdjacencyType::iterator it = adjacency.begin(); it != adjacency.end(); ++it) {
+        if (replaceInList(*it, from, to)) {
+            if (it->isEmpty())
+                adjacency.erase(it);
+            return;
         }
     }
 }
+}
+
+/*! Removes the constraint at \a position. The last constraint takes its
+ * place, so that only the adjacency lists of the two constraints change.
+ */
+void ConstraintModel::Private::eraseConstraint(int position)
+{
+    ensureAdjacency();
+    const Constraint c = constraints.at(position);
+    replaceInAdjacency(outEdges, c.startIndex(), position, -1);
+    replaceInAdjacency(inEdges, c.endIndex(), position, -1);
+
+    const int last = constraints.count() - 1;
+    if (position != last) {
+        const Constraint moved = constraints.at(last);
+        replaceInAdjacency(outEdges, moved.startIndex(), last, position);
+        replaceInAdjacency(inEdges, moved.endIndex(), last, position);
+        constraints[position] = moved;
+    }
+    constraints.removeLast();
+}
+
+/*! \returns the position of the stored constraint with the same indexes
+ * as \a c, or -1 if there is none. Constraints with valid indexes are
+ * looked up in the adjacency list of their start index.
+ */
+int ConstraintModel::Private::findConstraint(const Constraint &c) const
+{
+    if (c.startIndex().isValid() && c.endIndex().isValid()) {
+        ensureAdjacency();
+        const AdjacencyType::const_iterator it = outEdges.constFind(c.startIndex());
+        if (it != outEdges.constEnd()) {
+            for (int position : *it) {
+                if (c.compareIndexes(constraints.at(position)))
+                    return position;
+            }
+        }
+        return -1;
+    }
+    for (int i = 0; i < constraints.count(); ++i) {
+        if (c.compareIndexes(constraints.at(i)))
+            return i;
+    }
+    return -1;
+}
+
+QList<Constraint> ConstraintModel::Private::constraintsAt(const AdjacencyType &adjacency, const QModelIndex &idx) const
+{
+    ensureAdjacency();
+    QList<Constraint> result;
+    const AdjacencyType::const_iterator it = adjacency.constFind(idx);
+    if (it != adjacency.constEnd()) {
+        result.reserve(it->count());
+        for (int position : *it)
+            result.push_back(constraints.at(position));
+    }
+    return result;
+}
 
 /*! Constructor. Creates an empty ConstraintModel with parent \a parent
  */
@@ -83,22 +216,7 @@ ConstraintModel::~ConstraintModel()
 
 void ConstraintModel::init()
 {
-}
-
-namespace {
-struct compare_constraint_indexes_to
-{
-    compare_constraint_indexes_to(const Constraint &c)
-        : m_c(c)
-    {
-    }
-    bool operator()(const Constraint &c) const
-    {
-        return m_c.compareIndexes(c);
-    }
-
-    const Constraint &m_c;
-};
+    d->q = this;
 }
 
 /*! Adds the constraint \a c to this ConstraintModel
@@ -108,25 +226,51 @@ struct compare_constraint_indexes_to
 void ConstraintModel::addConstraint(const Constraint &c)
 {
     // qDebug() << "ConstraintModel::addConstraint("<<c<<") (this="<<this<<") items=" << d->constraints.size();
-    QList<Constraint>::iterator it = std::find_if(d->constraints.begin(),
-                                                  d->constraints.end(),
-                                                  compare_constraint_indexes_to(c));
-
-    if (it == d->constraints.end()) {
-        d->constraints.push_back(c);
-        d->addConstraintToIndex(c.startIndex(), c);
-        d->addConstraintToIndex(c.endIndex(), c);
+    const int i = d->findConstraint(c);
+    if (i < 0) {
+        d->insertConstraint(c);
         Q_EMIT constraintAdded(c);
-    } else if ((*it).dataMap() != c.dataMap()) {
-        Constraint tmp(*it); // save to avoid re-entrancy issues
+    } else if (d->constraints.at(i).dataMap() != c.dataMap()) {
+        Constraint tmp(d->constraints.at(i)); // save to avoid re-entrancy issues
         removeConstraint(tmp);
-        d->constraints.push_back(c);
-        d->addConstraintToIndex(c.startIndex(), c);
-        d->addConstraintToIndex(c.endIndex(), c);
+        d->insertConstraint(c);
         Q_EMIT constraintAdded(c);
     }
 }
 
+/*! Adds all constraints in \a constraints to this ConstraintModel.
+ *
+ * This is the preferred way of loading a large number of constraints:
+ * constraints that are already in the model are skipped, and instead
+ * of one constraintAdded() signal per constraint the signal
+ * constraintsAdded() is emitted once with all constraints that were
+ * actually added.
+ *
+ * A constraint that replaces an existing one with the same indexes but
+ * different data still causes constraintRemoved() for the old one.
+ *
+ * \see addConstraint()
+ */
+void ConstraintModel::addConstraints(const QList<Constraint> &constraints)
+{
+    QList<Constraint> added;
+    added.reserve(constraints.count());
+    d->constraints.reserve(d->constraints.count() + constraints.count());
+    for (const Constraint &c : constraints) {
+        const int i = d->findConstraint(c);
+        if (i >= 0) {
+            if (d->constraints.at(i).dataMap() == c.dataMap())
+                continue;
+            Constraint tmp(d->constraints.at(i)); // save to avoid re-entrancy issues
+            removeConstraint(tmp);
+        }
+        d->insertConstraint(c);
+        added.push_back(c);
+    }
+    if (!added.isEmpty())
+        Q_EMIT constraintsAdded(added);
+}
+
 /*! Removes the Constraint \a c from this
  * ConstraintModel. If \a c was found and removed,
  * the signal constraintRemoved(const Constraint&) is emitted.
@@ -136,22 +280,14 @@ void ConstraintModel::addConstraint(const Constraint &c)
  */
 bool ConstraintModel::removeConstraint(const Constraint &c)
 {
-    bool rc = false;
-
-    for (int i = 0; i < d->constraints.count(); i++) {
-        if (c.compareIndexes(d->constraints.at(i))) {
-            d->constraints.removeAt(i);
-            rc = true;
-        }
-    }
-
-    if (rc) {
-        d->removeConstraintFromIndex(c.startIndex(), c);
-        d->removeConstraintFromIndex(c.endIndex(), c);
-        Q_EMIT constraintRemoved(c);
-    }
-
-    return rc;
+    // There is at most one constraint per pair of indexes
+    const int i = d->findConstraint(c);
+    if (i < 0)
+        return false;
+
+    d->eraseConstraint(i);
+    Q_EMIT constraintRemoved(c);
+    return true;
 }
 
 /*! Removes all Constraints from this model
@@ -194,7 +330,7 @@ QList<Constraint> ConstraintModel::constraints() const
 QList<Constraint> ConstraintModel::constraintsForIndex(const QModelIndex &idx) const
 {
     // TODO: @Steffen: Please comment on this assert, it's long and not obvious (Johannes)
-    assert(!idx.isValid() || d->indexMap.isEmpty() || !d->indexMap.keys().front().model() || idx.model() == d->indexMap.keys().front().model());
+    assert(!idx.isValid() || d->outEdges.isEmpty() || !d->outEdges.constBegin().key().model() || idx.model() == d->outEdges.constBegin().key().model());
     if (!idx.isValid()) {
         // Because of a Qt bug we need to treat this as a special case
         QSet<Constraint> result;
@@ -204,15 +340,32 @@ QList<Constraint> ConstraintModel::constraintsForIndex(const QModelIndex &idx) c
         }
         return result.values();
     } else {
-        QList<Constraint> result;
-        for (const Constraint &c : d->constraints) {
-            if (c.startIndex() == idx || c.endIndex() == idx)
+        QList<Constraint> result = d->constraintsAt(d->outEdges, idx);
+        const QList<Constraint> in = d->constraintsAt(d->inEdges, idx);
+        for (const Constraint &c : in) {
+            if (c.startIndex() != idx) // not already in the out-edges
                 result.push_back(c);
         }
         return result;
     }
+}
+
+/*! \returns A list of all Constraints in this ConstraintModel
+ * that start at \a idx, i.e. the outgoing edges of \a idx
+ * in the dependency graph.
+ */
+QList<Constraint> ConstraintModel::constraintsFromIndex(const QModelIndex &idx) const
+{
+    return d->constraintsAt(d->outEdges, idx);
+}
 
-    // return d->indexMap.values( idx );
+/*! \returns A list of all Constraints in this ConstraintModel
+ * that end at \a idx, i.e. the incoming edges of \a idx
+ * in the dependency graph.
+ */
+QList<Constraint> ConstraintModel::constraintsToIndex(const QModelIndex &idx) const
+{
+    return d->constraintsAt(d->inEdges, idx);
 }
 
 /*! Returns true if a Constraint with start \a s and end \a e
@@ -228,13 +381,7 @@ bool ConstraintModel::hasConstraint(const Constraint &c) const
     }
     return false;
     */
-    bool hc = false;
-
-    for (int i = 0; i < d->constraints.count(); i++)
-        if (c.compareIndexes(d->constraints.at(i)))
-            hc = true;
-
-    return hc;
+    return d->findConstraint(c) >= 0;
 }
 
 #ifndef QT_NO_DEBUG_STREAM
@@ -317,6 +464,101 @@ KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, ConstraintModel, "test")
     assertTrue(model.hasConstraint(Constraint(idx1, idx2)));
 }
 
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, ConstraintModelBulk, "test")
+{
+    QStandardItemModel dummyModel(100, 100);
+    ConstraintModel model;
+
+    int bulkSignals = 0;
+    int addedCount = 0;
+    QObject::connect(&model, &ConstraintModel::constraintsAdded,
+                     [&](const QList<Constraint> &lst) {
+                         ++bulkSignals;
+                         addedCount += lst.count();
+                     });
+
+    const QModelIndex idx1 = dummyModel.index(1, 0);
+    const QModelIndex idx2 = dummyModel.index(2, 0);
+    const QModelIndex idx3 = dummyModel.index(3, 0);
+
+    QList<Constraint> lst;
+    lst << Constraint(idx1, idx2) << Constraint(idx1, idx3) << Constraint(idx2, idx3)
+        << Constraint(idx1, idx2); // duplicate
+    model.addConstraints(lst);
+    assertEqual(bulkSignals, 1);
+    assertEqual(addedCount, 3);
+    assertEqual(model.constraints().count(), 3);
+
+    assertEqual(model.constraintsFromIndex(idx1).count(), 2);
+    assertEqual(model.constraintsToIndex(idx1).count(), 0);
+    assertEqual(model.constraintsToIndex(idx3).count(), 2);
+    assertEqual(model.constraintsForIndex(idx2).count(), 2);
+
+    // Nothing new, no signal
+    model.addConstraints(lst);
+    assertEqual(bulkSignals, 1);
+
+    assertTrue(model.removeConstraint(Constraint(idx1, idx3)));
+    assertEqual(model.constraintsFromIndex(idx1).count(), 1);
+    assertEqual(model.constraintsToIndex(idx3).count(), 1);
+    assertFalse(model.hasConstraint(Constraint(idx1, idx3)));
+
+    model.clear();
+    assertEqual(model.constraints().count(), 0);
+    assertEqual(model.constraintsForIndex(idx2).count(), 0);
+
+    // the last constraint takes the place of a removed one
+    QList<Constraint> chain;
+    for (int row = 10; row < 20; ++row)
+        chain << Constraint(dummyModel.index(row, 0), dummyModel.index(row + 1, 0));
+    model.addConstraints(chain);
+    assertTrue(model.removeConstraint(chain.at(3)));
+    assertTrue(model.removeConstraint(chain.at(0)));
+    assertEqual(model.constraints().count(), 8);
+    assertFalse(model.hasConstraint(chain.at(3)));
+    for (int i = 4; i < chain.count(); ++i) {
+        assertTrue(model.hasConstraint(chain.at(i)));
+        assertEqual(model.constraintsFromIndex(chain.at(i).startIndex()).count(), 1);
+        assertTrue(model.constraintsToIndex(chain.at(i).endIndex()).first().compareIndexes(chain.at(i)));
+    }
+    assertEqual(model.constraintsToIndex(dummyModel.index(4 + 10, 0)).count(), 0);
+    model.clear();
+    assertEqual(model.constraints().count(), 0);
+}
+
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, ConstraintModelMovedIndexes, "test")
+{
+    QStandardItemModel dummyModel(100, 100);
+    ConstraintModel model;
+
+    const QPersistentModelIndex idx1 = dummyModel.index(7, 0);
+    const QPersistentModelIndex idx2 = dummyModel.index(42, 0);
+    const QPersistentModelIndex idx3 = dummyModel.index(50, 0);
+    model.addConstraint(Constraint(idx1, idx2));
+    model.addConstraint(Constraint(idx2, idx3));
+
+    // the constrained items move down by one row
+    dummyModel.insertRow(3);
+    assertEqual(idx1.row(), 8);
+    assertTrue(model.hasConstraint(Constraint(idx1, idx2)));
+    assertEqual(model.constraintsForIndex(idx2).count(), 2);
+
+    model.addConstraint(Constraint(idx1, idx2));
+    assertEqual(model.constraints().count(), 2);
+
+    assertTrue(model.removeConstraint(Constraint(idx1, idx2)));
+    assertFalse(model.hasConstraint(Constraint(idx1, idx2)));
+    assertEqual(model.constraints().count(), 1);
+    assertEqual(model.constraintsFromIndex(idx2).count(), 1);
+    assertEqual(model.constraintsToIndex(idx2).count(), 0);
+
+    // and up again
+    dummyModel.removeRow(0);
+    assertTrue(model.hasConstraint(Constraint(idx2, idx3)));
+    assertTrue(model.removeConstraint(Constraint(idx2, idx3)));
+    assertEqual(model.constraints().count(), 0);
+}
+
 #endif /* KDAB_NO_UNIT_TESTS */
 
 #include "moc_kdganttconstraintmodel.cpp"
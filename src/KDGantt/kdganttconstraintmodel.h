@@ -34,6 +34,8 @@ public:
     virtual void addConstraint(const Constraint &c);
     virtual bool removeConstraint(const Constraint &c);
 
+    void addConstraints(const QList<Constraint> &constraints);
+
     void clear();
     void cleanup();
 
@@ -44,9 +46,12 @@ public:
                               const QModelIndex &e) const;
 
     QList<Constraint> constraintsForIndex(const QModelIndex &) const;
+    QList<Constraint> constraintsFromIndex(const QModelIndex &) const;
+    QList<Constraint> constraintsToIndex(const QModelIndex &) const;
 
 Q_SIGNALS:
     void constraintAdded(const KDGantt::Constraint &);
+    void constraintsAdded(const QList<KDGantt::Constraint> &);
     void constraintRemoved(const KDGantt::Constraint &);
 
 private:
@@ -13,9 +13,11 @@
 
 #include "kdganttconstraintmodel.h"
 
+#include <QHash>
 #include <QList>
-#include <QMultiHash>
 #include <QPersistentModelIndex>
+#include <QPointer>
+#include <QVector>
 
 namespace KDGantt {
 class ConstraintModel::Private
@@ -23,13 +25,27 @@ class ConstraintModel::Private
 public:
     Private();
 
-    void addConstraintToIndex(const QModelIndex &idx, const Constraint &c);
-    void removeConstraintFromIndex(const QModelIndex &idx, const Constraint &c);
+    void insertConstraint(const Constraint &c);
+    void eraseConstraint(int position);
+    int findConstraint(const Constraint &c) const;
+    void watchModel(const QAbstractItemModel *model);
+    void ensureAdjacency() const;
 
-    typedef QMultiHash<QPersistentModelIndex, Constraint> IndexType;
+    /* Adjacency lists: for every index the positions in constraints
+     * of the constraints starting (outEdges) and ending (inEdges) at it.
+     * The hash of a persistent index depends on its current row and
+     * column, so the lists are rebuilt after the rows or columns of a
+     * model the constraints refer to have changed. */
+    typedef QHash<QPersistentModelIndex, QList<int>> AdjacencyType;
 
+    QList<Constraint> constraintsAt(const AdjacencyType &adjacency, const QModelIndex &idx) const;
+
+    ConstraintModel *q = nullptr;
     QList<Constraint> constraints;
-    IndexType indexMap;
+    mutable AdjacencyType outEdges;
+    mutable AdjacencyType inEdges;
+    mutable bool adjacencyDirty = false;
+    QVector<QPointer<QAbstractItemModel>> watchedModels;
 };
 }
 
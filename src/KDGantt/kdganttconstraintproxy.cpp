@@ -38,6 +38,8 @@ void ConstraintProxy::setSourceModel(ConstraintModel *src)
 
     connect(m_source, &ConstraintModel::constraintAdded,
             this, &ConstraintProxy::slotSourceConstraintAdded);
+    connect(m_source, &ConstraintModel::constraintsAdded,
+            this, &ConstraintProxy::slotSourceConstraintsAdded);
     connect(m_source, &ConstraintModel::constraintRemoved,
             this, &ConstraintProxy::slotSourceConstraintRemoved);
 }
@@ -52,6 +54,8 @@ void ConstraintProxy::setDestinationModel(ConstraintModel *dest)
 
     connect(m_destination, &ConstraintModel::constraintAdded,
             this, &ConstraintProxy::slotDestinationConstraintAdded);
+    connect(m_destination, &ConstraintModel::constraintsAdded,
+            this, &ConstraintProxy::slotDestinationConstraintsAdded);
     connect(m_destination, &ConstraintModel::constraintRemoved,
             this, &ConstraintProxy::slotDestinationConstraintRemoved);
 }
@@ -88,12 +92,7 @@ void ConstraintProxy::copyFromSource()
         m_destination->clear();
         if (!m_source)
             return;
-        const QList<Constraint> lst = m_source->constraints();
-        for (const Constraint &c : lst) {
-            Constraint temp(m_proxy->mapFromSource(c.startIndex()), m_proxy->mapFromSource(c.endIndex()),
-                            c.type(), c.relationType(), c.dataMap());
-            m_destination->addConstraint(temp);
-        }
+        slotSourceConstraintsAdded(m_source->constraints());
     }
 }
 
@@ -106,6 +105,19 @@ void ConstraintProxy::slotSourceConstraintAdded(const KDGantt::Constraint &c)
     }
 }
 
+void ConstraintProxy::slotSourceConstraintsAdded(const QList<KDGantt::Constraint> &lst)
+{
+    if (m_destination) {
+        QList<Constraint> mapped;
+        mapped.reserve(lst.count());
+        for (const Constraint &c : lst) {
+            mapped.push_back(Constraint(m_proxy->mapFromSource(c.startIndex()), m_proxy->mapFromSource(c.endIndex()),
+                                        c.type(), c.relationType(), c.dataMap()));
+        }
+        m_destination->addConstraints(mapped);
+    }
+}
+
 void ConstraintProxy::slotSourceConstraintRemoved(const KDGantt::Constraint &c)
 {
     if (m_destination) {
@@ -124,6 +136,19 @@ void ConstraintProxy::slotDestinationConstraintAdded(const KDGantt::Constraint &
     }
 }
 
+void ConstraintProxy::slotDestinationConstraintsAdded(const QList<KDGantt::Constraint> &lst)
+{
+    if (m_source) {
+        QList<Constraint> mapped;
+        mapped.reserve(lst.count());
+        for (const Constraint &c : lst) {
+            mapped.push_back(Constraint(m_proxy->mapToSource(c.startIndex()), m_proxy->mapToSource(c.endIndex()),
+                                        c.type(), c.relationType(), c.dataMap()));
+        }
+        m_source->addConstraints(mapped);
+    }
+}
+
 void ConstraintProxy::slotDestinationConstraintRemoved(const KDGantt::Constraint &c)
 {
     if (m_source) {
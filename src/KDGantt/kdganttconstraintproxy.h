@@ -13,6 +13,7 @@
 
 #include "kdganttglobal.h"
 
+#include <QList>
 #include <QPointer>
 
 QT_BEGIN_NAMESPACE
@@ -41,9 +42,11 @@ public:
 private Q_SLOTS:
 
     void slotSourceConstraintAdded(const KDGantt::Constraint &);
+    void slotSourceConstraintsAdded(const QList<KDGantt::Constraint> &);
     void slotSourceConstraintRemoved(const KDGantt::Constraint &);
 
     void slotDestinationConstraintAdded(const KDGantt::Constraint &);
+    void slotDestinationConstraintsAdded(const QList<KDGantt::Constraint> &);
     void slotDestinationConstraintRemoved(const KDGantt::Constraint &);
 
     void slotLayoutChanged();
@@ -578,6 +578,9 @@ static void debug_print_idx( const QModelIndex& idx )
  * Also returns false if any of the constraints isn't satisfied. That is, if the start time of
  * the constrained index is before the end time of the dependency index, or the end time of the
  * constrained index is before the start time of the dependency index.
+ * When the grid is used by a GraphicsScene and \a constraints are all the hard constraints of
+ * \a idx, the check is done against the bounds the scene keeps for them, including the
+ * ones implied transitively.
  */
 bool DateTimeGrid::mapFromChart(const Span &span, const QModelIndex &idx,
                                 const QList<Constraint> &constraints) const
@@ -590,19 +593,26 @@ bool DateTimeGrid::mapFromChart(const Span &span, const QModelIndex &idx,
     QDateTime st = d->chartXtoDateTime(span.start());
     QDateTime et = d->chartXtoDateTime(span.start() + span.length());
     // qDebug() << "DateTimeGrid::mapFromChart("<<span<<") => "<< st << et;
-    for (const Constraint &c : constraints) {
-        if (c.type() != Constraint::TypeHard || !isSatisfiedConstraint(c))
-            continue;
-        if (c.startIndex() == idx) {
-            QDateTime tmpst = model()->data(c.endIndex(), StartTimeRole).toDateTime();
-            // qDebug() << tmpst << "<" << et <<"?";
-            if (tmpst < et)
-                return false;
-        } else if (c.endIndex() == idx) {
-            QDateTime tmpet = model()->data(c.startIndex(), EndTimeRole).toDateTime();
-            // qDebug() << tmpet << ">" << st <<"?";
-            if (tmpet > st)
-                return false;
+    if (!constraints.isEmpty() && d->constraintChecker && d->constraintChecker->model() == model()
+        && d->constraintChecker->hasAllConstraints(idx, constraints)) {
+        // the scene keeps the bounds of all hard constraints up to date
+        if (!d->constraintChecker->isAllowed(idx, st, et))
+            return false;
+    } else {
+        for (const Constraint &c : constraints) {
+            if (c.type() != Constraint::TypeHard || !isSatisfiedConstraint(c))
+                continue;
+            if (c.startIndex() == idx) {
+                QDateTime tmpst = model()->data(c.endIndex(), StartTimeRole).toDateTime();
+                // qDebug() << tmpst << "<" << et <<"?";
+                if (tmpst < et)
+                    return false;
+            } else if (c.endIndex() == idx) {
+                QDateTime tmpet = model()->data(c.startIndex(), EndTimeRole).toDateTime();
+                // qDebug() << tmpet << ">" << st <<"?";
+                if (tmpet > st)
+                    return false;
+            }
         }
     }
 
@@ -29,6 +29,7 @@
 #include <QGraphicsSceneMouseEvent>
 #include <QItemSelectionModel>
 #include <QPainter>
+#include <QStyleOptionGraphicsItem>
 
 #include <QDebug>
 
@@ -159,6 +160,8 @@ void GraphicsItem::setRect(const QRectF &r)
     prepareGeometryChange();
     m_rect = r;
     updateConstraintItems();
+    if (scene())
+        scene()->invalidateMergedItems();
     update();
 }
 
@@ -179,6 +182,10 @@ void GraphicsItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *opti
 {
     Q_UNUSED(widget);
     if (boundingRect().isValid() && scene()) {
+        // Painted by the scene as part of a merged span
+        if (scene()->levelOfDetailThreshold() > 0.
+            && scene()->isAggregated(this, option->levelOfDetailFromTransform(painter->worldTransform())))
+            return;
         StyleOptionGanttItem opt = getStyleOption();
         *static_cast<QStyleOption *>(&opt) = *static_cast<const QStyleOption *>(option);
         // opt.fontMetrics = painter->fontMetrics();
@@ -239,6 +246,7 @@ void GraphicsItem::addStartConstraint(ConstraintGraphicsItem *item)
 {
     assert(item);
     m_startConstraints << item;
+    item->m_startItem = this;
     item->setStart(startConnector(item->constraint().relationType()));
     constraintsChanged();
 }
@@ -247,6 +255,7 @@ void GraphicsItem::addEndConstraint(ConstraintGraphicsItem *item)
 {
     assert(item);
     m_endConstraints << item;
+    item->m_endItem = this;
     item->setEnd(endConnector(item->constraint().relationType()));
     constraintsChanged();
 }
@@ -255,6 +264,8 @@ void GraphicsItem::removeStartConstraint(ConstraintGraphicsItem *item)
 {
     assert(item);
     m_startConstraints.removeAll(item);
+    if (item->m_startItem == this)
+        item->m_startItem = nullptr;
     constraintsChanged();
 }
 
@@ -262,6 +273,8 @@ void GraphicsItem::removeEndConstraint(ConstraintGraphicsItem *item)
 {
     assert(item);
     m_endConstraints.removeAll(item);
+    if (item->m_endItem == this)
+        item->m_endItem = nullptr;
     constraintsChanged();
 }
 
@@ -287,7 +300,9 @@ void GraphicsItem::updateItem(const Span &rowGeometry, const QPersistentModelInd
 {
     // qDebug() << "GraphicsItem::updateItem("<<rowGeometry<<idx<<")";
     Updater updater(&m_isupdating);
-    if (!idx.isValid() || idx.data(ItemTypeRole) == TypeMulti) {
+    // read once here instead of on every paint
+    m_itemType = static_cast<ItemType>(idx.data(ItemTypeRole).toInt());
+    if (!idx.isValid() || m_itemType == TypeMulti) {
         setRect(QRectF());
         hide();
         return;
@@ -522,15 +537,16 @@ void GraphicsItem::updateItemFromMouse(const QPointF &scenepos)
     const QPointF p = scenepos - m_presspos;
     QRectF r = rect();
     QRectF br = boundingRect();
+    qreal x = pos().x();
     switch (m_istate) {
     case ItemDelegate::State_Move:
-        setPos(p.x(), pos().y());
+        x = p.x();
         break;
     case ItemDelegate::State_ExtendLeft: {
         const qreal brr = br.right();
         const qreal rr = r.right();
         const qreal delta = pos().x() - p.x();
-        setPos(p.x(), QGraphicsItem::pos().y());
+        x = p.x();
         br.setRight(brr + delta);
         r.setRight(rr + delta);
         break;
@@ -544,6 +560,10 @@ void GraphicsItem::updateItemFromMouse(const QPointF &scenepos)
     default:
         return;
     }
+    // Stop at the last position allowed by the hard constraints
+    if (!scene()->satisfiesHardConstraints(index(), Span(x, r.width())))
+        return;
+    setPos(x, pos().y());
     setRect(r);
     setBoundingRect(br);
 }
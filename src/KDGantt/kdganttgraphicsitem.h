@@ -63,6 +63,10 @@ public:
         return m_index;
     }
     void setIndex(const QPersistentModelIndex &idx);
+    ItemType itemType() const
+    {
+        return m_itemType;
+    }
 
     bool isEditable() const;
     bool isUpdating() const
@@ -112,6 +116,7 @@ private:
     QRectF m_rect;
     QRectF m_boundingrect;
     QPersistentModelIndex m_index;
+    ItemType m_itemType = TypeNone;
     bool m_isupdating = false;
     int m_istate;
     QPointF m_presspos;
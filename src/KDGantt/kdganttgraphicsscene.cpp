@@ -9,6 +9,7 @@
 ****************************************************************************/
 
 #include "kdganttgraphicsscene.h"
+#include "kdganttabstractgrid_p.h"
 #include "kdganttabstractrowcontroller.h"
 #include "kdganttconstraint.h"
 #include "kdganttconstraintgraphicsitem.h"
@@ -19,11 +20,14 @@
 #include "kdganttsummaryhandlingproxymodel.h"
 
 #include <QApplication>
+#include <QGraphicsView>
 #include <QGraphicsSceneHelpEvent>
 #include <QPainter>
 #include <QPrinter>
 #include <QSet>
+#include <QStyleOptionGraphicsItem>
 #include <QTextDocument>
+#include <QTimer>
 #include <QToolTip>
 
 #include <QDebug>
@@ -54,10 +58,14 @@ GraphicsScene::Private::Private(GraphicsScene *_q)
     , rowController(nullptr)
     , grid(&default_grid)
     , readOnly(false)
+    , lodThreshold(0.)
+    , mergedItemsLod(-1.)
+    , mergedItemsDirty(true)
     , isPrinting(false)
     , drawColumnLabels(true)
     , labelsWidth(0.0)
     , summaryHandlingModel(new SummaryHandlingProxyModel(_q))
+    , pendingConstraintsScheduled(false)
     , selectionModel(nullptr)
 {
     default_grid.setStartDateTime(QDateTime::currentDateTime().addDays(-1));
@@ -66,12 +74,10 @@ GraphicsScene::Private::Private(GraphicsScene *_q)
 void GraphicsScene::Private::resetConstraintItems()
 {
     q->clearConstraintItems();
+    pendingConstraints.clear();
     if (constraintModel.isNull())
         return;
-    const QList<Constraint> clst = constraintModel->constraints();
-    for (const Constraint &c : clst) {
-        createConstraintItem(c);
-    }
+    queueConstraintItems(constraintModel->constraints());
     q->updateItems();
 }
 
@@ -90,6 +96,82 @@ void GraphicsScene::Private::createConstraintItem(const Constraint &c)
     // q->insertConstraintItem( c, citem );
 }
 
+/* Constraint items are created lazily: constraints added in bulk are
+ * queued, and on the next event loop iteration items are created only
+ * for the constraints that touch the visible part of the scene. The
+ * others stay pending until they get exposed by scrolling or zooming.
+ */
+void GraphicsScene::Private::queueConstraintItems(const QList<Constraint> &clst)
+{
+    for (const Constraint &c : clst)
+        pendingConstraints[c.startIndex()].push_back(c);
+    pendingConstraintsSearched = QRectF();
+    requestConstraintItems(visibleSceneRect());
+}
+
+void GraphicsScene::Private::requestConstraintItems(const QRectF &area)
+{
+    if (!area.isNull() && pendingConstraintsSearched.contains(area))
+        return;
+    pendingConstraintsArea |= area;
+    if (!pendingConstraintsScheduled) {
+        pendingConstraintsScheduled = true;
+        QTimer::singleShot(0, q, &GraphicsScene::slotCreatePendingConstraintItems);
+    }
+}
+
+/* \returns the part of the scene shown in the views, or a null rect
+ * if the scene is not shown at all
+ */
+QRectF GraphicsScene::Private::visibleSceneRect() const
+{
+    QRectF area;
+    const QList<QGraphicsView *> vlst = q->views();
+    for (QGraphicsView *view : vlst) {
+        if (view->isVisible())
+            area |= view->mapToScene(view->viewport()->rect()).boundingRect();
+    }
+    return area;
+}
+
+/* Creates the items for the pending constraints that intersect \a area,
+ * or for all of them if \a area is null.
+ * \returns true if any item was created
+ */
+bool GraphicsScene::Private::createPendingConstraintItems(const QRectF &area)
+{
+    bool created = false;
+    auto it = pendingConstraints.begin();
+    while (it != pendingConstraints.end()) {
+        QList<Constraint> &clst = it.value();
+        for (int i = clst.count() - 1; i >= 0; --i) {
+            const Constraint c = clst.at(i);
+            // insertItem() may have created the item in the meantime
+            if (findConstraintItem(c)) {
+                clst.removeAt(i);
+                continue;
+            }
+            if (!area.isNull()) {
+                GraphicsItem *sitem = items.value(summaryHandlingModel->mapFromSource(c.startIndex()), 0);
+                GraphicsItem *eitem = items.value(summaryHandlingModel->mapFromSource(c.endIndex()), 0);
+                // without both items there is nothing to draw, insertItem() creates it later
+                if (sitem && eitem && !(sitem->sceneBoundingRect() | eitem->sceneBoundingRect()).intersects(area))
+                    continue;
+            }
+            clst.removeAt(i);
+            createConstraintItem(c);
+            created = true;
+        }
+        if (clst.isEmpty())
+            it = pendingConstraints.erase(it);
+        else
+            ++it;
+    }
+    if (!area.isNull())
+        pendingConstraintsSearched = area;
+    return created;
+}
+
 // Delete the constraint item, and clean up pointers in the start- and end item
 void GraphicsScene::Private::deleteConstraintItem(ConstraintGraphicsItem *citem)
 {
@@ -162,6 +244,8 @@ GraphicsScene::~GraphicsScene()
 void GraphicsScene::init()
 {
     setItemIndexMethod(QGraphicsScene::NoIndex);
+    d->constraintChecker.setModel(d->summaryHandlingModel);
+    d->grid->d_func()->constraintChecker = &d->constraintChecker;
     setConstraintModel(new ConstraintModel(this));
     connect(d->grid, &AbstractGrid::gridChanged, this, &GraphicsScene::slotGridChanged);
 }
@@ -175,6 +259,7 @@ void GraphicsScene::setItemDelegate(ItemDelegate *delegate)
     if (!d->itemDelegate.isNull() && d->itemDelegate->parent() == this)
         delete d->itemDelegate;
     d->itemDelegate = delegate;
+    invalidateMergedItems();
     update();
 }
 
@@ -194,6 +279,7 @@ void GraphicsScene::setModel(QAbstractItemModel *model)
     assert(!d->summaryHandlingModel.isNull());
     d->summaryHandlingModel->setSourceModel(model);
     d->grid->setModel(d->summaryHandlingModel);
+    d->constraintChecker.invalidate();
     setSelectionModel(new QItemSelectionModel(model, this));
 }
 
@@ -206,6 +292,7 @@ void GraphicsScene::setSummaryHandlingModel(QAbstractProxyModel *proxyModel)
 {
     proxyModel->setSourceModel(model());
     d->summaryHandlingModel = proxyModel;
+    d->constraintChecker.setModel(proxyModel);
 }
 
 void GraphicsScene::setRootIndex(const QModelIndex &idx)
@@ -229,9 +316,12 @@ void GraphicsScene::setConstraintModel(ConstraintModel *cm)
         d->constraintModel->disconnect(this);
     }
     d->constraintModel = cm;
+    d->constraintChecker.setConstraintModel(cm);
 
     connect(cm, &ConstraintModel::constraintAdded,
             this, &GraphicsScene::slotConstraintAdded);
+    connect(cm, &ConstraintModel::constraintsAdded,
+            this, &GraphicsScene::slotConstraintsAdded);
     connect(cm, &ConstraintModel::constraintRemoved,
             this, &GraphicsScene::slotConstraintRemoved);
     d->resetConstraintItems();
@@ -265,9 +355,11 @@ void GraphicsScene::setGrid(AbstractGrid *grid)
         grid = &d->default_grid;
     if (d->grid) {
         d->grid->disconnect(this);
+        d->grid->d_func()->constraintChecker = nullptr;
         model = d->grid->model();
     }
     d->grid = grid;
+    d->grid->d_func()->constraintChecker = &d->constraintChecker;
     connect(d->grid, &AbstractGrid::gridChanged, this, &GraphicsScene::slotGridChanged);
     d->grid->setModel(model);
     slotGridChanged();
@@ -288,6 +380,56 @@ bool GraphicsScene::isReadOnly() const
     return d->readOnly;
 }
 
+/*! Enables the level of detail mode if \a pixels is greater than 0.
+ *
+ * Task items narrower than \a pixels on screen are then not painted
+ * one by one; the scene merges those in the same row into a single
+ * span and draws that instead. Their labels and the constraint arrows
+ * attached to them are not drawn. As soon as the items are wide
+ * enough again, e.g. after zooming in, they are painted in full detail.
+ *
+ * The default is 0, which paints every item in full detail.
+ */
+void GraphicsScene::setLevelOfDetailThreshold(qreal pixels)
+{
+    if (qFuzzyCompare(d->lodThreshold, pixels))
+        return;
+    d->lodThreshold = pixels;
+    invalidateMergedItems();
+    // Items cache their rendering
+    for (GraphicsItem *item : qAsConst(d->items))
+        item->update();
+    update();
+}
+
+qreal GraphicsScene::levelOfDetailThreshold() const
+{
+    return d->lodThreshold;
+}
+
+/*! \returns true if \a item is painted as part of a merged span instead
+ * of on its own at the level of detail \a levelOfDetail, as returned by
+ * QStyleOptionGraphicsItem::levelOfDetailFromTransform().
+ */
+bool GraphicsScene::isAggregated(const GraphicsItem *item, qreal levelOfDetail) const
+{
+    if (d->lodThreshold <= 0. || !item->rect().isValid())
+        return false;
+    if (item->rect().width() * levelOfDetail >= d->lodThreshold)
+        return false;
+    return item->itemType() == TypeTask;
+}
+
+/*! Marks the merged spans of the level of detail mode as outdated.
+ * Called whenever the geometry of an item changes.
+ */
+void GraphicsScene::invalidateMergedItems()
+{
+    d->mergedItemsDirty = true;
+    // pending constraints may have moved into the searched area
+    d->pendingConstraintsSearched = QRectF();
+}
+
 /* Returns the index with column=0 from the
  * same row as idx and with the same parent.
  * This is used to traverse the tree-structure
@@ -324,6 +466,59 @@ QModelIndex GraphicsScene::dataIndex(const QModelIndex &idx)
 #endif
 }
 
+/* Collects the scene rectangles of all aggregated items and merges
+ * those in the same row that have the same brush and touch or are less
+ * than a pixel apart.
+ */
+/* \returns the brush a merged span of \a item is filled with: the brush
+ * or color the model provides for Qt::BackgroundRole, or the default
+ * brush for the type of the item.
+ */
+QBrush GraphicsScene::Private::mergedItemBrush(const GraphicsItem *item) const
+{
+    const QVariant brush = item->index().data(Qt::BackgroundRole);
+    if (brush.userType() == QMetaType::QBrush)
+        return brush.value<QBrush>();
+    if (brush.userType() == QMetaType::QColor)
+        return QBrush(brush.value<QColor>());
+    return itemDelegate->defaultBrush(item->itemType());
+}
+
+void GraphicsScene::Private::updateMergedItems(qreal levelOfDetail)
+{
+    mergedItemsDirty = false;
+    mergedItemsLod = levelOfDetail;
+    mergedItems.clear();
+
+    QVector<MergedItem> rects;
+    for (QHash<QPersistentModelIndex, GraphicsItem *>::const_iterator it = items.constBegin();
+         it != items.constEnd(); ++it) {
+        const GraphicsItem *item = *it;
+        if (item->isVisible() && q->isAggregated(item, levelOfDetail)) {
+            MergedItem m;
+            m.rect = item->mapRectToScene(item->rect());
+            m.brush = mergedItemBrush(item);
+            rects.push_back(m);
+        }
+    }
+    std::sort(rects.begin(), rects.end(), [](const MergedItem &a, const MergedItem &b) {
+        return a.rect.top() < b.rect.top() || (a.rect.top() == b.rect.top() && a.rect.left() < b.rect.left());
+    });
+
+    const qreal gap = 1. / levelOfDetail;
+    for (const MergedItem &m : qAsConst(rects)) {
+        if (!mergedItems.isEmpty()) {
+            MergedItem &last = mergedItems.last();
+            if (last.rect.top() == m.rect.top() && last.rect.height() == m.rect.height()
+                && m.rect.left() <= last.rect.right() + gap && last.brush == m.brush) {
+                last.rect.setRight(qMax(last.rect.right(), m.rect.right()));
+                continue;
+            }
+        }
+        mergedItems.push_back(m);
+    }
+}
+
 /*! Creates a new item of type type.
  * TODO: If the user should be allowed to override
  * this in any way, it needs to be in View!
@@ -446,6 +641,7 @@ void GraphicsScene::insertItem(const QPersistentModelIndex &idx, GraphicsItem *i
     }
     d->items.insert(idx, item);
     addItem(item);
+    invalidateMergedItems();
 }
 
 void GraphicsScene::removeItem(const QModelIndex &idx)
@@ -475,6 +671,7 @@ void GraphicsScene::removeItem(const QModelIndex &idx)
         }
         // Get rid of the item
         delete item;
+        invalidateMergedItems();
     }
 }
 
@@ -503,6 +700,7 @@ void GraphicsScene::clearItems()
         delete *it;
     }
     d->items.clear();
+    invalidateMergedItems();
 
     // Clear constraints
     QList<QGraphicsItem *> items = d->q->items();
@@ -542,9 +740,26 @@ void GraphicsScene::deleteSubtree(const QModelIndex &_idx)
 
 ConstraintGraphicsItem *GraphicsScene::findConstraintItem(const Constraint &c) const
 {
+    if (!d->pendingConstraints.isEmpty())
+        const_cast<GraphicsScene *>(this)->d_func()->createPendingConstraintItems();
     return d->findConstraintItem(c);
 }
 
+/*! \returns true if the item at \a idx can be placed at \a span
+ * (in scene coordinates) without violating a hard constraint that
+ * is satisfied by its current position.
+ * This is checked in constant time, so it can be done on every
+ * mouse move while dragging.
+ */
+bool GraphicsScene::satisfiesHardConstraints(const QModelIndex &idx, const Span &span) const
+{
+    const QDateTime st = d->grid->mapFromChart(span.start()).toDateTime();
+    const QDateTime et = d->grid->mapFromChart(span.end()).toDateTime();
+    if (!st.isValid() || !et.isValid())
+        return true; // the grid can not map, leave it to AbstractGrid::mapFromChart()
+    return d->constraintChecker.isAllowed(idx, st, et);
+}
+
 void GraphicsScene::clearConstraintItems()
 {
     // TODO
@@ -556,11 +771,45 @@ void GraphicsScene::slotConstraintAdded(const KDGantt::Constraint &c)
     d->createConstraintItem(c);
 }
 
+void GraphicsScene::slotConstraintsAdded(const QList<KDGantt::Constraint> &clst)
+{
+    d->queueConstraintItems(clst);
+}
+
 void GraphicsScene::slotConstraintRemoved(const KDGantt::Constraint &c)
 {
+    const auto it = d->pendingConstraints.find(c.startIndex());
+    if (it != d->pendingConstraints.end()) {
+        QList<Constraint> &clst = it.value();
+        for (int i = clst.count() - 1; i >= 0; --i) {
+            if (c.compareIndexes(clst.at(i)))
+                clst.removeAt(i);
+        }
+        if (clst.isEmpty())
+            d->pendingConstraints.erase(it);
+    }
     d->deleteConstraintItem(c);
 }
 
+void GraphicsScene::slotCreatePendingConstraintItems()
+{
+    d->pendingConstraintsScheduled = false;
+    const QRectF area = d->pendingConstraintsArea | d->visibleSceneRect();
+    d->pendingConstraintsArea = QRectF();
+    if (d->pendingConstraints.isEmpty())
+        return;
+    if (views().isEmpty()) {
+        // nothing will ever expose them, so do not wait
+        d->createPendingConstraintItems();
+        return;
+    }
+    // a hidden view requests its items once it gets painted
+    if (area.isNull())
+        return;
+    if (d->createPendingConstraintItems(area))
+        update();
+}
+
 void GraphicsScene::slotGridChanged()
 {
     updateItems();
@@ -612,6 +861,34 @@ void GraphicsScene::drawBackground(QPainter *painter, const QRectF &_rect)
     d->grid->paintGrid(painter, scn, rect, d->rowController);
 
     d->grid->drawBackground(painter, rect);
+
+    // items can not be added while painting, create them for the next paint
+    if (!d->pendingConstraints.isEmpty() && !d->isPrinting)
+        d->requestConstraintItems(rect);
+
+    if (d->lodThreshold > 0. && !d->isPrinting) {
+        const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+        if (d->mergedItemsDirty || !qFuzzyCompare(d->mergedItemsLod, lod))
+            d->updateMergedItems(lod);
+        if (!d->mergedItems.isEmpty()) {
+            painter->save();
+            painter->setPen(Qt::NoPen);
+            const qreal minWidth = 1. / lod;
+            for (const Private::MergedItem &m : qAsConst(d->mergedItems)) {
+                QRectF r = m.rect;
+                if (!r.intersects(rect))
+                    continue;
+                painter->setBrush(m.brush);
+                painter->setBrushOrigin(r.topLeft());
+                // same geometry as the task bars in ItemDelegate::paintGanttItem()
+                r.translate(0., r.height() / 6.);
+                r.setHeight(2. * r.height() / 3.);
+                r.setWidth(qMax(r.width(), minWidth));
+                painter->drawRect(r);
+            }
+            painter->restore();
+        }
+    }
 }
 
 void GraphicsScene::drawForeground(QPainter *painter, const QRectF &rect)
@@ -739,6 +1016,7 @@ void GraphicsScene::doPrint(QPainter *painter, const QRectF &targetRect,
                             QPrinter *printer, bool drawRowLabels, bool drawColumnLabels)
 {
     assert(painter);
+    d->createPendingConstraintItems();
     d->isPrinting = true;
     d->drawColumnLabels = drawColumnLabels;
     d->labelsWidth = 0.0;
@@ -843,6 +1121,7 @@ void GraphicsScene::doPrint(QPainter *painter, const QRectF &targetRect,
 #include "unittest/test.h"
 
 #include <QGraphicsLineItem>
+#include <QImage>
 #include <QPointer>
 #include <QStandardItemModel>
 
@@ -966,4 +1245,74 @@ KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, GraphicsView, "test")
     graphicsView.updateScene();
     assertFalse(foreignItemDestroyed);
 }
+
+/* Renders the item \a item of \a scene at level of detail \a lod
+ * and returns the color in the middle of it
+ */
+static QColor renderedItemColor(KDGantt::GraphicsScene *scene, const KDGantt::GraphicsItem *item, qreal lod)
+{
+    const QRectF source = item->mapRectToScene(item->rect()).adjusted(-10., -10., 10., 10.);
+    QImage image((source.size() * lod).toSize(), QImage::Format_RGB32);
+    image.fill(Qt::white);
+    QPainter painter(&image);
+    scene->render(&painter, QRectF(QPointF(0., 0.), source.size() * lod), source);
+    painter.end();
+    return image.pixelColor(image.width() / 2, image.height() / 2);
+}
+
+KDAB_SCOPED_UNITTEST_SIMPLE(KDGantt, LevelOfDetail, "test")
+{
+    QStandardItemModel model;
+    for (int row = 0; row < 2; ++row) {
+        auto *item = new QStandardItem();
+        item->setData(KDGantt::TypeTask, KDGantt::ItemTypeRole);
+        item->setData(QDate(2007, 3, 1).startOfDay(), KDGantt::StartTimeRole);
+        item->setData(QDate(2007, 3, 3).startOfDay(), KDGantt::EndTimeRole);
+        model.appendRow(item);
+    }
+    model.setData(model.index(0, 0), QColor(Qt::red), Qt::BackgroundRole);
+
+    SceneTestRowController rowController;
+    rowController.setModel(&model);
+
+    KDGantt::GraphicsView graphicsView;
+    auto *grid = new KDGantt::DateTimeGrid;
+    grid->setStartDateTime(QDate(2007, 3, 1).startOfDay());
+    grid->setDayWidth(100.);
+    graphicsView.setGrid(grid);
+    graphicsView.setRowController(&rowController);
+    graphicsView.setModel(&model);
+    graphicsView.updateScene();
+
+    auto *scene = qobject_cast<KDGantt::GraphicsScene *>(graphicsView.scene());
+    assertTrue(scene);
+    KDGantt::GraphicsItem *first = scene->findItem(scene->summaryHandlingModel()->mapFromSource(model.index(0, 0)));
+    KDGantt::GraphicsItem *second = scene->findItem(scene->summaryHandlingModel()->mapFromSource(model.index(1, 0)));
+    assertTrue(first);
+    assertTrue(second);
+    assertEqual(first->itemType(), KDGantt::TypeTask);
+
+    // The items are two days of 100 pixels wide
+    assertFalse(scene->isAggregated(first, 0.5)); // no threshold
+    scene->setLevelOfDetailThreshold(150.);
+    assertTrue(scene->isAggregated(first, 0.5));
+    assertFalse(scene->isAggregated(first, 1.));
+
+    // The merged span is painted with the brush of the item
+    assertTrue(renderedItemColor(scene, first, 0.5) == QColor(Qt::red));
+
+    // Changing the default brush only shows after invalidating the spans
+    renderedItemColor(scene, second, 0.5);
+    scene->itemDelegate()->setDefaultBrush(KDGantt::TypeTask, QBrush(Qt::blue));
+    scene->invalidateMergedItems();
+    assertTrue(renderedItemColor(scene, second, 0.5) == QColor(Qt::blue));
+
+    // Only tasks are merged, the item type is picked up on data changes
+    model.setData(model.index(0, 0), KDGantt::TypeEvent, KDGantt::ItemTypeRole);
+    assertEqual(first->itemType(), KDGantt::TypeEvent);
+    assertFalse(scene->isAggregated(first, 0.5));
+
+    scene->setLevelOfDetailThreshold(0.);
+    assertFalse(scene->isAggregated(second, 0.5));
+}
 #endif /* KDAB_NO_UNIT_TESTS */
@@ -64,6 +64,7 @@ public:
     void deleteSubtree(const QModelIndex &);
 
     ConstraintGraphicsItem *findConstraintItem(const Constraint &) const;
+    bool satisfiesHardConstraints(const QModelIndex &idx, const Span &span) const;
     void clearConstraintItems();
 
     void setItemDelegate(ItemDelegate *);
@@ -77,6 +78,11 @@ public:
 
     bool isReadOnly() const;
 
+    void setLevelOfDetailThreshold(qreal pixels);
+    qreal levelOfDetailThreshold() const;
+    bool isAggregated(const GraphicsItem *item, qreal levelOfDetail) const;
+    void invalidateMergedItems();
+
     void updateRow(const QModelIndex &idx);
     GraphicsItem *createItem(ItemType type) const;
 
@@ -118,7 +124,9 @@ public Q_SLOTS:
 private Q_SLOTS:
     /* slots for ConstraintModel */
     void slotConstraintAdded(const KDGantt::Constraint &);
+    void slotConstraintsAdded(const QList<KDGantt::Constraint> &);
     void slotConstraintRemoved(const KDGantt::Constraint &);
+    void slotCreatePendingConstraintItems();
     void slotGridChanged();
 
 private:
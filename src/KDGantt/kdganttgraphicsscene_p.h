@@ -12,11 +12,17 @@
 #define KDGANTTGRAPHICSSCENE_P_H
 
 #include <QAbstractProxyModel>
+#include <QBrush>
 #include <QHash>
 #include <QItemSelectionModel>
+#include <QList>
+#include <QMap>
 #include <QPersistentModelIndex>
 #include <QPointer>
+#include <QRectF>
+#include <QVector>
 
+#include "kdganttconstraintchecker_p.h"
 #include "kdganttconstraintmodel.h"
 #include "kdganttdatetimegrid.h"
 #include "kdganttgraphicsscene.h"
@@ -29,11 +35,17 @@ public:
 
     void resetConstraintItems();
     void createConstraintItem(const Constraint &c);
+    void queueConstraintItems(const QList<Constraint> &clst);
+    bool createPendingConstraintItems(const QRectF &area = QRectF());
+    void requestConstraintItems(const QRectF &area);
+    QRectF visibleSceneRect() const;
     void deleteConstraintItem(ConstraintGraphicsItem *citem);
     void deleteConstraintItem(const Constraint &c);
     ConstraintGraphicsItem *findConstraintItem(const Constraint &c) const;
 
     void recursiveUpdateMultiItem(const Span &span, const QModelIndex &idx);
+    void updateMergedItems(qreal levelOfDetail);
+    QBrush mergedItemBrush(const GraphicsItem *item) const;
 
     GraphicsScene *q;
 
@@ -46,6 +58,17 @@ public:
     QPointer<AbstractGrid> grid;
     bool readOnly;
 
+    /* level of detail: tasks narrower than the threshold are merged per row */
+    qreal lodThreshold;
+    struct MergedItem
+    {
+        QRectF rect;
+        QBrush brush;
+    };
+    QVector<MergedItem> mergedItems;
+    qreal mergedItemsLod;
+    bool mergedItemsDirty;
+
     /* printing related members */
     bool isPrinting;
     bool drawColumnLabels;
@@ -54,6 +77,17 @@ public:
     QPointer<QAbstractProxyModel> summaryHandlingModel;
 
     QPointer<ConstraintModel> constraintModel;
+    /* constraints whose items have not been created yet, because
+     * they were not visible so far, by start index. A QMap orders
+     * persistent indexes by identity, which unlike their hash stays
+     * the same when rows are inserted or removed */
+    QMap<QPersistentModelIndex, QList<Constraint>> pendingConstraints;
+    bool pendingConstraintsScheduled;
+    QRectF pendingConstraintsArea;
+    /* the part of the scene searched for pending constraints since
+     * the items last changed, painting it again needs no new search */
+    QRectF pendingConstraintsSearched;
+    ConstraintChecker constraintChecker;
 
     QPointer<QItemSelectionModel> selectionModel;
 };
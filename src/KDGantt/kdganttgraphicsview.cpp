@@ -556,6 +556,24 @@ bool GraphicsView::isReadOnly() const
     return d->scene.isReadOnly();
 }
 
+/*! Enables the level of detail mode for zoomed out charts. Task items
+ * narrower than \a pixels are merged per row into single spans, and
+ * their labels and constraint arrows are not drawn. Pass 0 (the default)
+ * to always paint every item in full detail.
+ * \see GraphicsScene::setLevelOfDetailThreshold()
+ */
+void GraphicsView::setLevelOfDetailThreshold(qreal pixels)
+{
+    d->scene.setLevelOfDetailThreshold(pixels);
+}
+
+/*!\returns the width in pixels below which task items are merged
+ */
+qreal GraphicsView::levelOfDetailThreshold() const
+{
+    return d->scene.levelOfDetailThreshold();
+}
+
 /*! Sets the context menu policy for the header. The default value
  * Qt::DefaultContextMenu results in a standard context menu on the header
  * that allows the user to set the scale and zoom.
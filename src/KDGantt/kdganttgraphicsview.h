@@ -36,6 +36,7 @@ class KDGANTT_EXPORT GraphicsView : public QGraphicsView
     KDGANTT_DECLARE_PRIVATE_BASE_POLYMORPHIC(GraphicsView)
 
     Q_PROPERTY(bool readOnly READ isReadOnly WRITE setReadOnly)
+    Q_PROPERTY(qreal levelOfDetailThreshold READ levelOfDetailThreshold WRITE setLevelOfDetailThreshold)
 public:
     explicit GraphicsView(QWidget *parent = nullptr);
     ~GraphicsView() override;
@@ -51,6 +52,9 @@ public:
 
     bool isReadOnly() const;
 
+    void setLevelOfDetailThreshold(qreal pixels);
+    qreal levelOfDetailThreshold() const;
+
     void setHeaderContextMenuPolicy(Qt::ContextMenuPolicy);
     Qt::ContextMenuPolicy headerContextMenuPolicy() const;
 